@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CounterBasedRandom.h
+/// \brief  Counter-based random number generator for reproducible fast simulation.
+///         Every draw is a pure function of (seed, event, particle, draw index), so the
+///         smearing of a particle does not depend on the order in which particles are
+///         processed or on the thread processing them.
+///
+
+#ifndef ALICE3_CORE_COUNTERBASEDRANDOM_H_
+#define ALICE3_CORE_COUNTERBASEDRANDOM_H_
+
+#include <cmath>
+#include <cstdint>
+
+namespace o2::fastsim
+{
+
+// +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
+
+// Counter-based generator: the key identifies the particle being smeared and
+// the n-th draw is the SplitMix64 finaliser applied to (key + n * golden gamma).
+// The interface mirrors the subset of TRandom used by the fast simulation, so
+// code templated on the generator type works with both this class and gRandom.
+class CounterBasedRandom
+{
+ public:
+  CounterBasedRandom() = default;
+  CounterBasedRandom(uint64_t seed, uint64_t event, uint64_t particle) { SetKey(seed, event, particle); }
+
+  /// Select the stream of a particle and restart it from its first draw
+  void SetKey(uint64_t seed, uint64_t event, uint64_t particle)
+  {
+    mKey = mix(mix(mix(seed) ^ event) ^ particle);
+    mCounter = 0;
+  }
+  uint64_t GetCounter() const { return mCounter; }
+
+  /// Next raw 64-bit value of the stream
+  uint64_t Integer()
+  {
+    return mix(mKey + GoldenGamma * ++mCounter);
+  }
+
+  /// Uniform in ]0, 1], as TRandom::Rndm
+  double Rndm()
+  {
+    return static_cast<double>((Integer() >> 11) + 1) * 0x1.0p-53;
+  }
+  double Uniform() { return Rndm(); }
+  double Uniform(double x1, double x2) { return x1 + (x2 - x1) * Rndm(); }
+
+  /// Gaussian via the Box-Muller transform (one pair of uniforms per draw)
+  double Gaus(double mean = 0., double sigma = 1.)
+  {
+    const double radius = std::sqrt(-2. * std::log(Rndm()));
+    const double angle = TwoPi * Rndm();
+    return mean + sigma * radius * std::cos(angle);
+  }
+
+  /// Poisson: multiplication of uniforms for small means, PTRS rejection (Hoermann 1993) otherwise
+  uint64_t Poisson(double mean)
+  {
+    if (!(mean > 0.)) {
+      return 0;
+    }
+    if (mean < PtrsThreshold) {
+      const double limit = std::exp(-mean);
+      uint64_t n = 0;
+      double product = Rndm();
+      while (product > limit) {
+        n++;
+        product *= Rndm();
+      }
+      return n;
+    }
+    const double slam = std::sqrt(mean);
+    const double loglam = std::log(mean);
+    const double b = 0.931 + 2.53 * slam;
+    const double a = -0.059 + 0.02483 * b;
+    const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+    const double vr = 0.9277 - 3.6224 / (b - 2.);
+    while (true) {
+      const double u = Rndm() - 0.5;
+      const double v = Rndm();
+      const double us = 0.5 - std::fabs(u);
+      const double k = std::floor((2. * a / us + b) * u + mean + 0.43);
+      if (us >= 0.07 && v <= vr) {
+        return static_cast<uint64_t>(k);
+      }
+      if (k < 0. || (us < 0.013 && v > us)) {
+        continue;
+      }
+      if (std::log(v) + std::log(invalpha) - std::log(a / (us * us) + b) <= -mean + k * loglam - std::lgamma(k + 1.)) {
+        return static_cast<uint64_t>(k);
+      }
+    }
+  }
+
+ private:
+  static constexpr uint64_t GoldenGamma = 0x9e3779b97f4a7c15ULL;
+  static constexpr double TwoPi = 6.283185307179586476925286766559;
+  static constexpr double PtrsThreshold = 10.;
+
+  static uint64_t mix(uint64_t z)
+  {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t mKey = 0;     // hash of (seed, event, particle)
+  uint64_t mCounter = 0; // number of draws taken from the stream
+};
+
+// +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
+
+} // namespace o2::fastsim
+
+#endif // ALICE3_CORE_COUNTERBASEDRANDOM_H_
@@ -52,10 +52,34 @@ DetLayer::DetLayer(const TString& name,
 }
 
 DetLayer::DetLayer(const DetLayer& other)
-  : mName(other.mName), mR(other.mR), mZ(other.mZ), mX0(other.mX0), mXrho(other.mXrho), mResRPhi(other.mResRPhi), mResZ(other.mResZ), mEff(other.mEff), mType(other.mType)
+  : mName(other.mName), mR(other.mR), mZ(other.mZ), mX0(other.mX0), mXrho(other.mXrho), mResRPhi(other.mResRPhi), mResZ(other.mResZ), mEff(other.mEff), mDeadPhiRegions(other.mDeadPhiRegions ? new TGraph(*other.mDeadPhiRegions) : nullptr), mType(other.mType)
 {
 }
 
+DetLayer& DetLayer::operator=(const DetLayer& other)
+{
+  if (this == &other) {
+    return *this;
+  }
+  mName = other.mName;
+  mR = other.mR;
+  mZ = other.mZ;
+  mX0 = other.mX0;
+  mXrho = other.mXrho;
+  mResRPhi = other.mResRPhi;
+  mResZ = other.mResZ;
+  mEff = other.mEff;
+  delete mDeadPhiRegions;
+  mDeadPhiRegions = other.mDeadPhiRegions ? new TGraph(*other.mDeadPhiRegions) : nullptr;
+  mType = other.mType;
+  return *this;
+}
+
+DetLayer::~DetLayer()
+{
+  delete mDeadPhiRegions;
+}
+
 void DetLayer::addDeadPhiRegion(float phiStart, float phiEnd)
 {
   static constexpr float DefaultValue = 2.f;
@@ -77,19 +101,19 @@ void DetLayer::addDeadPhiRegion(float phiStart, float phiEnd)
   mDeadPhiRegions->Sort();
 }
 
-void DetLayer::setDeadPhiRegions(TGraph* graph)
+void DetLayer::setDeadPhiRegions(const TGraph* graph)
 {
   LOG(debug) << "Setting dead phi regions for layer " << mName << " with graph " << (graph ? graph->GetName() : "nullptr");
   if (mDeadPhiRegions != nullptr) {
     LOG(warning) << "Overriding existing dead phi regions for layer " << mName;
     delete mDeadPhiRegions;
+    mDeadPhiRegions = nullptr;
   }
-  mDeadPhiRegions = graph;
-  if (mDeadPhiRegions->GetN() == 0) {
+  if (graph == nullptr || graph->GetN() == 0) {
     LOG(warning) << "Dead phi regions graph for layer " << mName << " is empty, clearing dead regions";
-    mDeadPhiRegions = nullptr;
     return; // cleared the dead regions
   }
+  mDeadPhiRegions = new TGraph(*graph); // the layer owns its copy, the graph stays with the caller
   // Check sanity of the graph
   if (mDeadPhiRegions != nullptr) {
     for (int i = 0; i < mDeadPhiRegions->GetN(); i++) {
@@ -35,8 +35,10 @@ struct DetLayer {
   // Parametric constructor
   DetLayer(const TString& name, float r, float z, float x0, float xrho,
            float resRPhi = 0.0f, float resZ = 0.0f, float eff = 0.0f, int type = kLayerInert);
-  // Copy constructor
+  // Copy constructor and assignment, the dead phi regions are deep-copied
   DetLayer(const DetLayer& other);
+  DetLayer& operator=(const DetLayer& other);
+  ~DetLayer();
 
   // Setters
   void setName(const TString& name) { mName = name; }
@@ -57,8 +59,8 @@ struct DetLayer {
   void addDeadPhiRegion(float phiStart, float phiEnd);
 
   /// @brief Set the dead regions in phi for this layer with a TGraph containing all regions. The graph should have y=2 for dead regions and y=0 for alive regions.
-  /// @param graph graph of the dead regions. Can be nullptr to clear the dead regions.
-  void setDeadPhiRegions(TGraph* graph);
+  /// @param graph graph of the dead regions, copied into the layer. Can be nullptr to clear the dead regions.
+  void setDeadPhiRegions(const TGraph* graph);
 
   // Getters
   float getRadius() const { return mR; }
@@ -122,7 +124,7 @@ struct DetLayer {
   // efficiency
   float mEff; // detection efficiency
 
-  // dead regions in phi (in radians)
+  // dead regions in phi (in radians), owned by the layer
   TGraph* mDeadPhiRegions = nullptr;
 
   // layer type
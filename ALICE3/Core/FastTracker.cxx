@@ -41,6 +41,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -196,9 +197,9 @@ void FastTracker::AddGenericDetector(o2::fastsim::GeometryEntry configMap, o2::c
           LOG(fatal) << "Cannot open dead phi regions file " << deadPhiRegions;
           return;
         }
-        TGraph* g = reinterpret_cast<TGraph*>(infile.Get(infile.GetListOfKeys()->At(0)->GetName()));
+        std::unique_ptr<TGraph> g(reinterpret_cast<TGraph*>(infile.Get(infile.GetListOfKeys()->At(0)->GetName())));
         infile.Close();
-        addedLayer->setDeadPhiRegions(g);
+        addedLayer->setDeadPhiRegions(g.get());
       }
     } else {
       LOG(debug) << " No dead phi regions for layer " << layer;
@@ -543,7 +544,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     eff *= iGoodHit;
   }
   if (mApplyEffCorrection) {
-    if (gRandom->Uniform() > eff) {
+    if ((mRandom ? mRandom->Uniform() : gRandom->Uniform()) > eff) {
       return -8;
     }
   }
@@ -614,7 +615,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     for (int j = 0; j < 5; ++j)
       val += eigVec[j][ii] * outputTrack.getParam(j);
     // smear parameters according to eigenvalues
-    params_[ii] = gRandom->Gaus(val, sqrt(eigVal[ii]));
+    params_[ii] = mRandom ? mRandom->Gaus(val, sqrt(eigVal[ii])) : gRandom->Gaus(val, sqrt(eigVal[ii]));
   }
 
   // invert eigenvector matrix
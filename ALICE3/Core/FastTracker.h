@@ -12,6 +12,7 @@
 #ifndef ALICE3_CORE_FASTTRACKER_H_
 #define ALICE3_CORE_FASTTRACKER_H_
 
+#include "CounterBasedRandom.h"
 #include "DetLayer.h"
 #include "GeometryContainer.h"
 
@@ -53,7 +54,7 @@ class FastTracker
   /// \param phiStart Start angle of the dead region (in radians)
   /// \param phiEnd End angle of the dead region (in radians)
   void addDeadPhiRegionInLayer(const std::string& layerName, float phiStart, float phiEnd);
-  DetLayer GetLayer(const int layer) const { return layers[layer]; }
+  const DetLayer& GetLayer(const int layer) const { return layers[layer]; }
   std::vector<DetLayer> GetLayers() const { return layers; }
   int GetLayerIndex(const std::string& name) const;
   size_t GetNLayers() const { return layers.size(); }
@@ -118,6 +119,9 @@ class FastTracker
   void SetApplyMSCorrection(bool b) { mApplyMSCorrection = b; }
   void SetApplyElossCorrection(bool b) { mApplyElossCorrection = b; }
   void SetApplyEffCorrection(bool b) { mApplyEffCorrection = b; }
+  /// Draw the smearing from a counter-based generator instead of gRandom (nullptr: use gRandom).
+  /// The generator is not owned; keep one FastTracker per thread when smearing concurrently.
+  void SetRandomGenerator(CounterBasedRandom* random) { mRandom = random; }
 
   // Getters for the last track
   int GetNIntercepts() const { return nIntercepts; }
@@ -170,6 +174,8 @@ class FastTracker
   int nGasPoints = 0;     /// tpc-based space points added to track
   std::vector<float> goodHitProbability;
 
+  CounterBasedRandom* mRandom = nullptr; //! optional generator replacing gRandom
+
   ClassDef(FastTracker, 1);
 };
 
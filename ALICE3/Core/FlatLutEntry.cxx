@@ -14,17 +14,41 @@
 #include <Framework/Logger.h>
 #include <Framework/RuntimeError.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <ios>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <span>
+#include <utility>
 
 namespace o2::delphes
 {
 
+namespace
+{
+// entries follow the header directly, so the header size must keep them aligned
+static_assert(sizeof(lutHeader_t) % alignof(lutEntry_t) == 0, "LUT entries would be misaligned after the header");
+
+// File mappings alive in this process, by (device, inode), with the length that was mapped
+struct MappedFile {
+  std::weak_ptr<const uint8_t> mapping;
+  size_t size = 0;
+};
+std::mutex gMappedFilesMutex;
+std::map<std::pair<dev_t, ino_t>, MappedFile> gMappedFiles;
+} // namespace
+
 float map_t::fracPositionWithinBin(float val) const
 {
   float width = (max - min) / nbins;
@@ -167,6 +191,7 @@ void FlatLutData::adopt(const uint8_t* buffer, size_t size)
 void FlatLutData::view(const uint8_t* buffer, size_t size)
 {
   mData.clear();
+  mMapping.reset();
   mDataRef = std::span{buffer, size};
   cacheDimensions();
 }
@@ -266,9 +291,63 @@ FlatLutData FlatLutData::loadFromFile(std::ifstream& file, const char* filename)
   return data;
 }
 
+FlatLutData FlatLutData::mapFromFile(const char* filename)
+{
+  const int fd = ::open(filename, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw framework::runtime_error_f("Cannot open LUT file %s: %s", filename, std::strerror(errno));
+  }
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0) {
+    const int error = errno;
+    ::close(fd);
+    throw framework::runtime_error_f("Cannot stat LUT file %s: %s", filename, std::strerror(error));
+  }
+  const size_t size = static_cast<size_t>(fileStat.st_size);
+  if (size < sizeof(lutHeader_t)) {
+    ::close(fd);
+    throw framework::runtime_error_f("LUT file %s too small for header: expected at least %zu, got %zu", filename, sizeof(lutHeader_t), size);
+  }
+
+  std::shared_ptr<const uint8_t> mapping;
+  size_t mappedSize = 0;
+  {
+    std::lock_guard<std::mutex> lock(gMappedFilesMutex);
+    auto& cached = gMappedFiles[{fileStat.st_dev, fileStat.st_ino}];
+    mapping = cached.mapping.lock();
+    mappedSize = cached.size;
+    if (!mapping || mappedSize != size) { // not mapped yet, or the file changed size since it was mapped
+      void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (address == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd);
+        throw framework::runtime_error_f("Cannot map LUT file %s: %s", filename, std::strerror(error));
+      }
+      mapping = std::shared_ptr<const uint8_t>(static_cast<const uint8_t*>(address), [size](const uint8_t* buffer) {
+        ::munmap(const_cast<uint8_t*>(buffer), size);
+      });
+      mappedSize = size;
+      cached = {mapping, mappedSize};
+    }
+  }
+  ::close(fd); // the mapping stays valid without the descriptor
+
+  if (reinterpret_cast<uintptr_t>(mapping.get()) % alignof(lutEntry_t) != 0) {
+    throw framework::runtime_error_f("LUT file %s mapped at a misaligned address", filename);
+  }
+  validateBuffer(mapping.get(), mappedSize);
+
+  FlatLutData data;
+  data.view(mapping.get(), mappedSize);
+  data.mMapping = std::move(mapping);
+  LOGF(info, "Successfully mapped LUT from %s: %zu bytes", filename, mappedSize);
+  return data;
+}
+
 void FlatLutData::reset()
 {
   mData.clear();
+  mMapping.reset();
   updateRef();
   resetDimensions();
 }
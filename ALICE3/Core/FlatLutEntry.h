@@ -16,6 +16,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -155,6 +156,18 @@ class FlatLutData
    */
   static FlatLutData loadFromFile(std::ifstream& file, const char* filename);
 
+  /**
+   * @brief Construct a new FlatLutData as a read-only memory mapping of a file
+   * Pages are loaded on first access and shared with every other mapping of the
+   * same file, in this process and in the other processes of the node
+   */
+  static FlatLutData mapFromFile(const char* filename);
+
+  /**
+   * @brief Check if the data is a view of a memory-mapped file
+   */
+  bool isMapped() const { return mMapping != nullptr; }
+
   /**
    * @brief Preview buffer header for version and other compatibility checks
    */
@@ -209,6 +222,7 @@ class FlatLutData
 
   std::vector<uint8_t> mData;
   std::span<uint8_t const> mDataRef;
+  std::shared_ptr<const uint8_t> mMapping; // keeps the file mapping viewed by mDataRef alive
 
   // Cache dimensions for quick access
   int mNchBins = 0;
@@ -14,19 +14,23 @@
 #include "ALICE3/Core/FlatLutEntry.h"
 #include "ALICE3/Core/GeometryContainer.h"
 
+#include <CommonConstants/MathConstants.h>
 #include <CommonConstants/PhysicsConstants.h>
 #include <Framework/Logger.h>
 #include <Framework/RuntimeError.h>
 
 #include <TRandom.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <span>
 #include <string>
+#include <vector>
 
 namespace o2::delphes
 {
@@ -107,22 +111,33 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
   LOGF(info, "Loading %s LUT file: '%s'", getParticleName(pdg), filename);
   const std::string localFilename = o2::fastsim::GeometryEntry::accessFile(filename, "./.ALICE3/LUTs/", mCcdbManager, 10);
 
-  std::ifstream lutFile(localFilename, std::ifstream::binary);
-  if (!lutFile.is_open()) {
-    throw framework::runtime_error_f("Cannot open LUT file: %s", localFilename.c_str());
+  bool mapped = false;
+  if (mMapTables) {
+    try {
+      mLUTData[ipdg] = FlatLutData::mapFromFile(localFilename.c_str());
+      mapped = true;
+    } catch (framework::RuntimeErrorRef ref) {
+      LOGF(warning, "%s; reading the LUT file instead", framework::error_from_ref(ref).what);
+    }
   }
 
-  try {
-    mLUTData[ipdg] = FlatLutData::loadFromFile(lutFile, localFilename.c_str());
-
-    // Validate header
-    auto header = mLUTData[ipdg].getHeader();
-    if (header.pdg != pdg && !checkSpecialCase(pdg, header)) {
-      LOGF(error, "LUT header PDG mismatch: expected %d, got %d; not loading", pdg, header.pdg);
+  if (!mapped) {
+    std::ifstream lutFile(localFilename, std::ifstream::binary);
+    if (!lutFile.is_open()) {
+      throw framework::runtime_error_f("Cannot open LUT file: %s", localFilename.c_str());
+    }
+    try {
+      mLUTData[ipdg] = FlatLutData::loadFromFile(lutFile, localFilename.c_str());
+    } catch (framework::RuntimeErrorRef ref) {
+      LOGF(error, "%s", framework::error_from_ref(ref).what);
       return false;
     }
-  } catch (framework::RuntimeErrorRef ref) {
-    LOGF(error, "%s", framework::error_from_ref(ref).what);
+  }
+
+  // Validate header
+  const auto& header = mLUTData[ipdg].getHeaderRef();
+  if (header.pdg != pdg && !checkSpecialCase(pdg, header)) {
+    LOGF(error, "LUT header PDG mismatch: expected %d, got %d; not loading", pdg, header.pdg);
     return false;
   }
 
@@ -381,6 +396,156 @@ bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
   return smearTrack(o2track, lutEntry, interpolatedEff);
 }
 
+void TrackSmearer::getLUTEntries(std::span<const int> pdgs, std::span<const float> nchs, std::span<const float> radii,
+                                 std::span<const float> etas, std::span<const float> pts,
+                                 std::span<const lutEntry_t*> lutEntries, std::span<float> interpolatedEffs) const
+{
+  const size_t nTracks = pdgs.size();
+  if (nchs.size() != nTracks || radii.size() != nTracks || etas.size() != nTracks || pts.size() != nTracks || lutEntries.size() != nTracks || interpolatedEffs.size() != nTracks) {
+    throw framework::runtime_error_f("getLUTEntries: inconsistent block sizes for %zu tracks", nTracks);
+  }
+  for (size_t i = 0; i < nTracks; ++i) {
+    lutEntries[i] = getLUTEntry(pdgs[i], nchs[i], radii[i], etas[i], pts[i], interpolatedEffs[i]);
+  }
+}
+
+void TrackSmearer::smearTracks(std::span<O2Track> tracks, std::span<const int> pdgs, std::span<const float> nchs, std::span<uint8_t> isReconstructed)
+{
+  const size_t nTracks = tracks.size();
+  if (pdgs.size() != nTracks || nchs.size() != nTracks || isReconstructed.size() != nTracks) {
+    throw framework::runtime_error_f("smearTracks: inconsistent block sizes for %zu tracks", nTracks);
+  }
+
+  // First pass: kinematics and LUT entries of all tracks
+  mBlockRadii.assign(nTracks, 0.f);
+  mBlockEtas.resize(nTracks);
+  mBlockPts.resize(nTracks);
+  mBlockEffs.assign(nTracks, 0.f);
+  mBlockEntries.resize(nTracks);
+  for (size_t i = 0; i < nTracks; ++i) {
+    auto pt = tracks[i].getPt();
+    switch (pdgs[i]) {
+      case o2::constants::physics::kHelium3:
+      case -o2::constants::physics::kHelium3:
+        pt *= 2.f;
+        break;
+    }
+    mBlockPts[i] = pt;
+    mBlockEtas[i] = tracks[i].getEta();
+  }
+  getLUTEntries(pdgs, nchs, mBlockRadii, mBlockEtas, mBlockPts, mBlockEntries, mBlockEffs);
+
+  // Group the tracks with a valid entry by entry, so that each entry is read once
+  mBlockOrder.clear();
+  for (size_t i = 0; i < nTracks; ++i) {
+    isReconstructed[i] = false;
+    if (mBlockEntries[i] && mBlockEntries[i]->valid) {
+      mBlockOrder.push_back(i);
+    }
+  }
+  std::stable_sort(mBlockOrder.begin(), mBlockOrder.end(), [this](size_t a, size_t b) {
+    return std::less<const lutEntry_t*>{}(mBlockEntries[a], mBlockEntries[b]);
+  });
+
+  // Second pass: smear the groups
+  for (size_t begin = 0; begin < mBlockOrder.size();) {
+    const lutEntry_t* lutEntry = mBlockEntries[mBlockOrder[begin]];
+    size_t end = begin + 1;
+    while (end < mBlockOrder.size() && mBlockEntries[mBlockOrder[end]] == lutEntry) {
+      ++end;
+    }
+    smearEntryGroup(tracks, std::span<const size_t>(mBlockOrder).subspan(begin, end - begin), lutEntry, isReconstructed);
+    begin = end;
+  }
+}
+
+void TrackSmearer::smearEntryGroup(std::span<O2Track> tracks, std::span<const size_t> group, const lutEntry_t* lutEntry, std::span<uint8_t> isReconstructed)
+{
+  // Generate efficiency, as in smearTrack
+  const size_t nGroup = group.size();
+  mBlockUniforms.resize(nGroup);
+  if (mUseEfficiency) {
+    gRandom->RndmArray(static_cast<int>(nGroup), mBlockUniforms.data());
+  }
+  mBlockSmeared.clear();
+  for (size_t k = 0; k < nGroup; ++k) {
+    const size_t i = group[k];
+    bool reconstructed = true;
+    if (mUseEfficiency) {
+      auto eff = 0.f;
+      switch (mWhatEfficiency) {
+        case 1:
+          eff = lutEntry->eff;
+          break;
+        case 2:
+          eff = lutEntry->eff2;
+          break;
+      }
+      if (mInterpolateEfficiency) {
+        eff = mBlockEffs[i];
+      }
+      reconstructed = !(mBlockUniforms[k] > eff);
+    }
+    isReconstructed[i] = reconstructed;
+    if (reconstructed || !mSkipUnreconstructed) {
+      mBlockSmeared.push_back(i);
+    }
+  }
+
+  // Gaussian numbers for all the tracks of the group, Box-Muller on bulk uniforms
+  static constexpr int kParSize = 5;
+  const size_t nSmeared = mBlockSmeared.size();
+  const size_t nPairs = (nSmeared * kParSize + 1) / 2;
+  mBlockUniforms.resize(2 * nPairs);
+  mBlockGaussians.resize(2 * nPairs);
+  gRandom->RndmArray(static_cast<int>(2 * nPairs), mBlockUniforms.data());
+  for (size_t k = 0; k < nPairs; ++k) {
+    const double radius = std::sqrt(-2. * std::log(mBlockUniforms[2 * k]));
+    const double angle = o2::constants::math::TwoPI * mBlockUniforms[2 * k + 1];
+    mBlockGaussians[2 * k] = radius * std::cos(angle);
+    mBlockGaussians[2 * k + 1] = radius * std::sin(angle);
+  }
+
+  double sigmas[kParSize];
+  for (int i = 0; i < kParSize; ++i) {
+    sigmas[i] = std::sqrt(lutEntry->eigval[i]);
+  }
+  static constexpr int kCovMatSize = 15;
+  for (size_t k = 0; k < nSmeared; ++k) {
+    O2Track& o2track = tracks[mBlockSmeared[k]];
+    const double* gaussians = mBlockGaussians.data() + k * kParSize;
+
+    // Transform params vector and smear
+    double params[kParSize];
+    for (int i = 0; i < kParSize; ++i) {
+      double val = 0.;
+      for (int j = 0; j < kParSize; ++j) {
+        val += lutEntry->eigvec[j][i] * o2track.getParam(j);
+      }
+      params[i] = val + sigmas[i] * gaussians[i];
+    }
+
+    // Transform back params vector
+    for (int i = 0; i < kParSize; ++i) {
+      double val = 0.;
+      for (int j = 0; j < kParSize; ++j) {
+        val += lutEntry->eiginv[j][i] * params[j];
+      }
+      o2track.setParam(val, i);
+    }
+
+    // Sanity check that par[2] sin(phi) is in [-1, 1]
+    if (std::fabs(o2track.getParam(2)) > 1.) {
+      LOGF(warn, "smearTracks failed sin(phi) sanity check: %f", o2track.getParam(2));
+    }
+
+    // Set covariance matrix
+    for (int i = 0; i < kCovMatSize; ++i) {
+      o2track.setCov(lutEntry->covm[i], i);
+    }
+  }
+}
+
 double TrackSmearer::getPtRes(const int pdg, const float nch, const float eta, const float pt) const
 {
   float dummy = 0.0f;
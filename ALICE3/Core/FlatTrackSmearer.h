@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <vector>
 
 namespace o2::delphes
 {
@@ -42,6 +43,7 @@ class TrackSmearer
   void useEfficiency(bool val) { mUseEfficiency = val; }
   void interpolateEfficiency(bool val) { mInterpolateEfficiency = val; }
   void skipUnreconstructed(bool val) { mSkipUnreconstructed = val; }
+  void mapTables(bool val) { mMapTables = val; }
   void setWhatEfficiency(int val);
 
   const lutHeader_t* getLUTHeader(int pdg) const;
@@ -50,6 +52,16 @@ class TrackSmearer
   bool smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff);
   bool smearTrack(O2Track& o2track, int pdg, float nch);
 
+  /** Block methods **/
+  // Resolve the LUT entries (and efficiencies) of a block of (pdg, nch, radius, eta, pt) at once
+  void getLUTEntries(std::span<const int> pdgs, std::span<const float> nchs, std::span<const float> radii,
+                     std::span<const float> etas, std::span<const float> pts,
+                     std::span<const lutEntry_t*> lutEntries, std::span<float> interpolatedEffs) const;
+  // Smear a block of tracks, equivalent to smearTrack(tracks[i], pdgs[i], nchs[i]) for each track.
+  // Tracks sharing a LUT entry are smeared together with random numbers drawn in bulk, so the
+  // random sequence (not its distribution) differs from per-track calls
+  void smearTracks(std::span<O2Track> tracks, std::span<const int> pdgs, std::span<const float> nchs, std::span<uint8_t> isReconstructed);
+
   double getPtRes(const int pdg, const float nch, const float eta, const float pt) const;
   double getEtaRes(const int pdg, const float nch, const float eta, const float pt) const;
   double getAbsPtRes(const int pdg, const float nch, const float eta, const float pt) const;
@@ -69,12 +81,21 @@ class TrackSmearer
   bool mUseEfficiency = true;
   bool mInterpolateEfficiency = false;
   bool mSkipUnreconstructed = true; // don't smear tracks that are not reco'ed
+  bool mMapTables = true;           // memory-map LUT files instead of reading them into memory
   int mWhatEfficiency = 1;
   float mdNdEta = 1600.f;
 
  private:
   o2::ccdb::BasicCCDBManager* mCcdbManager = nullptr;
 
+  // scratch buffers of the block smearing
+  std::vector<float> mBlockRadii, mBlockEtas, mBlockPts, mBlockEffs;
+  std::vector<const lutEntry_t*> mBlockEntries;
+  std::vector<size_t> mBlockOrder, mBlockSmeared;
+  std::vector<double> mBlockUniforms, mBlockGaussians;
+
+  void smearEntryGroup(std::span<O2Track> tracks, std::span<const size_t> group, const lutEntry_t* lutEntry, std::span<uint8_t> isReconstructed);
+
   static bool checkSpecialCase(int pdg, lutHeader_t const& header);
 };
 
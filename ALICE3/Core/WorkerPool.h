@@ -0,0 +1,115 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   WorkerPool.h
+/// \brief  Fixed set of threads started once and reused for every job of the fast simulation,
+///         so that processing a collision does not pay for starting and joining threads.
+///
+
+#ifndef ALICE3_CORE_WORKERPOOL_H_
+#define ALICE3_CORE_WORKERPOOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2::fastsim
+{
+
+// +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
+
+// The calling thread is worker 0 and takes part in every job, the pool owns
+// workers 1 to size() - 1, which sleep between jobs.
+class WorkerPool
+{
+ public:
+  explicit WorkerPool(std::size_t nWorkers)
+  {
+    for (std::size_t iWorker = 1; iWorker < nWorkers; iWorker++) {
+      mThreads.emplace_back(&WorkerPool::work, this, iWorker);
+    }
+  }
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  ~WorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mWake.notify_all();
+    for (auto& thread : mThreads) {
+      thread.join();
+    }
+  }
+
+  /// Number of workers, including the calling thread
+  std::size_t size() const { return mThreads.size() + 1; }
+
+  /// Runs job(iWorker) on every worker and returns once all of them have finished
+  void run(const std::function<void(std::size_t)>& job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mJob = &job;
+      mPending = mThreads.size();
+      mGeneration++;
+    }
+    mWake.notify_all();
+    job(0);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mPending == 0; });
+    mJob = nullptr;
+  }
+
+ private:
+  void work(std::size_t iWorker)
+  {
+    uint64_t generation = 0;
+    while (true) {
+      const std::function<void(std::size_t)>* job = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWake.wait(lock, [&] { return mStop || mGeneration != generation; });
+        if (mStop) {
+          return;
+        }
+        generation = mGeneration;
+        job = mJob;
+      }
+      (*job)(iWorker);
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (--mPending == 0) {
+        mDone.notify_one();
+      }
+    }
+  }
+
+  std::vector<std::thread> mThreads;
+  std::mutex mMutex;
+  std::condition_variable mWake;                          // a job was posted or the pool is stopped
+  std::condition_variable mDone;                          // the last pool worker finished the job
+  const std::function<void(std::size_t)>* mJob = nullptr; // job being run
+  std::size_t mPending = 0;                               // pool workers still running the job
+  uint64_t mGeneration = 0;                               // number of jobs posted
+  bool mStop = false;
+};
+
+// +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
+
+} // namespace o2::fastsim
+
+#endif // ALICE3_CORE_WORKERPOOL_H_
@@ -0,0 +1,167 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkFlatLutMapping.cxx
+/// \brief  exec comparing the loading of a flat LUT file into memory with its memory mapping.
+///         A synthetic LUT is written, then opened with FlatLutData::loadFromFile and FlatLutData::mapFromFile.
+///         The time to open, the time and page faults of a first (lazy-page-fault) and second touch of a
+///         fraction of the entries, and the resident memory are reported, and the entries are compared.
+///         Usage: o2-bench-flat-lut-mapping [eta bins] [pt bins] [fraction of entries touched] [file]
+///
+
+#include "ALICE3/Core/FlatLutEntry.h"
+
+#include <Framework/Logger.h>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace o2::delphes;
+
+namespace
+{
+/// Minor and major page faults of the process so far
+long pageFaults()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt + usage.ru_majflt;
+}
+
+/// Resident set size of the process, in MB
+double residentMB()
+{
+  long pages = 0, resident = 0;
+  if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+    if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2) {
+      resident = 0;
+    }
+    std::fclose(statm);
+  }
+  return static_cast<double>(resident) * sysconf(_SC_PAGESIZE) / (1024. * 1024.);
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Writes a LUT with nEta x nPt entries filled with values derived from the bin indices
+void writeLut(const std::string& filename, const int nEta, const int nPt)
+{
+  lutHeader_t header;
+  header.pdg = 211;
+  header.mass = 0.13957f;
+  header.field = 0.5f;
+  header.etamap = {nEta, -4.f, 4.f, false};
+  header.ptmap = {nPt, -2.f, 2.f, true};
+  std::ofstream file(filename, std::ofstream::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  lutEntry_t entry;
+  for (int iEta = 0; iEta < nEta; iEta++) {
+    for (int iPt = 0; iPt < nPt; iPt++) {
+      entry.eta = header.etamap.eval(iEta);
+      entry.pt = header.ptmap.eval(iPt);
+      entry.valid = true;
+      entry.eff = 1.f / (1 + iPt);
+      for (int i = 0; i < 15; i++) {
+        entry.covm[i] = iEta * 1.e-3f + iPt * 1.e-6f + i;
+      }
+      file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+  }
+}
+
+/// Reads a few fields of the given entries and returns their sum, so that the reads are not optimised away
+double touch(const FlatLutData& lut, const std::vector<std::pair<int, int>>& bins)
+{
+  double sum = 0.;
+  for (const auto& [iEta, iPt] : bins) {
+    const lutEntry_t* entry = lut.getEntryRef(0, 0, iEta, iPt);
+    sum += entry->eff + entry->covm[0] + entry->covm[14];
+  }
+  return sum;
+}
+
+/// Opens the LUT with one of the two loaders, times the first and the second touch of the entries and returns the sum read
+template <typename TOpen>
+double process(const char* name, TOpen&& open, const std::vector<std::pair<int, int>>& bins, FlatLutData& lut)
+{
+  const double rssBefore = residentMB();
+  auto start = std::chrono::steady_clock::now();
+  lut = open();
+  const double timeOpen = elapsedMs(start);
+  const double rssOpen = residentMB();
+
+  long faults = pageFaults();
+  start = std::chrono::steady_clock::now();
+  const double sum = touch(lut, bins);
+  const double timeFirst = elapsedMs(start);
+  const long faultsFirst = pageFaults() - faults;
+
+  faults = pageFaults();
+  start = std::chrono::steady_clock::now();
+  touch(lut, bins);
+  const double timeSecond = elapsedMs(start);
+  const long faultsSecond = pageFaults() - faults;
+
+  LOGF(info, "%s: open %.2f ms (+%.1f MB resident), first touch of %zu entries %.2f ms with %ld page faults, second touch %.2f ms with %ld page faults, +%.1f MB resident in total",
+       name, timeOpen, rssOpen - rssBefore, bins.size(), timeFirst, faultsFirst, timeSecond, faultsSecond, residentMB() - rssBefore);
+  return sum;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  const int nEta = argc > 1 ? std::atoi(argv[1]) : 200;
+  const int nPt = argc > 2 ? std::atoi(argv[2]) : 1000;
+  const double fraction = argc > 3 ? std::atof(argv[3]) : 0.01;
+  const std::string filename = argc > 4 ? argv[4] : "/tmp/benchmarkFlatLutMapping.bin";
+
+  writeLut(filename, nEta, nPt);
+  LOGF(info, "Wrote a LUT of %d x %d entries (%.1f MB) to %s", nEta, nPt, (sizeof(lutHeader_t) + sizeof(lutEntry_t) * nEta * nPt) / (1024. * 1024.), filename.c_str());
+
+  // the same random entries for both loaders, as the smearing of tracks spread over the acceptance would read them
+  std::mt19937 generator(1234);
+  std::uniform_int_distribution<int> etaBin(0, nEta - 1), ptBin(0, nPt - 1);
+  std::vector<std::pair<int, int>> bins(static_cast<std::size_t>(fraction * nEta * nPt) + 1);
+  for (auto& bin : bins) {
+    bin = {etaBin(generator), ptBin(generator)};
+  }
+
+  FlatLutData loaded, mapped, mappedAgain;
+  const double sumLoaded = process("loadFromFile", [&]() { std::ifstream file(filename, std::ifstream::binary); return FlatLutData::loadFromFile(file, filename.c_str()); }, bins, loaded);
+  const double sumMapped = process("mapFromFile", [&]() { return FlatLutData::mapFromFile(filename.c_str()); }, bins, mapped);
+  const double sumMappedAgain = process("mapFromFile (shared mapping)", [&]() { return FlatLutData::mapFromFile(filename.c_str()); }, bins, mappedAgain);
+
+  std::remove(filename.c_str());
+  // the const accessors give the viewed buffer, owned or mapped
+  const uint8_t* bufferLoaded = std::as_const(loaded).data();
+  const uint8_t* bufferMapped = std::as_const(mapped).data();
+  if (loaded.bytes() != mapped.bytes() || std::memcmp(bufferLoaded, bufferMapped, loaded.bytes()) != 0 || bufferMapped != std::as_const(mappedAgain).data() || sumLoaded != sumMapped || sumMapped != sumMappedAgain) {
+    LOG(fatal) << "The mapped LUT differs from the loaded one";
+  }
+  LOG(info) << "The mapped LUT agrees with the loaded one";
+  return 0;
+} // main
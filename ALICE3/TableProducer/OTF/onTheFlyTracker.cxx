@@ -23,12 +23,14 @@
 /// \author Roberto Preghenella preghenella@bo.infn.it
 ///
 
+#include "ALICE3/Core/CounterBasedRandom.h"
 #include "ALICE3/Core/DetLayer.h"
 #include "ALICE3/Core/FastTracker.h"
 #include "ALICE3/Core/FlatTrackSmearer.h"
 #include "ALICE3/Core/GeometryContainer.h"
 #include "ALICE3/Core/OTFParticle.h"
 #include "ALICE3/Core/TrackUtilities.h"
+#include "ALICE3/Core/WorkerPool.h"
 #include "ALICE3/DataModel/OTFCollision.h"
 #include "ALICE3/DataModel/OTFStrangeness.h"
 #include "ALICE3/DataModel/collisionAlice3.h"
@@ -55,6 +57,7 @@
 #include <Framework/AnalysisTask.h>
 #include <Framework/Configurable.h>
 #include <Framework/DataTypes.h>
+#include <Framework/DeviceSpec.h>
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
 #include <Framework/InitContext.h>
@@ -90,12 +93,15 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <map>
 #include <memory>
+#include <random>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -161,6 +167,7 @@ struct OnTheFlyTracker {
   Configurable<bool> enablePrimaryVertexing{"enablePrimaryVertexing", true, "Enable primary vertexing"};
   Configurable<std::string> primaryVertexOption{"primaryVertexOption", "pvertexer.maxChi2TZDebris=10;pvertexer.acceptableScale2=9;pvertexer.minScale2=2;pvertexer.timeMarginVertexTime=1.3;;pvertexer.maxChi2TZDebris=40;pvertexer.maxChi2Mean=12;pvertexer.maxMultRatDebris=1.;pvertexer.addTimeSigma2Debris=1e-2;pvertexer.meanVertexExtraErrSelection=0.03;", "Option for the primary vertexer"};
   Configurable<bool> interpolateLutEfficiencyVsNch{"interpolateLutEfficiencyVsNch", true, "interpolate LUT efficiency as f(Nch)"};
+  Configurable<bool> smearLutPrimariesInBlocks{"smearLutPrimariesInBlocks", false, "smear the primaries of an event with the LUTs as one block, grouped by LUT entry (different random sequence)"};
 
   Configurable<bool> populateTracksDCA{"populateTracksDCA", true, "populate TracksDCA table"};
   Configurable<bool> populateTracksDCACov{"populateTracksDCACov", false, "populate TracksDCACov table"};
@@ -258,6 +265,12 @@ struct OnTheFlyTracker {
     Configurable<float> radiationStrength{"radiationStrength", 1e-6f, "Strenght of the bremsstrahlung radiation"};
   } brSettings;
 
+  struct : ConfigurableGroup {
+    std::string prefix = "parallelSettings"; // smearing of primaries with the FastTracker
+    Configurable<bool> useCounterBasedRandom{"useCounterBasedRandom", false, "draw the primary smearing from per-particle random streams keyed on (seed, event, particle) instead of gRandom"};
+    Configurable<int> nThreads{"nThreads", 1, "number of threads smearing the primaries with the FastTracker (> 1 implies useCounterBasedRandom)"};
+  } parallelSettings;
+
   using PVertex = o2::dataformats::PrimaryVertex;
 
   // for secondary vertex finding
@@ -265,6 +278,14 @@ struct OnTheFlyTracker {
 
   // FastTracker machinery
   std::vector<std::unique_ptr<o2::fastsim::FastTracker>> fastTracker;
+  std::vector<std::vector<std::unique_ptr<o2::fastsim::FastTracker>>> fastTrackerWorkers; // per configuration, one copy per thread
+  bool mUseCounterBasedRandom = false;
+  std::unique_ptr<o2::fastsim::WorkerPool> mWorkerPool; // threads smearing the primaries, worker i uses fastTrackerWorkers[icfg][i]
+  uint64_t mCounterBasedSeed = 0;  // seed of the counter-based streams, drawn at init if seed is 0
+  uint64_t mEventKey = 0;          // key of the current MC collision, unique in the job
+  uint64_t mEventCounter = 0;      // MC collisions processed by this device
+  uint64_t mPipelineIndex = 0;     // index of this device among the pipelined copies of the task
+  uint64_t mNumberOfPipelines = 1; // number of pipelined copies of the task
 
   // V0 names for filling histograms
   static constexpr int NtypesV0 = 3;
@@ -392,6 +413,22 @@ struct OnTheFlyTracker {
   std::vector<TrackAlice3> tracksAlice3;
   std::vector<TrackAlice3> ghostTracksAlice3;
   std::vector<o2::InteractionRecord> bcData;
+
+  // Primary particle selected in processWithLUTs, filled by the smearing step
+  struct PrimaryCandidate {
+    int64_t mcParticleRow = -1;                // row of the particle in the McParticles table
+    o2::track::TrackParCov perfectTrackParCov; // input of the smearing
+    o2::track::TrackParCov trackParCov;        // smeared track
+    bool reconstructed = true;
+    int nTrkHits = 0;
+    float trackTime = 0.f; // in us, only drawn for tracks that are kept
+  };
+  std::vector<PrimaryCandidate> primaryCandidates;
+  std::vector<o2::track::TrackParCov> blockTracks; // for the block LUT smearing
+  std::vector<int> blockPdgs;
+  std::vector<float> blockNchs;
+  std::vector<uint8_t> blockReconstructed;
+
   o2::steer::InteractionSampler irSampler;
   o2::vertexing::PVertexer vertexer;
   std::vector<cascadecandidate> cascadesAlice3;
@@ -422,6 +459,28 @@ struct OnTheFlyTracker {
 
     const int nGeometries = mGeoContainer.getNumberOfConfigurations();
     mMagneticField = mGeoContainer.getFloatValue(0, "global", "magneticfield");
+
+    mUseCounterBasedRandom = parallelSettings.useCounterBasedRandom || parallelSettings.nThreads > 1;
+    if (mUseCounterBasedRandom && !(enablePrimarySmearing && enableSecondarySmearing && (fastPrimaryTrackerSettings.fastTrackPrimaries || fastPrimaryTrackerSettings.fastTrackShortLivedParticles))) {
+      LOG(warning) << "Counter-based random numbers and threads are only used when the primaries are smeared with the FastTracker, falling back to gRandom";
+      mUseCounterBasedRandom = false;
+    }
+    if (mUseCounterBasedRandom && brSettings.doBRQA) {
+      LOG(warning) << "Bremsstrahlung QA histograms cannot be filled concurrently, falling back to gRandom";
+      mUseCounterBasedRandom = false;
+    }
+    if (mUseCounterBasedRandom) {
+      // As gRandom->SetSeed(0), a seed of 0 gives different random numbers in every job
+      mCounterBasedSeed = seed.value != 0 ? static_cast<uint64_t>(seed.value) : (static_cast<uint64_t>(std::random_device{}()) << 32) ^ static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+      // The collisions are keyed on a running counter, interleaved between the pipelined copies of the task
+      const auto& deviceSpec = initContext.services().get<DeviceSpec const>();
+      mPipelineIndex = deviceSpec.inputTimesliceId;
+      mNumberOfPipelines = std::max<std::size_t>(1, deviceSpec.maxInputTimeslices);
+      LOG(info) << "Smearing primaries with counter-based random numbers on " << std::max(1, parallelSettings.nThreads.value) << " thread(s), seed " << mCounterBasedSeed;
+      if (parallelSettings.nThreads > 1) {
+        mWorkerPool = std::make_unique<o2::fastsim::WorkerPool>(parallelSettings.nThreads.value);
+      }
+    }
     for (int icfg = 0; icfg < nGeometries; ++icfg) {
       const std::string histPath = "Configuration_" + std::to_string(icfg) + "/";
       mSmearer.emplace_back(std::make_unique<o2::delphes::TrackSmearer>());
@@ -520,6 +579,10 @@ struct OnTheFlyTracker {
         fastTracker[icfg]->SetApplyElossCorrection(fastTrackerSettings.applyElossCorrection);
         fastTracker[icfg]->AddGenericDetector(mGeoContainer.getEntry(icfg), ccdb.operator->());
         fastTracker[icfg]->Print(); // print fastTracker settings
+        fastTrackerWorkers.emplace_back();
+        for (int iThread = 0; mUseCounterBasedRandom && iThread < std::max(1, parallelSettings.nThreads.value); iThread++) {
+          fastTrackerWorkers[icfg].emplace_back(std::make_unique<o2::fastsim::FastTracker>(*fastTracker[icfg]));
+        }
 
         if (cascadeDecaySettings.doXiQA) {
           insertHist(histPath + "hXiBuilding", "hXiBuilding", {kTH1F, {{10, -0.5f, 9.5f}}});
@@ -1194,8 +1257,8 @@ struct OnTheFlyTracker {
           if (cascadeDecaySettings.trackXi) {
             // optionally, add the points in the layers before the decay of the Xi
             // will back-track the perfect MC cascade to relevant layers, find hit, smear and add to smeared cascade
-            for (int i = fastTracker[icfg]->GetLayers().size() - 1; i >= 0; --i) {
-              o2::fastsim::DetLayer layer = fastTracker[icfg]->GetLayer(i);
+            for (int i = fastTracker[icfg]->GetNLayers() - 1; i >= 0; --i) {
+              const o2::fastsim::DetLayer& layer = fastTracker[icfg]->GetLayer(i);
               if (layer.isInert()) {
                 continue; // Not an active tracking layer
               }
@@ -1797,7 +1860,9 @@ struct OnTheFlyTracker {
   /// \param icfg index of the current configuration
   /// \param mcParticle true MC particle to identify particle and get the energy
   /// \param trackParCov track of the particle to compute bremsstrahlung for
-  void computeBremsstrahlungLoss(const int icfg, const auto& mcParticle, o2::track::TrackParCov& trackParCov)
+  /// \param random generator to draw from (gRandom or a counter-based stream)
+  template <typename TRandomGenerator>
+  void computeBremsstrahlungLoss(const int icfg, const auto& mcParticle, o2::track::TrackParCov& trackParCov, TRandomGenerator& random)
   {
     if (brSettings.radiateBR) {
       const o2::fastsim::GeometryEntry geoEntry = mGeoContainer.getEntry(icfg);
@@ -1830,12 +1895,12 @@ struct OnTheFlyTracker {
         }
 
         float lambda = brSettings.radiationStrength * mcParticle.e() * geoEntry.getFloatValue(layerName, "x0") / (mass * mass);
-        ULong64_t nPhotons = gRandom->Poisson(lambda);
+        ULong64_t nPhotons = random.Poisson(lambda);
 
         double initialMomentum = trackParCov.getP();
 
         for (ULong64_t photon = 0; photon < nPhotons; ++photon) {
-          float radiativeLoss = 1.0f - brSettings.minBREnergyFraction * std::pow(brSettings.maxBREnergyFraction / brSettings.minBREnergyFraction, gRandom->Rndm());
+          float radiativeLoss = 1.0f - brSettings.minBREnergyFraction * std::pow(brSettings.maxBREnergyFraction / brSettings.minBREnergyFraction, random.Rndm());
           trackParCov.setQ2Pt(trackParCov.getQ2Pt() / radiativeLoss);
         }
 
@@ -1854,6 +1919,114 @@ struct OnTheFlyTracker {
     }
   }
 
+  /// Function to smear one selected primary particle
+  /// \param icfg index of the current configuration
+  /// \param mcParticle true MC particle of the candidate
+  /// \param primary candidate holding the perfect track, filled with the smearing results
+  /// \param tracker FastTracker to use (needed only when tracking the primaries with the FastTracker)
+  /// \param random generator to draw from (gRandom or a counter-based stream)
+  template <typename TRandomGenerator>
+  void smearPrimary(const int icfg, const auto& mcParticle, PrimaryCandidate& primary, const float dNdEta, const float eventCollisionTimeNS, o2::fastsim::FastTracker* tracker, TRandomGenerator& random)
+  {
+    if (enablePrimarySmearing) {
+      if (fastPrimaryTrackerSettings.fastTrackPrimaries || fastPrimaryTrackerSettings.fastTrackShortLivedParticles) {
+        o2::track::TrackParCov perfectTrackParCov = primary.perfectTrackParCov;
+        perfectTrackParCov.setPID(pdgCodeToPID(mcParticle.pdgCode()));
+        computeBremsstrahlungLoss(icfg, mcParticle, perfectTrackParCov, random);
+        primary.nTrkHits = tracker->FastTrack(perfectTrackParCov, primary.trackParCov, dNdEta);
+        if (primary.nTrkHits < fastPrimaryTrackerSettings.minSiliconHits) {
+          primary.reconstructed = false;
+        }
+      } else {
+        primary.trackParCov = primary.perfectTrackParCov;
+        computeBremsstrahlungLoss(icfg, mcParticle, primary.trackParCov, random);
+        primary.reconstructed = mSmearer[icfg]->smearTrack(primary.trackParCov, mcParticle.pdgCode(), dNdEta);
+        primary.nTrkHits = fastTrackerSettings.minSiliconHits;
+      }
+    }
+    drawPrimaryTime(primary, eventCollisionTimeNS, random);
+  }
+
+  /// Function to draw the time of a smeared primary, if it is kept
+  template <typename TRandomGenerator>
+  void drawPrimaryTime(PrimaryCandidate& primary, const float eventCollisionTimeNS, TRandomGenerator& random)
+  {
+    if (enablePrimarySmearing && !primary.reconstructed && !processUnreconstructedTracks) {
+      return;
+    }
+    if (TMath::IsNaN(primary.trackParCov.getZ())) {
+      return;
+    }
+    // Time associated to the mcParticle: collision time + smearing
+    primary.trackTime = (eventCollisionTimeNS + random.Gaus(0., timeResolutionNs)) * nsToMus;
+  }
+
+  /// Function to smear all selected primaries of the event with the LUTs in one block
+  void smearPrimariesWithLutBlock(aod::McParticles const& mcParticles, const int icfg, const float dNdEta, const float eventCollisionTimeNS)
+  {
+    blockTracks.clear();
+    blockPdgs.clear();
+    for (auto& primary : primaryCandidates) {
+      auto mcParticle = mcParticles.rawIteratorAt(primary.mcParticleRow);
+      primary.trackParCov = primary.perfectTrackParCov;
+      computeBremsstrahlungLoss(icfg, mcParticle, primary.trackParCov, *gRandom);
+      blockTracks.push_back(primary.trackParCov);
+      blockPdgs.push_back(mcParticle.pdgCode());
+    }
+    blockNchs.assign(blockTracks.size(), dNdEta);
+    blockReconstructed.resize(blockTracks.size());
+    mSmearer[icfg]->smearTracks(blockTracks, blockPdgs, blockNchs, blockReconstructed);
+
+    for (size_t i = 0; i < primaryCandidates.size(); i++) {
+      PrimaryCandidate& primary = primaryCandidates[i];
+      primary.trackParCov = blockTracks[i];
+      primary.reconstructed = blockReconstructed[i];
+      primary.nTrkHits = fastTrackerSettings.minSiliconHits;
+      drawPrimaryTime(primary, eventCollisionTimeNS, *gRandom);
+    }
+  }
+
+  /// Function to smear the primaries selected in the current event.
+  /// With counter-based random numbers every particle draws from its own stream keyed on
+  /// (seed, event, particle in the event), so the result does not depend on the number of threads
+  void smearPrimaries(aod::McParticles const& mcParticles, const int icfg, const float dNdEta, const float eventCollisionTimeNS)
+  {
+    const bool lutPrimaries = enablePrimarySmearing && !(fastPrimaryTrackerSettings.fastTrackPrimaries || fastPrimaryTrackerSettings.fastTrackShortLivedParticles);
+    if (lutPrimaries && smearLutPrimariesInBlocks) {
+      smearPrimariesWithLutBlock(mcParticles, icfg, dNdEta, eventCollisionTimeNS);
+      return;
+    }
+    if (!mUseCounterBasedRandom) {
+      for (auto& primary : primaryCandidates) {
+        smearPrimary(icfg, mcParticles.rawIteratorAt(primary.mcParticleRow), primary, dNdEta, eventCollisionTimeNS, fastTracker.empty() ? nullptr : fastTracker[icfg].get(), *gRandom);
+      }
+      return;
+    }
+
+    const std::size_t nCandidates = primaryCandidates.size();
+    const auto& workers = fastTrackerWorkers[icfg];
+    std::atomic<std::size_t> nextCandidate{0};
+    auto smearCandidates = [&](std::size_t iWorker) {
+      o2::fastsim::FastTracker* tracker = workers[iWorker].get();
+      o2::fastsim::CounterBasedRandom random;
+      tracker->SetRandomGenerator(&random);
+      for (std::size_t i = nextCandidate++; i < nCandidates; i = nextCandidate++) {
+        PrimaryCandidate& primary = primaryCandidates[i];
+        auto mcParticle = mcParticles.rawIteratorAt(primary.mcParticleRow);
+        random.SetKey(mCounterBasedSeed, mEventKey, primary.mcParticleRow);
+        smearPrimary(icfg, mcParticle, primary, dNdEta, eventCollisionTimeNS, tracker, random);
+      }
+      tracker->SetRandomGenerator(nullptr);
+    };
+
+    // The threads of the pool are started once at init, a single candidate is not worth waking them
+    if (!mWorkerPool || nCandidates < 2) {
+      smearCandidates(0);
+      return;
+    }
+    mWorkerPool->run(smearCandidates);
+  }
+
   void processWithLUTs(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles, const int icfg)
   {
     const std::string histPath = "Configuration_" + std::to_string(icfg) + "/";
@@ -1863,6 +2036,7 @@ struct OnTheFlyTracker {
     bcData.clear();
     recoPrimaries.clear();
     ghostPrimaries.clear();
+    primaryCandidates.clear();
 
     // *+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*+~+*
     // Study collision and perform vertexing
@@ -1905,30 +2079,25 @@ struct OnTheFlyTracker {
       }
 
       multiplicityCounter++;
-      o2::track::TrackParCov trackParCov;
-      const bool isDecayDaughter = (mcParticle.getProcess() == TMCProcess::kPDecay);
+      PrimaryCandidate& primary = primaryCandidates.emplace_back();
+      primary.mcParticleRow = mcParticle.globalIndex() - mcParticles.offset();
       if (doExtraQA) {
-        histos.fill(HIST("hSimTrackX"), trackParCov.getX());
+        histos.fill(HIST("hSimTrackX"), primary.trackParCov.getX());
+      }
+      if (enablePrimarySmearing) {
+        o2::upgrade::convertMCParticleToO2Track(mcParticle, primary.perfectTrackParCov, pdgDB);
       }
+    }
 
-      bool reconstructed = true;
-      int nTrkHits = 0;
+    // Smear the selected particles, then bookkeep them in the order they were selected
+    smearPrimaries(mcParticles, icfg, dNdEta, eventCollisionTimeNS);
+    for (const auto& primary : primaryCandidates) {
+      auto mcParticle = mcParticles.rawIteratorAt(primary.mcParticleRow);
+      const o2::track::TrackParCov& trackParCov = primary.trackParCov;
+      const bool isDecayDaughter = (mcParticle.getProcess() == TMCProcess::kPDecay);
+      const bool reconstructed = primary.reconstructed;
+      const int nTrkHits = primary.nTrkHits;
       if (enablePrimarySmearing) {
-        if (fastPrimaryTrackerSettings.fastTrackPrimaries || fastPrimaryTrackerSettings.fastTrackShortLivedParticles) {
-          o2::track::TrackParCov perfectTrackParCov;
-          o2::upgrade::convertMCParticleToO2Track(mcParticle, perfectTrackParCov, pdgDB);
-          perfectTrackParCov.setPID(pdgCodeToPID(mcParticle.pdgCode()));
-          computeBremsstrahlungLoss(icfg, mcParticle, perfectTrackParCov);
-          nTrkHits = fastTracker[icfg]->FastTrack(perfectTrackParCov, trackParCov, dNdEta);
-          if (nTrkHits < fastPrimaryTrackerSettings.minSiliconHits) {
-            reconstructed = false;
-          }
-        } else {
-          o2::upgrade::convertMCParticleToO2Track(mcParticle, trackParCov, pdgDB);
-          computeBremsstrahlungLoss(icfg, mcParticle, trackParCov);
-          reconstructed = mSmearer[icfg]->smearTrack(trackParCov, mcParticle.pdgCode(), dNdEta);
-          nTrkHits = fastTrackerSettings.minSiliconHits;
-        }
         getHist(TH1, histPath + "hPtGenerated")->Fill(mcParticle.pt());
         getHist(TH1, histPath + "hPhiGenerated")->Fill(mcParticle.phi());
         if (std::abs(mcParticle.pdgCode()) == kElectron)
@@ -1966,13 +2135,11 @@ struct OnTheFlyTracker {
       }
       histos.fill(HIST("hNaNBookkeeping"), 0.0f, 1.0f); // ok!
 
-      // Time associated to the mcParticle: collision time + smearing
-      float trackTime = (eventCollisionTimeNS + gRandom->Gaus(0., timeResolutionNs)) * nsToMus;
       TrackType trackType = reconstructed ? TrackType::kRecoPrimary : TrackType::kGhostPrimary;
       if (reconstructed) {
-        recoPrimaries.push_back(TrackAlice3{trackParCov, mcParticle.globalIndex(), trackTime, timeResolutionUs, isDecayDaughter, false, 0, nTrkHits, trackType});
+        recoPrimaries.push_back(TrackAlice3{trackParCov, mcParticle.globalIndex(), primary.trackTime, timeResolutionUs, isDecayDaughter, false, 0, nTrkHits, trackType});
       } else {
-        ghostPrimaries.push_back(TrackAlice3{trackParCov, mcParticle.globalIndex(), trackTime, timeResolutionUs, isDecayDaughter, false, 0, nTrkHits, trackType});
+        ghostPrimaries.push_back(TrackAlice3{trackParCov, mcParticle.globalIndex(), primary.trackTime, timeResolutionUs, isDecayDaughter, false, 0, nTrkHits, trackType});
       }
     }
 
@@ -2022,8 +2189,14 @@ struct OnTheFlyTracker {
 
     // do bookkeeping of fastTracker tracking
     if (enableSecondarySmearing) {
-      histos.fill(HIST("hCovMatOK"), 0.0f, fastTracker[icfg]->GetCovMatNotOK());
-      histos.fill(HIST("hCovMatOK"), 1.0f, fastTracker[icfg]->GetCovMatOK());
+      uint64_t covMatNotOK = fastTracker[icfg]->GetCovMatNotOK();
+      uint64_t covMatOK = fastTracker[icfg]->GetCovMatOK();
+      for (const auto& worker : fastTrackerWorkers[icfg]) {
+        covMatNotOK += worker->GetCovMatNotOK();
+        covMatOK += worker->GetCovMatOK();
+      }
+      histos.fill(HIST("hCovMatOK"), 0.0f, covMatNotOK);
+      histos.fill(HIST("hCovMatOK"), 1.0f, covMatOK);
     }
     if (doExtraQA) {
       histos.fill(HIST("hRecoVsSimMultiplicity"), multiplicityCounter, recoPrimaries.size());
@@ -2036,6 +2209,8 @@ struct OnTheFlyTracker {
 
   void processOnTheFly(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles)
   {
+    // The global index restarts in every data frame, the key of the collision must not
+    mEventKey = mEventCounter++ * mNumberOfPipelines + mPipelineIndex;
     for (size_t icfg = 0; icfg < mSmearer.size(); ++icfg) {
       LOG(debug) << "  -> Processing OTF tracking with LUT configuration ID " << icfg;
       processWithLUTs(mcCollision, mcParticles, static_cast<int>(icfg));
@@ -2115,13 +2290,13 @@ struct OnTheFlyTracker {
       const bool isSecondary = !otfParticle.isPrimary() && otfParticle.checkBit(o2::upgrade::DecayerBits::ProducedByDecayer) && otfParticle.isAlive();
       if (enablePrimarySmearing && longLivedToBeHandled && otfParticle.isPrimary()) {
         o2::upgrade::convertMCParticleToO2Track(mcParticle, trackParCov, pdgDB);
-        computeBremsstrahlungLoss(icfg, mcParticle, trackParCov);
+        computeBremsstrahlungLoss(icfg, mcParticle, trackParCov, *gRandom);
         reconstructed = mSmearer[icfg]->smearTrack(trackParCov, mcParticle.pdgCode(), dNdEta);
       } else if (shortLivedToBeHandled && fastPrimaryTrackerSettings.fastTrackShortLivedParticles) {
         o2::track::TrackParCov perfectTrackParCov;
         o2::upgrade::convertMCParticleToO2Track(mcParticle, perfectTrackParCov, pdgDB);
         perfectTrackParCov.setPID(pdgCodeToPID(mcParticle.pdgCode()));
-        computeBremsstrahlungLoss(icfg, mcParticle, perfectTrackParCov);
+        computeBremsstrahlungLoss(icfg, mcParticle, perfectTrackParCov, *gRandom);
         nTrkHits = fastTracker[icfg]->FastTrack(perfectTrackParCov, trackParCov, dNdEta);
         if (nTrkHits < fastPrimaryTrackerSettings.minSiliconHits) {
           reconstructed = false;
@@ -2131,7 +2306,7 @@ struct OnTheFlyTracker {
       } else if (enableSecondarySmearing && isSecondary) {
         o2::track::TrackParCov perfectTrackParCov;
         o2::upgrade::convertMCParticleToO2Track(mcParticle, perfectTrackParCov, pdgDB);
-        computeBremsstrahlungLoss(icfg, mcParticle, perfectTrackParCov);
+        computeBremsstrahlungLoss(icfg, mcParticle, perfectTrackParCov, *gRandom);
         perfectTrackParCov.setPID(pdgCodeToPID(mcParticle.pdgCode()));
         nTrkHits = fastTracker[icfg]->FastTrack(perfectTrackParCov, trackParCov, dNdEta);
         if (nTrkHits < fastTrackerSettings.minSiliconHits) {
@@ -0,0 +1,162 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file McDecayIndex.h
+/// \brief Flat per-dataframe index of the MC decay trees for the MC matching in RecoDecay
+
+#ifndef COMMON_CORE_MCDECAYINDEX_H_
+#define COMMON_CORE_MCDECAYINDEX_H_
+
+#include <algorithm>     // std::find, std::sort, std::unique
+#include <array>         // std::array
+#include <cstddef>       // std::size_t
+#include <cstdint>       // intX_t
+#include <cstdlib>       // std::abs
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::pair
+#include <vector>        // std::vector
+
+/// Flat copy of the MC particle columns used when walking decay trees
+///
+/// Built once per dataframe from the McParticles table, it stores per particle the PDG code,
+/// the production process, the generator status code and the ranges of mother and daughter
+/// indices, so that the mother and daughter searches of RecoDecay run on contiguous arrays
+/// instead of table iterators. It also memoises the lists of final-state daughters found
+/// by RecoDecay::getDaughters, keyed by the particle, the (order-independent) set of PDG codes
+/// considered final, the maximum depth and the process check, since the same mother is queried
+/// by many candidates and decay hypotheses.
+/// The index is not thread-safe: the mother search uses internal scratch buffers and
+/// the daughter search fills the memo.
+class McDecayIndex
+{
+ public:
+  /// Fills the index from a table of MC particles.
+  /// \param particlesMC  table with MC particles
+  template <typename T>
+  void build(const T& particlesMC)
+  {
+    clear();
+    const auto nParticles = particlesMC.size();
+    mOffset = particlesMC.offset();
+    mPdgCode.reserve(nParticles);
+    mProcess.reserve(nParticles);
+    mGenStatusCode.reserve(nParticles);
+    mHasMothers.reserve(nParticles);
+    mMothersRange.reserve(nParticles);
+    mHasDaughters.reserve(nParticles);
+    mDaughtersRange.reserve(nParticles);
+    for (const auto& particle : particlesMC) {
+      mPdgCode.push_back(particle.pdgCode());
+      mProcess.push_back(particle.getProcess());
+      mGenStatusCode.push_back(particle.getGenStatusCode());
+      const bool hasMothers = particle.has_mothers();
+      mHasMothers.push_back(hasMothers);
+      mMothersRange.emplace_back(hasMothers ? particle.mothersIds().front() : -1, hasMothers ? particle.mothersIds().back() : -1);
+      const bool hasDaughters = particle.has_daughters();
+      mHasDaughters.push_back(hasDaughters);
+      mDaughtersRange.emplace_back(hasDaughters ? particle.daughtersIds().front() : -1, hasDaughters ? particle.daughtersIds().back() : -1);
+    }
+  }
+
+  /// Empties the index, keeping the allocated memory.
+  void clear()
+  {
+    mOffset = 0;
+    mPdgCode.clear();
+    mProcess.clear();
+    mGenStatusCode.clear();
+    mHasMothers.clear();
+    mMothersRange.clear();
+    mHasDaughters.clear();
+    mDaughtersRange.clear();
+    mFinalPdgSets.clear();
+    mFinalDaughters.clear();
+    mFinalDaughtersPool.clear();
+  }
+
+  std::size_t size() const { return mPdgCode.size(); }
+
+  // Accessors by global index of the MC particle
+
+  int pdgCode(int64_t index) const { return mPdgCode[index - mOffset]; }
+  int process(int64_t index) const { return mProcess[index - mOffset]; }
+  int genStatusCode(int64_t index) const { return mGenStatusCode[index - mOffset]; }
+  bool hasMothers(int64_t index) const { return mHasMothers[index - mOffset]; }
+  int firstMotherId(int64_t index) const { return mMothersRange[index - mOffset].first; }
+  int lastMotherId(int64_t index) const { return mMothersRange[index - mOffset].second; }
+  bool hasDaughters(int64_t index) const { return mHasDaughters[index - mOffset]; }
+  int firstDaughterId(int64_t index) const { return mDaughtersRange[index - mOffset].first; }
+  int lastDaughterId(int64_t index) const { return mDaughtersRange[index - mOffset].second; }
+
+  /// Scratch buffers for the breadth-first search of mothers (current and next decay tree level)
+  std::vector<int64_t>& motherStage() { return mMotherStage; }
+  std::vector<int64_t>& motherStageNext() { return mMotherStageNext; }
+
+  /// Key of a final-state daughter search.
+  /// \param index  global index of the MC particle
+  /// \param arrPdgFinal  array of PDG codes of particles to be considered final; only the set of their absolute values matters
+  /// \param depthMax  maximum decay tree level
+  /// \param checkProcess  whether only decay daughters are accepted
+  template <std::size_t N>
+  uint64_t finalStateKey(int64_t index, const std::array<int, N>& arrPdgFinal, int8_t depthMax, bool checkProcess)
+  {
+    mPdgSetScratch.clear();
+    for (auto pdg : arrPdgFinal) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+      mPdgSetScratch.push_back(std::abs(pdg));
+    }
+    std::sort(mPdgSetScratch.begin(), mPdgSetScratch.end());
+    mPdgSetScratch.erase(std::unique(mPdgSetScratch.begin(), mPdgSetScratch.end()), mPdgSetScratch.end());
+    auto itSet = std::find(mFinalPdgSets.begin(), mFinalPdgSets.end(), mPdgSetScratch);
+    const uint64_t setId = itSet - mFinalPdgSets.begin();
+    if (itSet == mFinalPdgSets.end()) {
+      mFinalPdgSets.push_back(mPdgSetScratch);
+    }
+    return (static_cast<uint64_t>(index - mOffset) << 32) | (setId << 9) | (static_cast<uint64_t>(static_cast<uint8_t>(depthMax)) << 1) | static_cast<uint64_t>(checkProcess);
+  }
+
+  /// Appends the memoised final-state daughters of a search to the list.
+  /// \return false if the search has not been done yet
+  bool getFinalDaughters(uint64_t key, std::vector<int>* list) const
+  {
+    auto it = mFinalDaughters.find(key);
+    if (it == mFinalDaughters.end()) {
+      return false;
+    }
+    const auto [first, count] = it->second;
+    list->insert(list->end(), mFinalDaughtersPool.begin() + first, mFinalDaughtersPool.begin() + first + count);
+    return true;
+  }
+
+  /// Memoises the final-state daughters of a search.
+  void storeFinalDaughters(uint64_t key, const std::vector<int>& list, std::size_t first)
+  {
+    mFinalDaughters.emplace(key, std::make_pair(static_cast<uint32_t>(mFinalDaughtersPool.size()), static_cast<uint32_t>(list.size() - first)));
+    mFinalDaughtersPool.insert(mFinalDaughtersPool.end(), list.begin() + first, list.end());
+  }
+
+ private:
+  int64_t mOffset{0};                                                          // global index of the first particle
+  std::vector<int> mPdgCode;                                                   // PDG codes
+  std::vector<int> mProcess;                                                   // production processes (TMCProcess)
+  std::vector<int> mGenStatusCode;                                             // generator status codes
+  std::vector<uint8_t> mHasMothers;                                            // whether the particle has mothers
+  std::vector<std::pair<int, int>> mMothersRange;                              // first and last mother indices
+  std::vector<uint8_t> mHasDaughters;                                          // whether the particle has daughters
+  std::vector<std::pair<int, int>> mDaughtersRange;                            // first and last daughter indices
+  std::vector<int64_t> mMotherStage;                                           // mother search: particles of the current level
+  std::vector<int64_t> mMotherStageNext;                                       // mother search: particles of the next level
+  std::vector<int> mPdgSetScratch;                                             // canonical set of final PDG codes being looked up
+  std::vector<std::vector<int>> mFinalPdgSets;                                 // distinct sets of final PDG codes
+  std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> mFinalDaughters; // search key -> range in the pool
+  std::vector<int> mFinalDaughtersPool;                                        // memoised final-state daughters
+};
+
+#endif // COMMON_CORE_MCDECAYINDEX_H_
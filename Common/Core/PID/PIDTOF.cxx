@@ -25,14 +25,72 @@
 #include <TGraph.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstddef>
 #include <cstdint>
+#include <regex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace o2::pid::tof
 {
 
+void TOFResoParamsV3::ResolutionForm::compile(std::string const& formula)
+{
+  mType = kFormula;
+  std::string f = formula;
+  f.erase(std::remove_if(f.begin(), f.end(), [](unsigned char c) { return std::isspace(c); }), f.end());
+  // Numbers are converted with std::stod, which rounds as the compiled formula does
+  const std::string number = "([-+]?(?:[0-9]+\\.?[0-9]*|\\.[0-9]+)(?:[eE][-+]?[0-9]+)?)";
+  std::smatch match;
+  if (std::regex_match(f, match, std::regex(number))) {
+    mType = kConstant;
+    mNorm = std::stod(match[1]);
+    return;
+  }
+  // Form of the default parametrisations: A*TMath::Power((TMath::Max(x-B,F))*(1-C*y*y),D)
+  static const std::regex powerLaw(number + "\\*TMath::Power\\(\\(TMath::Max\\(x-" + number + "," + number + "\\)\\)\\*\\(1-" + number + "\\*y\\*y\\)," + number + "\\)");
+  if (std::regex_match(f, match, powerLaw)) {
+    mType = kPowerLaw;
+    mNorm = std::stod(match[1]);
+    mOffset = std::stod(match[2]);
+    mFloor = std::stod(match[3]);
+    mEtaCoeff = std::stod(match[4]);
+    mExponent = std::stod(match[5]);
+  }
+}
+
+void TOFResoParamsV3::TimeShiftTable::fill(const TGraph* g)
+{
+  mFilled = false;
+  mX.clear();
+  mY.clear();
+  if (!g || g->GetN() <= 0) {
+    return;
+  }
+  std::vector<std::pair<double, double>> points(g->GetN());
+  for (int i = 0; i < g->GetN(); ++i) {
+    points[i] = {g->GetX()[i], g->GetY()[i]};
+  }
+  // Sorted in eta keeping the order of the graph among equal abscissae
+  std::stable_sort(points.begin(), points.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+  for (auto const& [x, y] : points) {
+    if (!mX.empty() && x == mX.back()) { // Duplicated abscissa, the first point is kept as TGraph::Eval does
+      continue;
+    }
+    mX.push_back(x);
+    mY.push_back(y);
+  }
+  if (mX.size() < points.size()) {
+    LOG(warning) << "TOFResoParamsV3 time shift: " << points.size() - mX.size() << " points with duplicated eta in " << g->GetName() << " are merged";
+  }
+  mFilled = true;
+}
+
 void TOFResoParamsV3::setResolutionParametrizationRun2(std::unordered_map<std::string, float> const& pars)
 {
   std::array<std::string, 13> paramNames{"TrkRes.Pi.P0", "TrkRes.Pi.P1", "TrkRes.Pi.P2", "TrkRes.Pi.P3", "time_resolution",
@@ -44,6 +102,7 @@ void TOFResoParamsV3::setResolutionParametrizationRun2(std::unordered_map<std::s
       delete mResolution[i];
     }
     mResolution[i] = new TF2(Form("tofResTrack.%s_Run2", particleNames[i]), "-10", 0., 20, -1, 1.); // With negative values the old one is used
+    mResolutionForm[i].compile("-10");
   }
   // Print the map
   for (const auto& [key, value] : pars) {
@@ -71,6 +130,15 @@ void TOFResoParamsV3::setTimeShiftParameters(std::unordered_map<std::string, flo
     graph.AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
   }
   setTimeShiftParameters(&graph, positive);
+  // The graph only lives in this scope, the correction is evaluated from the copied points
+  if (positive) {
+    gPosEtaTimeCorr = nullptr;
+  } else {
+    gNegEtaTimeCorr = nullptr;
+  }
+  if (!(positive ? mPosEtaTimeCorr : mNegEtaTimeCorr).isFilled()) {
+    LOG(error) << "TOFResoParamsV3 time shift: could not build the correction for " << (positive ? "positive" : "negative") << " tracks from " << nPoints << " points, no time shift is applied";
+  }
 }
 void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::string const& objname, const bool positive)
 {
@@ -78,8 +146,10 @@ void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::s
   if (f.IsOpen()) {
     if (positive) {
       f.GetObject(objname.c_str(), gPosEtaTimeCorr);
+      mPosEtaTimeCorr.fill(gPosEtaTimeCorr);
     } else {
       f.GetObject(objname.c_str(), gNegEtaTimeCorr);
+      mNegEtaTimeCorr.fill(gNegEtaTimeCorr);
     }
     f.Close();
   }
@@ -93,19 +163,30 @@ void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
   }
   if (positive) {
     gPosEtaTimeCorr = g;
+    mPosEtaTimeCorr.fill(g);
   } else {
     gNegEtaTimeCorr = g;
+    mNegEtaTimeCorr.fill(g);
+  }
+  if (!(positive ? mPosEtaTimeCorr : mNegEtaTimeCorr).isFilled()) {
+    LOG(error) << "TOFResoParamsV3 time shift: could not build the table of " << g->GetName() << ", the correction is evaluated through the graph";
   }
   LOG(info) << "Set the Time Shift parameters from object " << g->GetName() << " " << g->GetTitle() << " for " << (positive ? "positive" : "negative");
 }
 float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
 {
   if (sign > 0) {
+    if (mPosEtaTimeCorr.isFilled()) {
+      return mPosEtaTimeCorr.eval(eta);
+    }
     if (!gPosEtaTimeCorr) {
       return 0.f;
     }
     return gPosEtaTimeCorr->Eval(eta);
   }
+  if (mNegEtaTimeCorr.isFilled()) {
+    return mNegEtaTimeCorr.eval(eta);
+  }
   if (!gNegEtaTimeCorr) {
     return 0.f;
   }
@@ -30,12 +30,14 @@
 #include <TGraph.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace o2::pid::tof
@@ -247,11 +249,15 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   {
     if (gPosEtaTimeCorr) {
       LOG(info) << "Using a time shift for Pos " << gPosEtaTimeCorr->GetName() << " " << gPosEtaTimeCorr->GetTitle() << " value at 0: " << gPosEtaTimeCorr->Eval(0) << " vs correction " << getTimeShift(0, 1);
+    } else if (mPosEtaTimeCorr.isFilled()) {
+      LOG(info) << "Using a time shift for Pos from the parameter points, correction at 0: " << getTimeShift(0, 1);
     } else {
       LOG(info) << "Using no time shift for Pos vs correction " << getTimeShift(0, 1);
     }
     if (gNegEtaTimeCorr) {
       LOG(info) << "Using a time shift for Neg " << gNegEtaTimeCorr->GetName() << " " << gNegEtaTimeCorr->GetTitle() << " value at 0: " << gNegEtaTimeCorr->Eval(0) << " vs correction " << getTimeShift(0, -1);
+    } else if (mNegEtaTimeCorr.isFilled()) {
+      LOG(info) << "Using a time shift for Neg from the parameter points, correction at 0: " << getTimeShift(0, -1);
     } else {
       LOG(info) << "Using no time shift for Neg vs correction " << getTimeShift(0, -1);
     }
@@ -270,6 +276,7 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
             delete mResolution[i];
           }
           mResolution[i] = new TF2(baseOpt.c_str(), fun.c_str(), 0., 20, -1, 1.);
+          mResolutionForm[i].compile(fun);
           LOG(info) << "Set the resolution function for " << particleNames[i] << " with formula " << mResolution[i]->GetFormula()->GetExpFormula();
           break;
         }
@@ -280,6 +287,7 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
       if (!mResolution[i]) {
         LOG(info) << "Resolution function for " << particleNames[i] << " not provided, using default " << mDefaultResoParams[i];
         mResolution[i] = new TF2(Form("tofResTrack.%s_Default", particleNames[i]), mDefaultResoParams[i], 0., 20, -1, 1.);
+        mResolutionForm[i].compile(mDefaultResoParams[i]);
       }
       LOG(info) << "Resolution function for " << particleNames[i] << " is " << mResolution[i]->GetName() << " with formula " << mResolution[i]->GetFormula()->GetExpFormula();
     }
@@ -290,6 +298,9 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   template <o2::track::PID::ID pid>
   float getResolution(const float p, const float eta) const
   {
+    if (mResolutionForm[pid].isCompiled()) {
+      return mResolutionForm[pid].eval(p, eta);
+    }
     return mResolution[pid]->Eval(p, eta);
   }
 
@@ -301,7 +312,7 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
         LOG(info) << "Resolution function for " << particleNames[i] << " is not defined yet";
         continue;
       }
-      LOG(info) << "Resolution function for " << particleNames[i] << " is " << mResolution[i]->GetName() << " with formula " << mResolution[i]->GetFormula()->GetExpFormula();
+      LOG(info) << "Resolution function for " << particleNames[i] << " is " << mResolution[i]->GetName() << " with formula " << mResolution[i]->GetFormula()->GetExpFormula() << (mResolutionForm[i].isCompiled() ? " (compiled)" : " (TF2)");
     }
   }
   void printFullConfig() const
@@ -313,6 +324,63 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   }
 
  private:
+  /// \brief Closed form of the resolution parametrisation, evaluated in place of TF2::Eval
+  /// Only the constant and the power law forms used by the default parametrisations are recognised,
+  /// any other formula is left to the TF2
+  class ResolutionForm
+  {
+   public:
+    void compile(std::string const& formula);
+    bool isCompiled() const { return mType != kFormula; }
+    double eval(const double p, const double eta) const
+    {
+      if (mType == kConstant) {
+        return mNorm;
+      }
+      return mNorm * std::pow(std::max(p - mOffset, mFloor) * (1 - mEtaCoeff * eta * eta), mExponent);
+    }
+
+   private:
+    enum FormType { kFormula = 0,
+                    kConstant,
+                    kPowerLaw };
+    FormType mType = kFormula;
+    double mNorm = 0.;     /// Normalisation (or value of the constant)
+    double mOffset = 0.;   /// Momentum offset
+    double mFloor = 0.;    /// Lower bound of the shifted momentum
+    double mEtaCoeff = 0.; /// Coefficient of the eta^2 term
+    double mExponent = 0.; /// Exponent of the power law
+  };
+
+  /// \brief Points of a time shift graph, sorted in eta, interpolated as TGraph::Eval does
+  ///        Points with duplicated eta are merged keeping the first one, an empty graph leaves the table unfilled
+  class TimeShiftTable
+  {
+   public:
+    void fill(const TGraph* g);
+    bool isFilled() const { return mFilled; }
+    double eval(const double eta) const
+    {
+      const int n = mX.size();
+      if (n == 1) {
+        return mY[0];
+      }
+      // Index of the first point not below eta, the interpolation uses this point and the previous one
+      int up = std::lower_bound(mX.begin(), mX.end(), eta) - mX.begin();
+      if (up < n && mX[up] == eta) {
+        return mY[up];
+      }
+      up = std::clamp(up, 1, n - 1); // Outside of the graph the two closest points are extrapolated
+      const int low = up - 1;
+      return mY[up] + (eta - mX[up]) * (mY[low] - mY[up]) / (mX[low] - mX[up]);
+    }
+
+   private:
+    bool mFilled = false;
+    std::vector<double> mX;
+    std::vector<double> mY;
+  };
+
   // Charge calibration
   int mEtaN = 0; // Number of eta bins, 0 means no correction
   float mEtaStart = 0.f;
@@ -320,6 +388,7 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   float mInvEtaWidth = 9999.f;
   std::vector<float> mContent;
   std::array<TF2*, 9> mResolution{nullptr};
+  std::array<ResolutionForm, 9> mResolutionForm{}; /// Compiled form of the resolution functions, when recognised
   static constexpr std::array<const char*, 9> mDefaultResoParams{"14.3*TMath::Power((TMath::Max(x-0.319,0.1))*(1-0.4235*y*y),-0.8467)",
                                                                  "14.3*TMath::Power((TMath::Max(x-0.319,0.1))*(1-0.4235*y*y),-0.8467)",
                                                                  "14.3*TMath::Power((TMath::Max(x-0.319,0.1))*(1-0.4235*y*y),-0.8467)",
@@ -334,6 +403,8 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   // Time shift for post calibration
   TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+  TimeShiftTable mPosEtaTimeCorr;    /// Points of the time shift correction for positive tracks
+  TimeShiftTable mNegEtaTimeCorr;    /// Points of the time shift correction for negative tracks
 };
 
 /// \brief Class to handle the the TOF detector response for the TOF beta measurement
@@ -559,6 +630,84 @@ class ExpTimes
   }
 };
 
+/// \brief Class to evaluate the TOF response for several mass hypotheses of the same track in one go
+/// The quantities which do not depend on the hypothesis (momentum and time shifts, event time) are computed once per track,
+/// the results are identical to the ones of ExpTimes::GetExpectedSigma and ExpTimes::GetSeparation
+template <typename TrackType>
+class ExpTimesAllHypotheses
+{
+ public:
+  static constexpr int NHypotheses = 9; /// Number of mass hypotheses, from the electron to the alpha
+
+  /// Computes the expected resolution and the number of sigmas for all the enabled hypotheses
+  /// \param parameters Detector response parameters
+  /// \param track Track of interest
+  /// \param enabledHypotheses Bit mask of the hypotheses to evaluate, bit i corresponds to the PID::ID i
+  /// \param expSigma Expected resolution for each hypothesis, only the enabled entries are written
+  /// \param nSigma Number of sigmas for each hypothesis, only the enabled entries are written
+  template <typename ParamType>
+  static void GetExpectedSigmaAndSeparation(const ParamType& parameters, const TrackType& track, const uint32_t enabledHypotheses,
+                                            std::array<float, NHypotheses>& expSigma, std::array<float, NHypotheses>& nSigma)
+  {
+    TrackQuantities q;
+    q.hasTOF = track.hasTOF();
+    q.tofSignal = track.tofSignal();
+    q.evTime = track.tofEvTime();
+    q.evTimeErr = track.tofEvTimeErr();
+    q.length = track.length();
+    if (q.hasTOF) {
+      if (track.trackType() == o2::aod::track::Run2Track) {
+        q.expMom = track.tofExpMom() * o2::constants::physics::invLightSpeedCm2PS / (1.f + track.sign() * parameters.getMomentumChargeShift(track.eta()));
+      } else {
+        q.expMom = track.tofExpMom() / (1.f + track.sign() * parameters.getMomentumChargeShift(track.eta()));
+        q.hasTimeShift = true;
+        q.timeShift = parameters.getTimeShift(track.eta(), track.sign());
+      }
+    }
+    evaluateHypotheses(parameters, track, q, enabledHypotheses, expSigma, nSigma, std::make_index_sequence<NHypotheses>{});
+  }
+
+ private:
+  /// Hypothesis independent quantities of the track
+  struct TrackQuantities {
+    bool hasTOF = false;
+    bool hasTimeShift = false;
+    float tofSignal = 0.f;
+    float evTime = 0.f;
+    float evTimeErr = 0.f;
+    float length = 0.f;
+    float expMom = 0.f;    /// TOF expected momentum corrected for the charge dependent shift
+    float timeShift = 0.f; /// Eta dependent time shift
+  };
+
+  template <typename ParamType, std::size_t... Ids>
+  static void evaluateHypotheses(const ParamType& parameters, const TrackType& track, const TrackQuantities& q, const uint32_t enabledHypotheses,
+                                 std::array<float, NHypotheses>& expSigma, std::array<float, NHypotheses>& nSigma, std::index_sequence<Ids...>)
+  {
+    (evaluateHypothesis<static_cast<o2::track::PID::ID>(Ids)>(parameters, track, q, enabledHypotheses, expSigma, nSigma), ...);
+  }
+
+  template <o2::track::PID::ID id, typename ParamType>
+  static void evaluateHypothesis(const ParamType& parameters, const TrackType& track, const TrackQuantities& q, const uint32_t enabledHypotheses,
+                                 std::array<float, NHypotheses>& expSigma, std::array<float, NHypotheses>& nSigma)
+  {
+    if (!(enabledHypotheses & (1u << id))) {
+      return;
+    }
+    using Response = ExpTimes<TrackType, id>;
+    expSigma[id] = Response::GetExpectedSigma(parameters, track, q.tofSignal, q.evTimeErr);
+    if (!q.hasTOF) {
+      nSigma[id] = defaultReturnValue;
+      return;
+    }
+    float expTime = Response::ComputeExpectedTime(q.expMom, q.length);
+    if (q.hasTimeShift) {
+      expTime = expTime + q.timeShift;
+    }
+    nSigma[id] = (q.tofSignal - q.evTime - expTime) / expSigma[id];
+  }
+};
+
 /// \brief Class to convert the trackTime to the tofSignal used for PID
 template <typename TrackType>
 class TOFSignal
@@ -25,11 +25,25 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace o2::pid::tpc
 {
 
+/// \brief Columns of track quantities used by the block evaluation of the TPC PID response, one entry per track
+struct ResponseColumns {
+  std::span<const float> tpcInnerParam;
+  std::span<const float> tpcSignal; // signal the number of sigmas is computed for
+  std::span<const float> tpcNClsFound;
+  std::span<const float> tgl;
+  std::span<const float> signed1Pt;
+  std::span<const float> multTPC;
+  std::span<const uint8_t> hasTPC;
+};
+
 /// \brief Class to handle the TPC PID response
 
 class Response
@@ -90,6 +104,9 @@ class Response
   /// Gets the deviation to the expected signal
   template <typename TrackType>
   float GetSignalDelta(const TrackType& trk, const o2::track::PID::ID id) const;
+  /// Gets expected signal, expected resolution and number of sigmas for a block of tracks and a set of hypotheses.
+  /// Outputs are laid out as [hypothesis][track] and match the per-track getters
+  void GetNumberOfSigmaBlock(const ResponseColumns& columns, std::span<const o2::track::PID::ID> ids, std::span<float> expSignal, std::span<float> expSigma, std::span<float> nSigma) const;
 
   /// Gets relative dEdx resolution contribution due to relative pt resolution
   float GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const;
@@ -100,6 +117,8 @@ class Response
   /// Compute expected sigma given a pre-computed expected signal, avoiding a redundant Bethe-Bloch call.
   template <typename TrackType>
   float sigmaFromSignal(float expectedSignal, const long multTPC, const TrackType& track, const o2::track::PID::ID id) const;
+  /// Compute expected sigma with the full resolution parametrisation (mUseDefaultResolutionParam = false)
+  float sigmaFromParametrisation(const float tpcInnerParam, const float tgl, const float signed1Pt, const float nClsFound, const float multTPC, const o2::track::PID::ID id) const;
 
   std::array<float, 5> mBetheBlochParams = {0.03209809958934784, 19.9768009185791, 2.5266601063857674e-16, 2.7212300300598145, 6.080920219421387};
   std::array<float, 2> mResolutionParamsDefault = {0.07, 0.0};
@@ -151,21 +170,26 @@ inline float Response::sigmaFromSignal(float expectedSignal, const long multTPC,
     const float reso = expectedSignal * mResolutionParamsDefault[0] * (static_cast<float>(track.tpcNClsFound()) > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / static_cast<float>(track.tpcNClsFound())) : 1.f);
     reso >= 0.f ? resolution = reso : resolution = -999.f;
   } else {
-    const double ncl = nClNorm / track.tpcNClsFound();
-    const double p = track.tpcInnerParam();
-    const double mass = o2::track::pid_constants::sMasses[id];
-    const double bg = p / mass;
-    const double dEdx = o2::common::BetheBlochAleph(static_cast<float>(bg), mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
-    const double relReso = GetRelativeResolutiondEdx(p, mass, o2::track::pid_constants::sCharges[id], mResolutionParams[3]);
-
-    const std::vector<double> values{1.f / dEdx, track.tgl(), std::sqrt(ncl), relReso, track.signed1Pt(), multTPC / mMultNormalization};
-
-    const float reso = sqrt(pow(mResolutionParams[0], 2) * values[0] + pow(mResolutionParams[1], 2) * (values[2] * mResolutionParams[5]) * pow(values[0] / sqrt(1 + pow(values[1], 2)), mResolutionParams[2]) + values[2] * pow(values[3], 2) + pow(mResolutionParams[4] * values[4], 2) + pow(values[5] * mResolutionParams[6], 2) + pow(values[5] * (values[0] / sqrt(1 + pow(values[1], 2))) * mResolutionParams[7], 2)) * dEdx * mMIP;
-    reso >= 0.f ? resolution = reso : resolution = -999.f;
+    resolution = sigmaFromParametrisation(track.tpcInnerParam(), track.tgl(), track.signed1Pt(), static_cast<float>(track.tpcNClsFound()), static_cast<float>(multTPC), id);
   }
   return resolution;
 }
 
+inline float Response::sigmaFromParametrisation(const float tpcInnerParam, const float tgl, const float signed1Pt, const float nClsFound, const float multTPC, const o2::track::PID::ID id) const
+{
+  const double ncl = nClNorm / nClsFound;
+  const double p = tpcInnerParam;
+  const double mass = o2::track::pid_constants::sMasses[id];
+  const double bg = p / mass;
+  const double dEdx = o2::common::BetheBlochAleph(static_cast<float>(bg), mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
+  const double relReso = GetRelativeResolutiondEdx(p, mass, o2::track::pid_constants::sCharges[id], mResolutionParams[3]);
+
+  const std::array<double, 6> values{1.f / dEdx, tgl, std::sqrt(ncl), relReso, signed1Pt, multTPC / mMultNormalization};
+
+  const float reso = sqrt(pow(mResolutionParams[0], 2) * values[0] + pow(mResolutionParams[1], 2) * (values[2] * mResolutionParams[5]) * pow(values[0] / sqrt(1 + pow(values[1], 2)), mResolutionParams[2]) + values[2] * pow(values[3], 2) + pow(mResolutionParams[4] * values[4], 2) + pow(values[5] * mResolutionParams[6], 2) + pow(values[5] * (values[0] / sqrt(1 + pow(values[1], 2))) * mResolutionParams[7], 2)) * dEdx * mMIP;
+  return reso >= 0.f ? reso : -999.f;
+}
+
 /// Gets the number of sigma between the actual signal and the expected signal
 template <typename CollisionType, typename TrackType>
 inline float Response::GetNumberOfSigma(const CollisionType& collision, const TrackType& trk, const o2::track::PID::ID id) const
@@ -212,6 +236,54 @@ inline float Response::GetSignalDelta(const TrackType& trk, const o2::track::PID
   return trk.tpcSignal() - signal;
 }
 
+/// Block evaluation of the response: the charge factors are folded once per hypothesis and the
+/// track-dependent part of the default resolution once per track, then every hypothesis is
+/// evaluated in a branch-free loop over the tracks
+inline void Response::GetNumberOfSigmaBlock(const ResponseColumns& columns, std::span<const o2::track::PID::ID> ids, std::span<float> expSignal, std::span<float> expSigma, std::span<float> nSigma) const
+{
+  const std::size_t nTracks = columns.tpcInnerParam.size();
+  const float* tpcInnerParam = columns.tpcInnerParam.data();
+  const float* tpcSignal = columns.tpcSignal.data();
+  const float* tpcNClsFound = columns.tpcNClsFound.data();
+  const uint8_t* hasTPC = columns.hasTPC.data();
+
+  std::vector<double> nClsFactor;
+  if (mUseDefaultResolutionParam) {
+    nClsFactor.resize(nTracks);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      nClsFactor[iTrack] = tpcNClsFound[iTrack] > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / tpcNClsFound[iTrack]) : 1.f;
+    }
+  }
+
+  for (std::size_t iId = 0; iId < ids.size(); iId++) {
+    const o2::track::PID::ID id = ids[iId];
+    const float mass = o2::track::pid_constants::sMasses[id];
+    const float chargeFactor = std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
+    float* signalOut = expSignal.data() + iId * nTracks;
+    float* sigmaOut = expSigma.data() + iId * nTracks;
+    float* nSigmaOut = nSigma.data() + iId * nTracks;
+
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      const float bethe = mMIP * o2::common::BetheBlochAleph(tpcInnerParam[iTrack] / mass, mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * chargeFactor;
+      signalOut[iTrack] = (hasTPC[iTrack] && bethe >= 0.f) ? bethe : -999.f;
+    }
+    if (mUseDefaultResolutionParam) {
+      for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+        const float reso = signalOut[iTrack] * mResolutionParamsDefault[0] * nClsFactor[iTrack];
+        sigmaOut[iTrack] = (hasTPC[iTrack] && reso >= 0.f) ? reso : -999.f;
+      }
+    } else {
+      for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+        sigmaOut[iTrack] = hasTPC[iTrack] ? sigmaFromParametrisation(tpcInnerParam[iTrack], columns.tgl[iTrack], columns.signed1Pt[iTrack], tpcNClsFound[iTrack], columns.multTPC[iTrack], id) : -999.f;
+      }
+    }
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      const bool valid = signalOut[iTrack] >= 0.f && sigmaOut[iTrack] >= 0.f;
+      nSigmaOut[iTrack] = valid ? (tpcSignal[iTrack] - signalOut[iTrack]) / sigmaOut[iTrack] : -999.f;
+    }
+  }
+}
+
 //// Gets relative dEdx resolution contribution due relative pt resolution
 inline float Response::GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const
 {
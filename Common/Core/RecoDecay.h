@@ -17,6 +17,8 @@
 #ifndef COMMON_CORE_RECODECAY_H_
 #define COMMON_CORE_RECODECAY_H_
 
+#include "Common/Core/McDecayIndex.h"
+
 #include <CommonConstants/MathConstants.h>
 
 #include <TMCProcess.h> // for VMC Particle Production Process
@@ -640,6 +642,74 @@ struct RecoDecay {
     return indexMother;
   }
 
+  /// Finds the mother of an MC particle, searching the precomputed decay index of the MC particles if provided.
+  /// Gives the same result as getMother without index.
+  /// \param mcIndex  decay index built from particlesMC for the current dataframe; If nullptr, the table is used.
+  /// \note Other parameters and return value as in getMother without index.
+  template <bool acceptFlavourOscillation = false, typename T>
+  static int getMother(McDecayIndex* mcIndex,
+                       const T& particlesMC,
+                       const typename T::iterator& particle,
+                       int pdgMother,
+                       bool acceptAntiParticles = false,
+                       int8_t* sign = nullptr,
+                       int8_t depthMax = -1)
+  {
+    if (!mcIndex) {
+      return getMother<acceptFlavourOscillation>(particlesMC, particle, pdgMother, acceptAntiParticles, sign, depthMax);
+    }
+    int8_t sgn = 0;           // 1 if the expected mother is particle, -1 if antiparticle (w.r.t. pdgMother)
+    int indexMother = -1;     // index of the final matched mother, if found
+    int depth = 0;            // mother tree level
+    bool motherFound = false; // true when the desired mother particle is found in the kine tree
+    if (sign) {
+      *sign = sgn;
+    }
+
+    // Same breadth-first search as in getMother without index, with the current and next level in flat buffers.
+    auto& arrayIds = mcIndex->motherStage();
+    auto& arrayIdsStage = mcIndex->motherStageNext();
+    arrayIds.assign(1, particle.globalIndex());
+    while (!motherFound && arrayIds.size() > 0 && (depthMax < 0 || depth < depthMax)) {
+      arrayIdsStage.clear();
+      for (auto iPart : arrayIds) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+        if (!mcIndex->hasMothers(iPart)) {
+          continue;
+        }
+        for (auto iMother = mcIndex->firstMotherId(iPart); iMother <= mcIndex->lastMotherId(iPart); ++iMother) {
+          if (std::find(arrayIdsStage.begin(), arrayIdsStage.end(), iMother) != arrayIdsStage.end()) { // if a mother is still present in the vector, do not check it again
+            continue;
+          }
+          auto pdgParticleIMother = mcIndex->pdgCode(iMother); // PDG code of the mother
+          if (pdgParticleIMother == pdgMother) {               // exact PDG match
+            sgn = 1;
+            indexMother = iMother;
+            motherFound = true;
+            break;
+          } else if (acceptAntiParticles && pdgParticleIMother == -pdgMother) { // antiparticle PDG match
+            sgn = -1;
+            indexMother = iMother;
+            motherFound = true;
+            break;
+          }
+          arrayIdsStage.push_back(iMother);
+        }
+      }
+      std::swap(arrayIds, arrayIdsStage);
+      depth++;
+    }
+    if (sign) {
+      if constexpr (acceptFlavourOscillation) {
+        if (std::abs(particle.getGenStatusCode()) == StatusCodeAfterFlavourOscillation) { // take possible flavour oscillation of B0(s) mother into account
+          sgn *= -1;                                                                      // select the sign of the mother after oscillation (and not before)
+        }
+      }
+      *sign = sgn;
+    }
+
+    return indexMother;
+  }
+
   /// Gets the complete list of indices of final-state daughters of an MC particle.
   /// \tparam checkProcess  switch to accept only decay daughters by checking the production process of MC particles
   /// \param particle  MC particle
@@ -713,6 +783,77 @@ struct RecoDecay {
     }
   }
 
+  /// Gets the complete list of indices of final-state daughters of an MC particle, using the precomputed decay index of the MC particles if provided.
+  /// Gives the same list, in the same order, as getDaughters without index. With the index, the list found for a given particle,
+  /// set of final PDG codes and depth is memoised and reused by later calls.
+  /// \param mcIndex  decay index built from the MC particle table for the current dataframe; If nullptr, the table is used.
+  /// \note Other parameters as in getDaughters without index.
+  template <bool checkProcess = false, std::size_t N, typename T>
+  static void getDaughters(McDecayIndex* mcIndex,
+                           const T& particle,
+                           std::vector<int>* list,
+                           const std::array<int, N>& arrPdgFinal,
+                           int8_t depthMax = -1)
+  {
+    if (!mcIndex) {
+      getDaughters<checkProcess>(particle, list, arrPdgFinal, depthMax);
+      return;
+    }
+    if (!list) {
+      return;
+    }
+    const auto key = mcIndex->finalStateKey(particle.globalIndex(), arrPdgFinal, depthMax, checkProcess);
+    if (mcIndex->getFinalDaughters(key, list)) {
+      return;
+    }
+    const auto nListed = list->size();
+    getDaughtersFromIndex<checkProcess>(*mcIndex, particle.globalIndex(), list, arrPdgFinal, depthMax, 0);
+    mcIndex->storeFinalDaughters(key, *list, nListed);
+  }
+
+  /// Recursion of getDaughters on the decay index; same logic as getDaughters without index.
+  template <bool checkProcess, std::size_t N>
+  static void getDaughtersFromIndex(const McDecayIndex& mcIndex,
+                                    int64_t index,
+                                    std::vector<int>* list,
+                                    const std::array<int, N>& arrPdgFinal,
+                                    int8_t depthMax,
+                                    int8_t stage)
+  {
+    if constexpr (checkProcess) {
+      if (stage != 0 && mcIndex.process(index) != TMCProcess::kPDecay && mcIndex.process(index) != TMCProcess::kPPrimary) { // decay products of HF hadrons are labeled as kPPrimary
+        return;
+      }
+    }
+    bool isFinal = false;
+    if (depthMax > -1 && stage >= depthMax) {
+      isFinal = true;
+    }
+    if (!isFinal && !mcIndex.hasDaughters(index)) {
+      if (stage == 0) {
+        return;
+      }
+      isFinal = true;
+    }
+    auto pdgParticle = std::abs(mcIndex.pdgCode(index));
+    if (!isFinal && stage > 0) {
+      for (auto pdgI : arrPdgFinal) {        // o2-linter: disable=const-ref-in-for-loop (int elements)
+        if (pdgParticle == std::abs(pdgI)) { // Accept antiparticles.
+          isFinal = true;
+          break;
+        }
+      }
+    }
+    if (isFinal) {
+      list->push_back(index);
+      return;
+    }
+    stage++;
+    for (auto iDau = mcIndex.firstDaughterId(index); iDau <= mcIndex.lastDaughterId(index); ++iDau) {
+      getDaughtersFromIndex<checkProcess>(mcIndex, iDau, list, arrPdgFinal, depthMax, stage);
+    }
+  }
+
   /// Checks whether the reconstructed decay candidate is the expected decay.
   /// \tparam acceptFlavourOscillation  switch to accept decays where the mother oscillated (e.g. B0 -> B0bar)
   /// \tparam checkProcess  switch to accept only decay daughters by checking the production process of MC particles
@@ -741,6 +882,26 @@ struct RecoDecay {
                              int8_t* nPiToMu = nullptr,
                              int8_t* nKaToPi = nullptr,
                              int8_t* nInteractionsWithMaterial = nullptr)
+  {
+    return getMatchedMCRec<acceptFlavourOscillation, checkProcess, acceptIncompleteReco, acceptTrackDecay, acceptTrackIntWithMaterial>(nullptr, particlesMC, arrDaughters, pdgMother, std::move(arrPdgDaughters), acceptAntiParticles, sign, depthMax, nPiToMu, nKaToPi, nInteractionsWithMaterial);
+  }
+
+  /// Checks whether the reconstructed decay candidate is the expected decay, using the precomputed decay index of the MC particles if provided.
+  /// Gives the same result as getMatchedMCRec without index.
+  /// \param mcIndex  decay index built from particlesMC for the current dataframe; If nullptr, the table is used.
+  /// \note Other parameters and return value as in getMatchedMCRec without index.
+  template <bool acceptFlavourOscillation = false, bool checkProcess = false, bool acceptIncompleteReco = false, bool acceptTrackDecay = false, bool acceptTrackIntWithMaterial = false, std::size_t N, typename T, typename U>
+  static int getMatchedMCRec(McDecayIndex* mcIndex,
+                             const T& particlesMC,
+                             const std::array<U, N>& arrDaughters,
+                             int pdgMother,
+                             std::array<int, N> arrPdgDaughters,
+                             bool acceptAntiParticles = false,
+                             int8_t* sign = nullptr,
+                             int depthMax = 1,
+                             int8_t* nPiToMu = nullptr,
+                             int8_t* nKaToPi = nullptr,
+                             int8_t* nInteractionsWithMaterial = nullptr)
   {
     // Printf("MC Rec: Expected mother PDG: %d", pdgMother);
     int8_t coefFlavourOscillation = 1;         // 1 if no B0(s) flavour oscillation occured, -1 else
@@ -815,7 +976,7 @@ struct RecoDecay {
       if (iProng == 0) {
         // Get the mother index and its sign.
         // PDG code of the first daughter's mother determines whether the expected mother is a particle or antiparticle.
-        indexMother = getMother(particlesMC, particleI, pdgMother, acceptAntiParticles, &sgn, depthMax);
+        indexMother = getMother(mcIndex, particlesMC, particleI, pdgMother, acceptAntiParticles, &sgn, depthMax);
         // Check whether mother was found.
         if (indexMother <= -1) {
           // Printf("MC Rec: Rejected: bad mother index or PDG");
@@ -836,7 +997,7 @@ struct RecoDecay {
           }
         }
         // Get the list of actual final daughters.
-        getDaughters<checkProcess>(particleMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+        getDaughters<checkProcess>(mcIndex, particleMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
         // printf("MC Rec: Mother %d has %d final daughters:", indexMother, arrAllDaughtersIndex.size());
         // for (auto i : arrAllDaughtersIndex) {
         //   printf(" %d", i);
@@ -918,6 +1079,19 @@ struct RecoDecay {
     return isMatchedMCGen<acceptFlavourOscillation, checkProcess>(particlesMC, candidate, pdgParticle, std::move(arrPdgDaughters), acceptAntiParticles, sign);
   }
 
+  /// Checks whether the MC particle is the expected one; version with the decay index of the MC particles, see isMatchedMCGen with daughters.
+  template <bool acceptFlavourOscillation = false, bool checkProcess = false, typename T, typename U>
+  static int isMatchedMCGen(McDecayIndex* mcIndex,
+                            const T& particlesMC,
+                            const U& candidate,
+                            int pdgParticle,
+                            bool acceptAntiParticles = false,
+                            int8_t* sign = nullptr)
+  {
+    std::array<int, 0> arrPdgDaughters;
+    return isMatchedMCGen<acceptFlavourOscillation, checkProcess>(mcIndex, particlesMC, candidate, pdgParticle, std::move(arrPdgDaughters), acceptAntiParticles, sign);
+  }
+
   /// Check whether the MC particle is the expected one and whether it decayed via the expected decay channel.
   /// \tparam acceptFlavourOscillation  switch to accept decays where the mother oscillated (e.g. B0 -> B0bar)
   /// \tparam checkProcess  switch to accept only decay daughters by checking the production process of MC particles
@@ -939,6 +1113,24 @@ struct RecoDecay {
                              int8_t* sign = nullptr,
                              int depthMax = 1,
                              std::vector<int>* listIndexDaughters = nullptr)
+  {
+    return isMatchedMCGen<acceptFlavourOscillation, checkProcess>(nullptr, particlesMC, candidate, pdgParticle, std::move(arrPdgDaughters), acceptAntiParticles, sign, depthMax, listIndexDaughters);
+  }
+
+  /// Checks whether the MC particle is the expected one and whether it decayed via the expected decay channel,
+  /// using the precomputed decay index of the MC particles if provided. Gives the same result as isMatchedMCGen without index.
+  /// \param mcIndex  decay index built from particlesMC for the current dataframe; If nullptr, the table is used.
+  /// \note Other parameters and return value as in isMatchedMCGen without index.
+  template <bool acceptFlavourOscillation = false, bool checkProcess = false, std::size_t N, typename T, typename U>
+  static bool isMatchedMCGen(McDecayIndex* mcIndex,
+                             const T& particlesMC,
+                             const U& candidate,
+                             int pdgParticle,
+                             std::array<int, N> arrPdgDaughters,
+                             bool acceptAntiParticles = false,
+                             int8_t* sign = nullptr,
+                             int depthMax = 1,
+                             std::vector<int>* listIndexDaughters = nullptr)
   {
     // Printf("MC Gen: Expected particle PDG: %d", pdgParticle);
     int8_t coefFlavourOscillation = 1; // 1 if no B0(s) flavour oscillation occured, -1 else
@@ -974,7 +1166,7 @@ struct RecoDecay {
         }
       }
       // Get the list of actual final daughters.
-      getDaughters<checkProcess>(candidate, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+      getDaughters<checkProcess>(mcIndex, candidate, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
       // printf("MC Gen: Mother %ld has %ld final daughters:", candidate.globalIndex(), arrAllDaughtersIndex.size());
       // for (auto i : arrAllDaughtersIndex) {
       //   printf(" %d", i);
@@ -987,18 +1179,19 @@ struct RecoDecay {
       }
       if constexpr (acceptFlavourOscillation) {
         // Loop over decay candidate prongs to spot possible oscillation decay product
-        for (auto indexDaughterI : arrAllDaughtersIndex) {                                            // o2-linter: disable=const-ref-in-for-loop (int elements)
-          auto candidateDaughterI = particlesMC.rawIteratorAt(indexDaughterI - particlesMC.offset()); // ith daughter particle
-          if (std::abs(candidateDaughterI.getGenStatusCode()) == StatusCodeAfterFlavourOscillation) { // oscillation decay product spotted
-            coefFlavourOscillation = -1;                                                              // select the sign of the mother after oscillation (and not before)
+        for (auto indexDaughterI : arrAllDaughtersIndex) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+          // generator status code of the ith daughter particle
+          auto statusDaughterI = mcIndex ? mcIndex->genStatusCode(indexDaughterI) : particlesMC.rawIteratorAt(indexDaughterI - particlesMC.offset()).getGenStatusCode();
+          if (std::abs(statusDaughterI) == StatusCodeAfterFlavourOscillation) { // oscillation decay product spotted
+            coefFlavourOscillation = -1;                                       // select the sign of the mother after oscillation (and not before)
             break;
           }
         }
       }
       // Check daughters' PDG codes.
-      for (auto indexDaughterI : arrAllDaughtersIndex) {                                            // o2-linter: disable=const-ref-in-for-loop (int elements)
-        auto candidateDaughterI = particlesMC.rawIteratorAt(indexDaughterI - particlesMC.offset()); // ith daughter particle
-        auto pdgCandidateDaughterI = candidateDaughterI.pdgCode();                                  // PDG code of the ith daughter
+      for (auto indexDaughterI : arrAllDaughtersIndex) { // o2-linter: disable=const-ref-in-for-loop (int elements)
+        // PDG code of the ith daughter
+        auto pdgCandidateDaughterI = mcIndex ? mcIndex->pdgCode(indexDaughterI) : particlesMC.rawIteratorAt(indexDaughterI - particlesMC.offset()).pdgCode();
         // Printf("MC Gen: Daughter %d PDG: %d", indexDaughterI, pdgCandidateDaughterI);
         bool isPdgFound = false; // Is the PDG code of this daughter among the remaining expected PDG codes?
         for (std::size_t iProngCp = 0; iProngCp < N; ++iProngCp) {
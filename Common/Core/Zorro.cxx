@@ -30,10 +30,13 @@
 #include <RtypesCore.h>
 
 #include <algorithm>
+#include <bit>
 #include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <numeric>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -190,7 +193,6 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   mSelections = mCCDB->getForRun<TH1D>(mBaseCCDBPath + "SelectionCounters", runNumber, true);
   mInspectedTVX = mCCDB->getForRun<TH1D>(mBaseCCDBPath + "InspectedTVX", runNumber, true);
   setupHelpers(timestamp);
-  mLastBCglobalId = 0;
   mLastSelectedIdx = 0;
   mTOIs.clear();
   mTOIidx.clear();
@@ -216,6 +218,35 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
   return mTOIidx;
 }
 
+int64_t Zorro::collectSelections(uint64_t bcGlobalId, uint64_t tolerance, size_t firstRange, std::bitset<128>& result)
+{
+  const uint64_t bcMin{bcGlobalId > tolerance ? bcGlobalId - tolerance : 0};
+  const uint64_t bcMax{bcGlobalId + tolerance};
+  int64_t firstSelected{-1};
+  for (size_t i{firstRange}; i < mBCrangeMin.size() && mBCrangeMin[i] <= bcMax; ++i) {
+    if (mBCrangeMax[i] < bcMin) {
+      continue;
+    }
+    result |= mBCrangeMasks[i];
+    if (!mAccountedBCranges[i]) {
+      for (int iMask{0}; iMask < 2; ++iMask) {
+        for (uint64_t mask{mZorroHelpers->at(i).selMask[iMask]}; mask; mask &= mask - 1) {
+          const int iTOI{iMask * 64 + std::countr_zero(mask)};
+          mATcounts[iTOI]++;
+          if (mAnalysedTriggers) {
+            mAnalysedTriggers->Fill(iTOI);
+          }
+        }
+      }
+      mAccountedBCranges[i] = true;
+    }
+    if (firstSelected < 0) {
+      firstSelected = i;
+    }
+  }
+  return firstSelected;
+}
+
 std::bitset<128> Zorro::fetch(uint64_t bcGlobalId, uint64_t tolerance)
 {
   mLastResult.reset();
@@ -223,36 +254,46 @@ std::bitset<128> Zorro::fetch(uint64_t bcGlobalId, uint64_t tolerance)
     setupHelpers((mOrbitResetTimestamp + static_cast<int64_t>(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
   }
 
-  o2::dataformats::IRFrame bcFrame{InteractionRecord::long2IR(bcGlobalId) - tolerance, InteractionRecord::long2IR(bcGlobalId) + tolerance};
-  if (bcGlobalId < mLastBCglobalId) { /// Handle the possible discontinuity in the BC processed by the analyses
-    mLastSelectedIdx = 0;
+  /// The ranges are sorted by their start, the first one that can overlap is the first whose running maximum end reaches the BC window
+  const uint64_t bcMin{bcGlobalId > tolerance ? bcGlobalId - tolerance : 0};
+  const size_t firstRange = std::lower_bound(mBCrangeMaxPrefix.begin(), mBCrangeMaxPrefix.end(), bcMin) - mBCrangeMaxPrefix.begin();
+  const int64_t firstSelected{collectSelections(bcGlobalId, tolerance, firstRange, mLastResult)};
+  if (firstSelected >= 0) {
+    mLastSelectedIdx = firstSelected;
   }
-  uint64_t lastSelectedIdx = mLastSelectedIdx;
-  mLastBCglobalId = bcGlobalId;
-  for (size_t i = mLastSelectedIdx; i < mBCranges.size(); i++) {
-    if (!mBCranges[i].isOutside(bcFrame)) {
-      for (int iMask{0}; iMask < 2; ++iMask) {
-        for (int iTOI{0}; iTOI < 64; ++iTOI) {
-          if (mZorroHelpers->at(i).selMask[iMask] & (1ull << iTOI)) {
-            mLastResult.set(iMask * 64 + iTOI, 1);
-            if (!mAccountedBCranges[i]) {
-              mATcounts[iMask * 64 + iTOI]++;
-              if (mAnalysedTriggers) {
-                mAnalysedTriggers->Fill(iMask * 64 + iTOI);
-              }
-            }
-          }
-        }
-      }
-      mAccountedBCranges[i] = true;
-      mLastSelectedIdx = mLastSelectedIdx == lastSelectedIdx-- ? i : mLastSelectedIdx; /// Decrease lastSelectedIdx to make sure this check is valid only in its first instance
-    } else if (mBCranges[i].getMax() < bcFrame.getMin()) {
-      mLastSelectedIdx = i;
-    } else if (mBCranges[i].getMin() > bcFrame.getMax()) {
-      break;
+  return mLastResult;
+}
+
+std::vector<std::bitset<128>> Zorro::fetch(std::span<const uint64_t> bcGlobalIds, uint64_t tolerance)
+{
+  std::vector<std::bitset<128>> results(bcGlobalIds.size());
+  if (bcGlobalIds.empty()) {
+    return results;
+  }
+  std::vector<size_t> order(bcGlobalIds.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return bcGlobalIds[a] < bcGlobalIds[b]; });
+
+  const uint64_t bcFirst{bcGlobalIds[order.front()]}, bcLast{bcGlobalIds[order.back()]};
+  if (bcFirst < mBCranges.front().getMin().toLong() - tolerance || bcLast > mBCranges.back().getMax().toLong() + tolerance) {
+    /// Some BCs need different helpers, go through the single BC lookup
+    for (size_t i{0}; i < bcGlobalIds.size(); ++i) {
+      results[i] = fetch(bcGlobalIds[i], tolerance);
     }
+    return results;
   }
-  return mLastResult;
+
+  /// Merge-join of the sorted BCs with the sorted BC ranges: the first range that can overlap only moves forward
+  size_t firstRange{0};
+  for (const auto& iBC : order) {
+    const uint64_t bcMin{bcGlobalIds[iBC] > tolerance ? bcGlobalIds[iBC] - tolerance : 0};
+    while (firstRange < mBCrangeMaxPrefix.size() && mBCrangeMaxPrefix[firstRange] < bcMin) {
+      ++firstRange;
+    }
+    collectSelections(bcGlobalIds[iBC], tolerance, firstRange, results[iBC]);
+  }
+  mLastResult = results.back();
+  return results;
 }
 
 bool Zorro::isSelected(uint64_t bcGlobalId, uint64_t tolerance, TH2* ToiHisto)
@@ -316,9 +357,17 @@ void Zorro::setupHelpers(int64_t timestamp)
   mZorroHelpers = mCCDB->getSpecific<std::vector<ZorroHelper>>(mBaseCCDBPath + "ZorroHelpers", timestamp, {{"runNumber", std::to_string(mRunNumber)}});
   std::sort(mZorroHelpers->begin(), mZorroHelpers->end(), [](const auto& a, const auto& b) { return std::min(a.bcAOD, a.bcEvSel) < std::min(b.bcAOD, b.bcEvSel); });
   mBCranges.clear();
+  mBCrangeMin.clear();
+  mBCrangeMax.clear();
+  mBCrangeMaxPrefix.clear();
+  mBCrangeMasks.clear();
   mAccountedBCranges.clear();
   for (const auto& helper : *mZorroHelpers) {
     mBCranges.emplace_back(InteractionRecord::long2IR(std::min(helper.bcAOD, helper.bcEvSel)), InteractionRecord::long2IR(std::max(helper.bcAOD, helper.bcEvSel)));
+    mBCrangeMin.push_back(std::min(helper.bcAOD, helper.bcEvSel));
+    mBCrangeMax.push_back(std::max(helper.bcAOD, helper.bcEvSel));
+    mBCrangeMaxPrefix.push_back(mBCrangeMaxPrefix.empty() ? mBCrangeMax.back() : std::max(mBCrangeMaxPrefix.back(), mBCrangeMax.back()));
+    mBCrangeMasks.emplace_back((std::bitset<128>(helper.selMask[1]) << 64) | std::bitset<128>(helper.selMask[0]));
   }
   mAccountedBCranges.resize(mBCranges.size(), false);
 }
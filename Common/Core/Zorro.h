@@ -29,7 +29,9 @@
 #include <TH2.h>
 
 #include <bitset>
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -48,6 +50,7 @@ class Zorro
   Zorro() = default;
   std::vector<int> initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp, std::string tois, int bcTolerance = 500);
   std::bitset<128> fetch(uint64_t bcGlobalId, uint64_t tolerance = 100);
+  std::vector<std::bitset<128>> fetch(std::span<const uint64_t> bcGlobalIds, uint64_t tolerance = 100);
   bool isSelected(uint64_t bcGlobalId, uint64_t tolerance = 100, TH2* toiHisto = nullptr);
   bool isNotSelectedByAny(uint64_t bcGlobalId, uint64_t tolerance = 100);
 
@@ -72,6 +75,7 @@ class Zorro
 
  private:
   void setupHelpers(int64_t timestamp);
+  int64_t collectSelections(uint64_t bcGlobalId, uint64_t tolerance, size_t firstRange, std::bitset<128>& result);
 
   ZorroSummary mZorroSummary{"ZorroSummary", "ZorroSummary"};
 
@@ -87,7 +91,6 @@ class Zorro
   std::vector<TH1*> mAnalysedTriggersOfInterestList; /// Per run histograms
 
   int mBCtolerance = 100;
-  uint64_t mLastBCglobalId = 0;
   uint64_t mLastSelectedIdx = 0;
   TH1D* mScalers = nullptr;
   TH1D* mSelections = nullptr;
@@ -95,6 +98,10 @@ class Zorro
   std::bitset<128> mLastResult;
   std::vector<bool> mAccountedBCranges; /// Avoid double accounting of inspected BC ranges
   std::vector<o2::dataformats::IRFrame> mBCranges;
+  std::vector<uint64_t> mBCrangeMin;           /// Start of the BC ranges (sorted)
+  std::vector<uint64_t> mBCrangeMax;           /// End of the BC ranges
+  std::vector<uint64_t> mBCrangeMaxPrefix;     /// Running maximum of the BC range ends, to binary search the first range that can overlap a BC
+  std::vector<std::bitset<128>> mBCrangeMasks; /// Selection masks of the BC ranges
   std::vector<ZorroHelper>* mZorroHelpers = nullptr;
   std::vector<std::string> mTOIs;
   std::vector<int> mTOIidx;
@@ -357,6 +357,118 @@ struct tofEventTime {
   }
   PROCESS_SWITCH(tofEventTime, processRun2, "Process with Run2 data", true);
 
+  ///
+  /// Computes the event time for the tracks of one collision, with TOF (removing the bias of each track) and, if useFT0, combined with the FT0
+  /// The result of each track is passed, in track order, to fillTrack(track, flags, evTime, evTimeErr, evTimeTOF, evTimeTOFErr, evTimeTOFMult)
+  template <bool useFT0, typename TTracksInCollision, typename TCollision, typename TFiller>
+  void computeEvTimeInCollision(TTracksInCollision const& tracksInCollision, TCollision const& collision, TFiller&& fillTrack)
+  {
+    const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, tofResponse->parameters, kDiamond);
+    int nGoodTracksForTOF = 0;
+
+    if constexpr (useFT0) {
+      float t0AC[2] = {.0f, 999.f};                                                                                             // Value and error of T0A or T0C or T0AC
+      float t0TOF[2] = {static_cast<float_t>(evTimeMakerTOF.mEventTime), static_cast<float_t>(evTimeMakerTOF.mEventTimeError)}; // Value and error of TOF
+
+      uint8_t flags = 0;
+      float eventTime = 0.f;
+      float sumOfWeights = 0.f;
+      float weight = 0.f;
+
+      for (auto const& trk : tracksInCollision) { // Loop on Tracks
+        // Reset the flag
+        flags = 0;
+        // Reset the event time
+        eventTime = 0.f;
+        sumOfWeights = 0.f;
+        weight = 0.f;
+        // Remove the bias on TOF ev. time
+        if constexpr (kRemoveTOFEvTimeBias) {
+          evTimeMakerTOF.template removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, t0TOF[0], t0TOF[1], 2);
+        }
+        if (t0TOF[1] < kErrDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+
+          weight = 1.f / (t0TOF[1] * t0TOF[1]);
+          eventTime += t0TOF[0] * weight;
+          sumOfWeights += weight;
+        }
+
+        if (collision.has_foundFT0()) { // T0 measurement is available
+          // const auto& ft0 = collision.foundFT0();
+          if (collision.t0ACValid()) {
+            t0AC[0] = collision.t0AC() * 1000.f;
+            t0AC[1] = collision.t0resolution() * 1000.f;
+            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
+          }
+
+          weight = 1.f / (t0AC[1] * t0AC[1]);
+          eventTime += t0AC[0] * weight;
+          sumOfWeights += weight;
+        }
+
+        if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that kDiamond
+          eventTime = 0;
+          sumOfWeights = kWeightDiamond;
+          flags = 0;
+        }
+        fillTrack(trk, flags, eventTime / sumOfWeights, static_cast<float>(std::sqrt(1. / sumOfWeights)), t0TOF[0], t0TOF[1], evTimeMakerTOF.mEventTimeMultiplicity);
+      }
+    } else {
+      float et = evTimeMakerTOF.mEventTime;
+      float erret = evTimeMakerTOF.mEventTimeError;
+
+      for (auto const& trk : tracksInCollision) { // Loop on Tracks
+        if constexpr (kRemoveTOFEvTimeBias) {
+          evTimeMakerTOF.template removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, et, erret, 2);
+        }
+        uint8_t flags = 0;
+        if (erret < kErrDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
+          flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
+        } else {
+          et = 0.f;
+          erret = kErrDiamond;
+        }
+        fillTrack(trk, flags, et, erret, et, erret, evTimeMakerTOF.mEventTimeMultiplicity);
+      }
+    }
+  }
+
+  ///
+  /// Fills the event time tables of Run 3 data computing the event time with the TOF and, if useFT0, with the FT0
+  /// The collisions are processed one after the other: o2::tof::evTimeMakerFromParam works on static buffers and is not reentrant
+  template <bool useFT0>
+  void makeEvTimeTables(Run3TrksWtof const& tracks, EvTimeCollisionsFT0 const& collisions)
+  {
+    auto fillTables = [&](auto const& trk, uint8_t flags, float evTime, float evTimeErr, float evTimeTOF, float evTimeTOFErr, int evTimeTOFMult) {
+      tableFlags(flags);
+      tableEvTime(evTime, evTimeErr);
+      if (enableTableEvTimeTOFOnly) {
+        tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), evTimeTOF, evTimeTOFErr, evTimeTOFMult);
+      }
+    };
+
+    int lastCollisionId = -1;                                                                                                                 // Last collision ID analysed
+    for (auto const& t : tracks) {                                                                                                            // Loop on collisions
+      if (!t.has_collision() || collisions.size() == 0 || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisionsFT0>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
+        tableFlags(0);
+        tableEvTime(0.f, 999.f);
+        if (enableTableEvTimeTOFOnly) {
+          tableEvTimeTOFOnly((uint8_t)0, 0.f, 0.f, -1);
+        }
+        continue;
+      }
+      if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
+        continue;
+      }
+      /// Create new table for the tracks in a collision
+      lastCollisionId = t.collisionId(); /// Cache last collision ID
+
+      const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
+      computeEvTimeInCollision<useFT0>(tracksInCollision, t.collision_as<EvTimeCollisionsFT0>(), fillTables);
+    }
+  }
+
   ///
   /// Process function to prepare the event for each track on Run 3 data without the FT0
   // Define slice per collision
@@ -399,124 +511,9 @@ struct tofEventTime {
     LOG(debug) << "Running on " << CollisionSystemType::getCollisionSystemName(tofResponse->cfgCollisionType()) << " mComputeEvTimeWithTOF " << mComputeEvTimeWithTOF.value << " mComputeEvTimeWithFT0 " << mComputeEvTimeWithFT0.value;
 
     if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 1) {
-      int lastCollisionId = -1;                                                                                                                 // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                                                            // Loop on collisions
-        if (!t.has_collision() || collisions.size() == 0 || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisionsFT0>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
-          tableFlags(0);
-          tableEvTime(0.f, 999.f);
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)0, 0.f, 0.f, -1);
-          }
-          continue;
-        }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
-        const auto& collision = t.collision_as<EvTimeCollisionsFT0>();
-
-        // Compute the TOF event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, tofResponse->parameters, kDiamond);
-        float t0AC[2] = {.0f, 999.f};                                                                                             // Value and error of T0A or T0C or T0AC
-        float t0TOF[2] = {static_cast<float_t>(evTimeMakerTOF.mEventTime), static_cast<float_t>(evTimeMakerTOF.mEventTimeError)}; // Value and error of TOF
-
-        uint8_t flags = 0;
-        int nGoodTracksForTOF = 0;
-        float eventTime = 0.f;
-        float sumOfWeights = 0.f;
-        float weight = 0.f;
-
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          // Reset the flag
-          flags = 0;
-          // Reset the event time
-          eventTime = 0.f;
-          sumOfWeights = 0.f;
-          weight = 0.f;
-          // Remove the bias on TOF ev. time
-          if constexpr (kRemoveTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, t0TOF[0], t0TOF[1], 2);
-          }
-          if (t0TOF[1] < kErrDiamond && (maxEvTimeTOF <= 0 || std::abs(t0TOF[0]) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
-
-            weight = 1.f / (t0TOF[1] * t0TOF[1]);
-            eventTime += t0TOF[0] * weight;
-            sumOfWeights += weight;
-          }
-
-          if (collision.has_foundFT0()) { // T0 measurement is available
-            // const auto& ft0 = collision.foundFT0();
-            if (collision.t0ACValid()) {
-              t0AC[0] = collision.t0AC() * 1000.f;
-              t0AC[1] = collision.t0resolution() * 1000.f;
-              flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeT0AC;
-            }
-
-            weight = 1.f / (t0AC[1] * t0AC[1]);
-            eventTime += t0AC[0] * weight;
-            sumOfWeights += weight;
-          }
-
-          if (sumOfWeights < kWeightDiamond) { // avoiding sumOfWeights = 0 or worse that kDiamond
-            eventTime = 0;
-            sumOfWeights = kWeightDiamond;
-            tableFlags(0);
-          } else {
-            tableFlags(flags);
-          }
-          tableEvTime(eventTime / sumOfWeights, std::sqrt(1. / sumOfWeights));
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), t0TOF[0], t0TOF[1], evTimeMakerTOF.mEventTimeMultiplicity);
-          }
-        }
-      }
+      makeEvTimeTables<true>(tracks, collisions);
     } else if (mComputeEvTimeWithTOF == 1 && mComputeEvTimeWithFT0 == 0) {
-      int lastCollisionId = -1;                                                                                                              // Last collision ID analysed
-      for (auto const& t : tracks) {                                                                                                         // Loop on collisions
-        if (!t.has_collision() || collisions.size() == 0 || ((sel8TOFEvTime.value == true) && !t.collision_as<EvTimeCollisions>().sel8())) { // Track was not assigned, cannot compute event time or event did not pass the event selection
-          tableFlags(0);
-          tableEvTime(0.f, 999.f);
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)0, 0.f, 0.f, -1);
-          }
-          continue;
-        }
-        if (t.collisionId() == lastCollisionId) { // Event time from this collision is already in the table
-          continue;
-        }
-        /// Create new table for the tracks in a collision
-        lastCollisionId = t.collisionId(); /// Cache last collision ID
-
-        const auto& tracksInCollision = tracks.sliceBy(perCollision, lastCollisionId);
-
-        // First make table for event time
-        const auto evTimeMakerTOF = evTimeMakerForTracks<Run3TrksWtof::iterator, filterForTOFEventTime, o2::pid::tof::ExpTimes>(tracksInCollision, tofResponse->parameters, kDiamond);
-        int nGoodTracksForTOF = 0;
-        float et = evTimeMakerTOF.mEventTime;
-        float erret = evTimeMakerTOF.mEventTimeError;
-
-        for (auto const& trk : tracksInCollision) { // Loop on Tracks
-          if constexpr (kRemoveTOFEvTimeBias) {
-            evTimeMakerTOF.removeBias<Run3TrksWtof::iterator, filterForTOFEventTime>(trk, nGoodTracksForTOF, et, erret, 2);
-          }
-          uint8_t flags = 0;
-          if (erret < kErrDiamond && (maxEvTimeTOF <= 0.f || std::abs(et) < maxEvTimeTOF)) {
-            flags |= o2::aod::pidflags::enums::PIDFlags::EvTimeTOF;
-          } else {
-            et = 0.f;
-            erret = kErrDiamond;
-          }
-          tableFlags(flags);
-          tableEvTime(et, erret);
-          if (enableTableEvTimeTOFOnly) {
-            tableEvTimeTOFOnly((uint8_t)filterForTOFEventTime(trk), et, erret, evTimeMakerTOF.mEventTimeMultiplicity);
-          }
-        }
-      }
+      makeEvTimeTables<false>(tracks, collisions);
     } else if (mComputeEvTimeWithTOF == 0 && mComputeEvTimeWithFT0 == 1) {
       for (auto const& t : tracks) { // Loop on collisions
         if (enableTableEvTimeTOFOnly) {
@@ -622,6 +619,7 @@ struct tofPidMerge {
   // Running variables
   std::vector<int> mEnabledParticles;     // Vector of enabled PID hypotheses to loop on when making tables
   std::vector<int> mEnabledParticlesFull; // Vector of enabled PID hypotheses to loop on when making full tables
+  uint32_t mEnabledHypotheses = 0;        // Bit mask of the PID hypotheses to evaluate, either for tiny or full tables
   void init(o2::framework::InitContext& initContext)
   {
     LOG(debug) << "Initializing the TOF PID Merge task";
@@ -633,6 +631,7 @@ struct tofPidMerge {
       o2::common::core::enableFlagIfTableRequired(initContext, "pidTOF" + particleNames[i], f);
       if (f == 1) {
         mEnabledParticles.push_back(i);
+        mEnabledHypotheses |= 1u << i;
       }
 
       // Then checking full tables
@@ -640,6 +639,7 @@ struct tofPidMerge {
       o2::common::core::enableFlagIfTableRequired(initContext, "pidTOFFull" + particleNames[i], f);
       if (f == 1) {
         mEnabledParticlesFull.push_back(i);
+        mEnabledHypotheses |= 1u << i;
       }
     }
     if (mEnabledParticlesFull.size() == 0 && mEnabledParticles.size() == 0) {
@@ -876,188 +876,83 @@ struct tofPidMerge {
     }
   }
 
-  void process(aod::BCs const&) {}
-
-  template <o2::track::PID::ID pid>
-  using ResponseImplementation = o2::pid::tof::ExpTimes<Run3TrksWtofWevTime::iterator, pid>;
-  void processRun3(Run3TrksWtofWevTime const& tracks,
-                   aod::Collisions const& collisions,
-                   aod::BCsWithTimestamps const& bcs)
+  // Fills the table for the given particle ID with the computed resolution and number of sigmas
+  void fillTable(const int id, const bool fullTable, const float resolution, const float nsigma)
   {
-    constexpr auto responseEl = ResponseImplementation<PID::Electron>();
-    constexpr auto responseMu = ResponseImplementation<PID::Muon>();
-    constexpr auto responsePi = ResponseImplementation<PID::Pion>();
-    constexpr auto responseKa = ResponseImplementation<PID::Kaon>();
-    constexpr auto responsePr = ResponseImplementation<PID::Proton>();
-    constexpr auto responseDe = ResponseImplementation<PID::Deuteron>();
-    constexpr auto responseTr = ResponseImplementation<PID::Triton>();
-    constexpr auto responseHe = ResponseImplementation<PID::Helium3>();
-    constexpr auto responseAl = ResponseImplementation<PID::Alpha>();
-
-    tofResponse->processSetup(bcs.iteratorAt(0)); // Update the calibration parameters
-
-    for (auto const& pidId : mEnabledParticles) {
-      reserveTable(pidId, tracks.size(), false);
-    }
-
-    for (auto const& pidId : mEnabledParticlesFull) {
-      reserveTable(pidId, tracks.size(), true);
-    }
-
-    float resolution = 1.f; // Last resolution assigned
-    float nsigma = 0;
-    for (auto const& trk : tracks) {                        // Loop on all tracks
-      if (!trk.has_collision() || collisions.size() == 0) { // Track was not assigned, cannot compute NSigma (no event time) -> filling with empty table
-        for (auto const& pidId : mEnabledParticles) {
-          makeTableEmpty(pidId, false);
+    switch (id) {
+      case kIdxEl:
+        if (fullTable) {
+          tablePIDFullEl(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDEl);
         }
-        for (auto const& pidId : mEnabledParticlesFull) {
-          makeTableEmpty(pidId, true);
+        break;
+      case kIdxMu:
+        if (fullTable) {
+          tablePIDFullMu(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDMu);
         }
-        continue;
-      }
-
-      for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
-        switch (pidId) {
-          case kIdxEl: {
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDEl);
-            break;
-          }
-          case kIdxMu: {
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDMu);
-            break;
-          }
-          case kIdxPi: {
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPi);
-            break;
-          }
-          case kIdxKa: {
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDKa);
-            break;
-          }
-          case kIdxPr: {
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPr);
-            break;
-          }
-          case kIdxDe: {
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDDe);
-            break;
-          }
-          case kIdxTr: {
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDTr);
-            break;
-          }
-          case kIdxHe: {
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDHe);
-            break;
-          }
-          case kIdxAl: {
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDAl);
-            break;
-          }
-          default:
-            LOG(fatal) << "Wrong particle ID for standard tables";
-            break;
+        break;
+      case kIdxPi:
+        if (fullTable) {
+          tablePIDFullPi(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPi);
         }
-        if (enableQaHistograms) {
-          hnsigma[pidId]->Fill(trk.p(), nsigma);
+        break;
+      case kIdxKa:
+        if (fullTable) {
+          tablePIDFullKa(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDKa);
         }
-      }
-      for (auto const& pidId : mEnabledParticlesFull) { // Loop on enabled particle hypotheses with full tables
-        switch (pidId) {
-          case kIdxEl: {
-            resolution = responseEl.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullEl(resolution, nsigma);
-            break;
-          }
-          case kIdxMu: {
-            resolution = responseMu.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullMu(resolution, nsigma);
-            break;
-          }
-          case kIdxPi: {
-            resolution = responsePi.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
-            tablePIDFullPi(resolution, nsigma);
-            break;
-          }
-          case kIdxKa: {
-            resolution = responseKa.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullKa(resolution, nsigma);
-            break;
-          }
-          case kIdxPr: {
-            resolution = responsePr.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullPr(resolution, nsigma);
-            break;
-          }
-          case kIdxDe: {
-            resolution = responseDe.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullDe(resolution, nsigma);
-            break;
-          }
-          case kIdxTr: {
-            resolution = responseTr.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullTr(resolution, nsigma);
-            break;
-          }
-          case kIdxHe: {
-            resolution = responseHe.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullHe(resolution, nsigma);
-            break;
-          }
-          case kIdxAl: {
-            resolution = responseAl.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullAl(resolution, nsigma);
-            break;
-          }
-          default:
-            LOG(fatal) << "Wrong particle ID for full tables";
-            break;
+        break;
+      case kIdxPr:
+        if (fullTable) {
+          tablePIDFullPr(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPr);
         }
-        if (enableQaHistograms) {
-          hnsigmaFull[pidId]->Fill(trk.p(), nsigma);
+        break;
+      case kIdxDe:
+        if (fullTable) {
+          tablePIDFullDe(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDDe);
         }
-      }
+        break;
+      case kIdxTr:
+        if (fullTable) {
+          tablePIDFullTr(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDTr);
+        }
+        break;
+      case kIdxHe:
+        if (fullTable) {
+          tablePIDFullHe(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDHe);
+        }
+        break;
+      case kIdxAl:
+        if (fullTable) {
+          tablePIDFullAl(resolution, nsigma);
+        } else {
+          aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDAl);
+        }
+        break;
+      default:
+        LOG(fatal) << "Wrong particle ID in fillTable() for " << (fullTable ? "full" : "tiny") << " tables";
+        break;
     }
   }
-  PROCESS_SWITCH(tofPidMerge, processRun3, "Produce Run 3 Nsigma table. Set to off if the tables are not required, or autoset is on", false);
 
-  template <o2::track::PID::ID pid>
-  using ResponseImplementationRun2 = o2::pid::tof::ExpTimes<Run2TrksWtofWevTime::iterator, pid>;
-  void processRun2(Run2TrksWtofWevTime const& tracks,
-                   aod::Collisions const& collisions,
-                   aod::BCsWithTimestamps const& bcs)
+  // Computes the response for all the enabled hypotheses of each track at once and fills the tiny and full tables
+  template <typename TrackType, typename TracksType>
+  void makePidTables(TracksType const& tracks, aod::Collisions const& collisions)
   {
-    constexpr auto responseEl = ResponseImplementationRun2<PID::Electron>();
-    constexpr auto responseMu = ResponseImplementationRun2<PID::Muon>();
-    constexpr auto responsePi = ResponseImplementationRun2<PID::Pion>();
-    constexpr auto responseKa = ResponseImplementationRun2<PID::Kaon>();
-    constexpr auto responsePr = ResponseImplementationRun2<PID::Proton>();
-    constexpr auto responseDe = ResponseImplementationRun2<PID::Deuteron>();
-    constexpr auto responseTr = ResponseImplementationRun2<PID::Triton>();
-    constexpr auto responseHe = ResponseImplementationRun2<PID::Helium3>();
-    constexpr auto responseAl = ResponseImplementationRun2<PID::Alpha>();
-
-    tofResponse->processSetup(bcs.iteratorAt(0)); // Update the calibration parameters
-
     for (auto const& pidId : mEnabledParticles) {
       reserveTable(pidId, tracks.size(), false);
     }
@@ -1066,8 +961,8 @@ struct tofPidMerge {
       reserveTable(pidId, tracks.size(), true);
     }
 
-    float resolution = 1.f; // Last resolution assigned
-    float nsigma = 0;
+    std::array<float, nSpecies> expSigma{};
+    std::array<float, nSpecies> nSigma{};
     for (auto const& trk : tracks) {                        // Loop on all tracks
       if (!trk.has_collision() || collisions.size() == 0) { // Track was not assigned, cannot compute NSigma (no event time) -> filling with empty table
         for (auto const& pidId : mEnabledParticles) {
@@ -1079,127 +974,42 @@ struct tofPidMerge {
         continue;
       }
 
+      o2::pid::tof::ExpTimesAllHypotheses<TrackType>::GetExpectedSigmaAndSeparation(tofResponse->parameters, trk, mEnabledHypotheses, expSigma, nSigma);
       for (auto const& pidId : mEnabledParticles) { // Loop on enabled particle hypotheses
-        switch (pidId) {
-          case kIdxEl: {
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDEl);
-            break;
-          }
-          case kIdxMu: {
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDMu);
-            break;
-          }
-          case kIdxPi: {
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPi);
-            break;
-          }
-          case kIdxKa: {
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDKa);
-            break;
-          }
-          case kIdxPr: {
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDPr);
-            break;
-          }
-          case kIdxDe: {
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDDe);
-            break;
-          }
-          case kIdxTr: {
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDTr);
-            break;
-          }
-          case kIdxHe: {
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDHe);
-            break;
-          }
-          case kIdxAl: {
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk);
-            aod::pidtof_tiny::binning::packInTable(nsigma, tablePIDAl);
-            break;
-          }
-          default:
-            LOG(fatal) << "Wrong particle ID for standard tables";
-            break;
-        }
+        fillTable(pidId, false, expSigma[pidId], nSigma[pidId]);
         if (enableQaHistograms) {
-          hnsigma[pidId]->Fill(trk.p(), nsigma);
+          hnsigma[pidId]->Fill(trk.p(), nSigma[pidId]);
         }
       }
       for (auto const& pidId : mEnabledParticlesFull) { // Loop on enabled particle hypotheses with full tables
-        switch (pidId) {
-          case kIdxEl: {
-            resolution = responseEl.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseEl.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullEl(resolution, nsigma);
-            break;
-          }
-          case kIdxMu: {
-            resolution = responseMu.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseMu.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullMu(resolution, nsigma);
-            break;
-          }
-          case kIdxPi: {
-            resolution = responsePi.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePi.GetSeparation(tofResponse->parameters, trk);
-            tablePIDFullPi(resolution, nsigma);
-            break;
-          }
-          case kIdxKa: {
-            resolution = responseKa.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseKa.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullKa(resolution, nsigma);
-            break;
-          }
-          case kIdxPr: {
-            resolution = responsePr.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responsePr.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullPr(resolution, nsigma);
-            break;
-          }
-          case kIdxDe: {
-            resolution = responseDe.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseDe.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullDe(resolution, nsigma);
-            break;
-          }
-          case kIdxTr: {
-            resolution = responseTr.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseTr.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullTr(resolution, nsigma);
-            break;
-          }
-          case kIdxHe: {
-            resolution = responseHe.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseHe.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullHe(resolution, nsigma);
-            break;
-          }
-          case kIdxAl: {
-            resolution = responseAl.GetExpectedSigma(tofResponse->parameters, trk);
-            nsigma = responseAl.GetSeparation(tofResponse->parameters, trk, resolution);
-            tablePIDFullAl(resolution, nsigma);
-            break;
-          }
-          default:
-            LOG(fatal) << "Wrong particle ID for full tables";
-            break;
-        }
+        fillTable(pidId, true, expSigma[pidId], nSigma[pidId]);
         if (enableQaHistograms) {
-          hnsigmaFull[pidId]->Fill(trk.p(), nsigma);
+          hnsigmaFull[pidId]->Fill(trk.p(), nSigma[pidId]);
         }
       }
     }
   }
+
+  void process(aod::BCs const&) {}
+
+  void processRun3(Run3TrksWtofWevTime const& tracks,
+                   aod::Collisions const& collisions,
+                   aod::BCsWithTimestamps const& bcs)
+  {
+    tofResponse->processSetup(bcs.iteratorAt(0)); // Update the calibration parameters
+
+    makePidTables<Run3TrksWtofWevTime::iterator>(tracks, collisions);
+  }
+  PROCESS_SWITCH(tofPidMerge, processRun3, "Produce Run 3 Nsigma table. Set to off if the tables are not required, or autoset is on", false);
+
+  void processRun2(Run2TrksWtofWevTime const& tracks,
+                   aod::Collisions const& collisions,
+                   aod::BCsWithTimestamps const& bcs)
+  {
+    tofResponse->processSetup(bcs.iteratorAt(0)); // Update the calibration parameters
+
+    makePidTables<Run2TrksWtofWevTime::iterator>(tracks, collisions);
+  }
   PROCESS_SWITCH(tofPidMerge, processRun2, "Produce Run 2 Nsigma table. Set to off if the tables are not required, or autoset is on", false);
 
   o2::pid::tof::Beta responseBetaRun2;
@@ -43,11 +43,13 @@
 #include <Framework/RunningWorkflowInfo.h>
 #include <Framework/runDataProcessing.h>
 
+#include <TAxis.h>
 #include <TComplex.h>
 #include <TH3.h>
 #include <TProfile3D.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstddef>
@@ -82,6 +84,15 @@ struct QVectorsTable {
     kRescale,
     kNCorrections
   };
+  enum CorrCoeffs {
+    kRecenterX = 0,
+    kRecenterY,
+    kTwistLp,
+    kTwistLm,
+    kRescaleAp,
+    kRescaleAm,
+    kNCorrCoeffs
+  };
   enum MultNorms {
     kNoNorm = 0,
     kScalarProd,
@@ -182,10 +193,35 @@ struct QVectorsTable {
   const int nShiftIndex = 10;
   const float trackEtaMin = 0.1;
 
-  std::vector<TH3F*> corrsQvecSp{};
-  std::vector<TH3F*> corrsQvecEse{};
-  std::vector<TProfile3D*> shiftProfileSp{};
-  std::vector<TProfile3D*> shiftProfileEse{};
+  /// Recentering, twist and rescale constants of one harmonic, flattened at run change
+  /// and indexed as [centrality bin][detector][coefficient]
+  struct QVecCorrTable {
+    int nCentBins{0};
+    std::vector<float> coeffs{};
+
+    const float* at(float centrality) const
+    {
+      return coeffs.data() + static_cast<std::size_t>(std::min(static_cast<int>(centrality), nCentBins - 1)) * kNDetectors * kNCorrCoeffs;
+    }
+  };
+
+  /// Shift correction coefficients of one harmonic, flattened at run change
+  /// and indexed as [centrality bin][detector][x/y][shift index]
+  struct ShiftCorrTable {
+    TAxis centAxis{};
+    int nShifts{0};
+    std::vector<double> coeffs{};
+
+    const double* at(float centrality) const
+    {
+      return coeffs.data() + static_cast<std::size_t>(centAxis.FindFixBin(centrality)) * kNDetectors * 2 * nShifts;
+    }
+  };
+
+  std::vector<QVecCorrTable> corrsQvecSp{};
+  std::vector<QVecCorrTable> corrsQvecEse{};
+  std::vector<ShiftCorrTable> shiftProfileSp{};
+  std::vector<ShiftCorrTable> shiftProfileEse{};
 
   // Deprecated, will be removed in future after transition time //
   Configurable<bool> cfgUseBPos{"cfgUseBPos", false, "Initial value for using BPos. By default obtained from DataModel."};
@@ -263,6 +299,50 @@ struct QVectorsTable {
     histosQA.add("FV0AmpCor", "", {HistType::kTH2F, {axisFITamp, axisChID}});
   }
 
+  /// Function to copy the correction constants of one harmonic into a contiguous table
+  /// \param histsCorrs is the histogram with the correction constants for each detector and correction step
+  /// \return the correction constants for each centrality bin, detector and coefficient
+  QVecCorrTable flattenQVecCorr(TH3F* histsCorrs)
+  {
+    QVecCorrTable table;
+    table.nCentBins = static_cast<int>(cfgMaxCentrality) + 1;
+    table.coeffs.resize(static_cast<std::size_t>(table.nCentBins) * kNDetectors * kNCorrCoeffs);
+    auto* coeff = table.coeffs.data();
+    for (int iCent = 0; iCent < table.nCentBins; iCent++) {
+      for (int iDet = 0; iDet < kNDetectors; iDet++) {
+        for (int iCoeff = 0; iCoeff < kNCorrCoeffs; iCoeff++) {
+          *coeff++ = histsCorrs->GetBinContent(iCent + 1, iCoeff + 1, iDet + 1);
+        }
+      }
+    }
+    return table;
+  }
+
+  /// Function to copy the shift correction coefficients of one harmonic into a contiguous table
+  /// \param shiftProfile is the profile with the shift coefficients for each detector and shift index
+  /// \return the shift coefficients for each centrality bin (including under- and overflow), detector and shift index
+  ShiftCorrTable flattenShiftCorr(TProfile3D* shiftProfile)
+  {
+    ShiftCorrTable table;
+    table.centAxis = *shiftProfile->GetXaxis();
+    table.nShifts = nShiftIndex;
+    const int nCentBins = table.centAxis.GetNbins() + 2;
+    table.coeffs.resize(static_cast<std::size_t>(nCentBins) * kNDetectors * 2 * nShiftIndex);
+    auto* coeff = table.coeffs.data();
+    for (int iCent = 0; iCent < nCentBins; iCent++) {
+      for (int iDet = 0; iDet < kNDetectors; iDet++) {
+        for (int iComp = 0; iComp < 2; iComp++) {
+          const int binY = shiftProfile->GetYaxis()->FindFixBin(2 * iDet + iComp);
+          for (int iShift = 1; iShift <= nShiftIndex; iShift++) {
+            const int binZ = shiftProfile->GetZaxis()->FindFixBin(iShift - 0.5);
+            *coeff++ = shiftProfile->GetBinContent(shiftProfile->GetBin(iCent, binY, binZ));
+          }
+        }
+      }
+    }
+    return table;
+  }
+
   void initCCDB(aod::BCsWithTimestamps::iterator const& bc)
   {
     ft0RelGainConst.clear();
@@ -308,7 +388,7 @@ struct QVectorsTable {
         LOGF(info, "Could not get the correction histograms for Q-vectors for mode %d. Setting to no correction.", ind);
         modeCorrQvecSp = new TH3F("modeCorrQvecSp", "modeCorrQvecSp", 1, 0, 1, 1, 0, 1, 1, 0, 1);
       }
-      corrsQvecSp.push_back(modeCorrQvecSp);
+      corrsQvecSp.push_back(flattenQVecCorr(modeCorrQvecSp));
     }
 
     if (cfgProduceRedQVecs) {
@@ -328,7 +408,7 @@ struct QVectorsTable {
           LOGF(info, "Could not get the correction histograms for Q-vectors for mode %d. Setting to no correction.", ind);
           modeCorrQvecEse = new TH3F("modeCorrQvecEse", "modeCorrQvecEse", 1, 0, 1, 1, 0, 1, 1, 0, 1);
         }
-        corrsQvecEse.push_back(modeCorrQvecEse);
+        corrsQvecEse.push_back(flattenQVecCorr(modeCorrQvecEse));
       }
     }
 
@@ -344,7 +424,7 @@ struct QVectorsTable {
           LOGF(info, "Could not get the shift profile for Q-vectors for mode %d. Setting to no shift correction.", ind);
           objshift = new TProfile3D("shiftProfileSp", "shiftProfileSp", 1, 0, 1, 1, 0, 1, 1, 0, 1);
         }
-        shiftProfileSp.push_back(objshift);
+        shiftProfileSp.push_back(flattenShiftCorr(objshift));
       }
 
       if (cfgProduceRedQVecs) {
@@ -359,7 +439,7 @@ struct QVectorsTable {
             LOGF(info, "Could not get the shift profile for Q-vectors for mode %d. Setting to no shift correction.", ind);
             objshift = new TProfile3D("shiftProfileEse", "shiftProfileEse", 1, 0, 1, 1, 0, 1, 1, 0, 1);
           }
-          shiftProfileEse.push_back(objshift);
+          shiftProfileEse.push_back(flattenShiftCorr(objshift));
         }
       }
     }
@@ -471,108 +551,46 @@ struct QVectorsTable {
   /// \param centrality is the collision centrality
   /// \param qVecRe is the vector with the real part of the q-vector for each detector and correction step
   /// \param qVecIm is the vector with the imaginary part of the q-vector for each detector and correction step
-  /// \param histsCorrs is the vector with the histograms with the correction constants for each detector and correction step
+  /// \param corrs is the table with the correction constants for each centrality bin, detector and correction step
+  /// \param shiftCorrs is the vector with the tables of shift coefficients for each harmonic
   /// \param nMode is the modulation of interest
-  void correctQVec(float centrality, std::vector<float>& qVecRe, std::vector<float>& qVecIm, TH3F* histsCorrs, std::vector<TProfile3D*>& shiftProfile, int nMode)
+  void correctQVec(float centrality, std::vector<float>& qVecRe, std::vector<float>& qVecIm, QVecCorrTable const& corrs, std::vector<ShiftCorrTable> const& shiftCorrs, int nMode)
   {
     int nCorrections = static_cast<int>(kNCorrections);
     if (centrality < cfgMaxCentrality) {
-      for (auto i{0u}; i < kTPCAll + 1; i++) {
+      const float* coeffsCent = corrs.at(centrality);
+      for (int i = 0; i < kNDetectors; i++) {
         int idxDet = i * kNCorrections;
-        helperEP.DoRecenter(qVecRe[idxDet + kRecenter], qVecIm[idxDet + kRecenter],
-                            histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 2, i + 1));
-
-        helperEP.DoRecenter(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist],
-                            histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 2, i + 1));
-        helperEP.DoTwist(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist],
-                         histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 3, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 4, i + 1));
-
-        helperEP.DoRecenter(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                            histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 2, i + 1));
-        helperEP.DoTwist(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                         histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 3, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 4, i + 1));
-        helperEP.DoRescale(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                           histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 5, i + 1), histsCorrs->GetBinContent(static_cast<int>(centrality) + 1, 6, i + 1));
+        const float* coeffs = coeffsCent + i * kNCorrCoeffs;
+        helperEP.DoRecenter(qVecRe[idxDet + kRecenter], qVecIm[idxDet + kRecenter], coeffs[kRecenterX], coeffs[kRecenterY]);
+
+        helperEP.DoRecenter(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist], coeffs[kRecenterX], coeffs[kRecenterY]);
+        helperEP.DoTwist(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist], coeffs[kTwistLp], coeffs[kTwistLm]);
+
+        helperEP.DoRecenter(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale], coeffs[kRecenterX], coeffs[kRecenterY]);
+        helperEP.DoTwist(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale], coeffs[kTwistLp], coeffs[kTwistLm]);
+        helperEP.DoRescale(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale], coeffs[kRescaleAp], coeffs[kRescaleAm]);
       }
       if (cfgShiftCorr) {
-        auto deltaPsiFT0C = 0.0;
-        auto deltaPsiFT0A = 0.0;
-        auto deltaPsiFT0M = 0.0;
-        auto deltaPsiFV0A = 0.0;
-        auto deltaPsiTPCPos = 0.0;
-        auto deltaPsiTPCNeg = 0.0;
-        auto deltaPsiTPCAll = 0.0;
-
-        auto psiDefFT0C = std::atan2(qVecIm[kFT0C * nCorrections + kRescale], qVecRe[kFT0C * nCorrections + kRescale]) / static_cast<float>(nMode);
-        auto psiDefFT0A = std::atan2(qVecIm[kFT0A * nCorrections + kRescale], qVecRe[kFT0A * nCorrections + kRescale]) / static_cast<float>(nMode);
-        auto psiDefFT0M = std::atan2(qVecIm[kFT0M * nCorrections + kRescale], qVecRe[kFT0M * nCorrections + kRescale]) / static_cast<float>(nMode);
-        auto psiDefFV0A = std::atan2(qVecIm[kFV0A * nCorrections + kRescale], qVecRe[kFV0A * nCorrections + kRescale]) / static_cast<float>(nMode);
-        auto psiDefTPCPos = std::atan2(qVecIm[kTPCPos * nCorrections + kRescale], qVecRe[kTPCPos * nCorrections + kRescale]) / static_cast<float>(nMode);
-        auto psiDefTPCNeg = std::atan2(qVecIm[kTPCNeg * nCorrections + kRescale], qVecRe[kTPCNeg * nCorrections + kRescale]) / static_cast<float>(nMode);
-        auto psiDefTPCAll = std::atan2(qVecIm[kTPCAll * nCorrections + kRescale], qVecRe[kTPCAll * nCorrections + kRescale]) / static_cast<float>(nMode);
-
-        for (int iShift = 1; iShift <= nShiftIndex; iShift++) {
-          auto coeffShiftXFT0C = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFT0C, iShift - 0.5));
-          auto coeffShiftYFT0C = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFT0C + 1, iShift - 0.5));
-          auto coeffShiftXFT0A = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFT0A, iShift - 0.5));
-          auto coeffShiftYFT0A = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFT0A + 1, iShift - 0.5));
-          auto coeffShiftXFT0M = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFT0M, iShift - 0.5));
-          auto coeffShiftYFT0M = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFT0M + 1, iShift - 0.5));
-          auto coeffShiftXFV0A = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFV0A, iShift - 0.5));
-          auto coeffShiftYFV0A = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kFV0A + 1, iShift - 0.5));
-          auto coeffShiftXTPCPos = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kTPCPos, iShift - 0.5));
-          auto coeffShiftYTPCPos = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kTPCPos + 1, iShift - 0.5));
-          auto coeffShiftXTPCNeg = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kTPCNeg, iShift - 0.5));
-          auto coeffShiftYTPCNeg = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kTPCNeg + 1, iShift - 0.5));
-          auto coeffShiftXTPCAll = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kTPCAll, iShift - 0.5));
-          auto coeffShiftYTPCAll = shiftProfile.at(nMode - 2)->GetBinContent(shiftProfile.at(nMode - 2)->FindBin(centrality, 2 * kTPCAll + 1, iShift - 0.5));
-
-          deltaPsiFT0C += ((2. / (1.0 * iShift)) * (-coeffShiftXFT0C * std::cos(iShift * static_cast<float>(nMode) * psiDefFT0C) + coeffShiftYFT0C * std::sin(iShift * static_cast<float>(nMode) * psiDefFT0C))) / static_cast<float>(nMode);
-          deltaPsiFT0A += ((2. / (1.0 * iShift)) * (-coeffShiftXFT0A * std::cos(iShift * static_cast<float>(nMode) * psiDefFT0A) + coeffShiftYFT0A * std::sin(iShift * static_cast<float>(nMode) * psiDefFT0A))) / static_cast<float>(nMode);
-          deltaPsiFT0M += ((2. / (1.0 * iShift)) * (-coeffShiftXFT0M * std::cos(iShift * static_cast<float>(nMode) * psiDefFT0M) + coeffShiftYFT0M * std::sin(iShift * static_cast<float>(nMode) * psiDefFT0M))) / static_cast<float>(nMode);
-          deltaPsiFV0A += ((2. / (1.0 * iShift)) * (-coeffShiftXFV0A * std::cos(iShift * static_cast<float>(nMode) * psiDefFV0A) + coeffShiftYFV0A * std::sin(iShift * static_cast<float>(nMode) * psiDefFV0A))) / static_cast<float>(nMode);
-          deltaPsiTPCPos += ((2. / (1.0 * iShift)) * (-coeffShiftXTPCPos * std::cos(iShift * static_cast<float>(nMode) * psiDefTPCPos) + coeffShiftYTPCPos * std::sin(iShift * static_cast<float>(nMode) * psiDefTPCPos))) / static_cast<float>(nMode);
-          deltaPsiTPCNeg += ((2. / (1.0 * iShift)) * (-coeffShiftXTPCNeg * std::cos(iShift * static_cast<float>(nMode) * psiDefTPCNeg) + coeffShiftYTPCNeg * std::sin(iShift * static_cast<float>(nMode) * psiDefTPCNeg))) / static_cast<float>(nMode);
-          deltaPsiTPCAll += ((2. / (1.0 * iShift)) * (-coeffShiftXTPCAll * std::cos(iShift * static_cast<float>(nMode) * psiDefTPCAll) + coeffShiftYTPCAll * std::sin(iShift * static_cast<float>(nMode) * psiDefTPCAll))) / static_cast<float>(nMode);
-        }
+        const auto& shiftCorr = shiftCorrs.at(nMode - 2);
+        const double* coeffsShiftCent = shiftCorr.at(centrality);
+        for (int i = 0; i < kNDetectors; i++) {
+          int idxRescale = i * nCorrections + kRescale;
+          const double* coeffShiftX = coeffsShiftCent + (2 * i) * shiftCorr.nShifts;
+          const double* coeffShiftY = coeffShiftX + shiftCorr.nShifts;
+
+          auto deltaPsi = 0.0;
+          auto psiDef = std::atan2(qVecIm[idxRescale], qVecRe[idxRescale]) / static_cast<float>(nMode);
+          for (int iShift = 1; iShift <= nShiftIndex; iShift++) {
+            deltaPsi += ((2. / (1.0 * iShift)) * (-coeffShiftX[iShift - 1] * std::cos(iShift * static_cast<float>(nMode) * psiDef) + coeffShiftY[iShift - 1] * std::sin(iShift * static_cast<float>(nMode) * psiDef))) / static_cast<float>(nMode);
+          }
+          deltaPsi *= static_cast<float>(nMode);
 
-        deltaPsiFT0C *= static_cast<float>(nMode);
-        deltaPsiFT0A *= static_cast<float>(nMode);
-        deltaPsiFT0M *= static_cast<float>(nMode);
-        deltaPsiFV0A *= static_cast<float>(nMode);
-        deltaPsiTPCPos *= static_cast<float>(nMode);
-        deltaPsiTPCNeg *= static_cast<float>(nMode);
-        deltaPsiTPCAll *= static_cast<float>(nMode);
-
-        float qVecReShiftedFT0C = qVecRe[kFT0C * nCorrections + kRescale] * std::cos(deltaPsiFT0C) - qVecIm[kFT0C * nCorrections + kRescale] * std::sin(deltaPsiFT0C);
-        float qVecImShiftedFT0C = qVecRe[kFT0C * nCorrections + kRescale] * std::sin(deltaPsiFT0C) + qVecIm[kFT0C * nCorrections + kRescale] * std::cos(deltaPsiFT0C);
-        float qVecReShiftedFT0A = qVecRe[kFT0A * nCorrections + kRescale] * std::cos(deltaPsiFT0A) - qVecIm[kFT0A * nCorrections + kRescale] * std::sin(deltaPsiFT0A);
-        float qVecImShiftedFT0A = qVecRe[kFT0A * nCorrections + kRescale] * std::sin(deltaPsiFT0A) + qVecIm[kFT0A * nCorrections + kRescale] * std::cos(deltaPsiFT0A);
-        float qVecReShiftedFT0M = qVecRe[kFT0M * nCorrections + kRescale] * std::cos(deltaPsiFT0M) - qVecIm[kFT0M * nCorrections + kRescale] * std::sin(deltaPsiFT0M);
-        float qVecImShiftedFT0M = qVecRe[kFT0M * nCorrections + kRescale] * std::sin(deltaPsiFT0M) + qVecIm[kFT0M * nCorrections + kRescale] * std::cos(deltaPsiFT0M);
-        float qVecReShiftedFV0A = qVecRe[kFV0A * nCorrections + kRescale] * std::cos(deltaPsiFV0A) - qVecIm[kFV0A * nCorrections + kRescale] * std::sin(deltaPsiFV0A);
-        float qVecImShiftedFV0A = qVecRe[kFV0A * nCorrections + kRescale] * std::sin(deltaPsiFV0A) + qVecIm[kFV0A * nCorrections + kRescale] * std::cos(deltaPsiFV0A);
-        float qVecReShiftedTPCPos = qVecRe[kTPCPos * nCorrections + kRescale] * std::cos(deltaPsiTPCPos) - qVecIm[kTPCPos * nCorrections + kRescale] * std::sin(deltaPsiTPCPos);
-        float qVecImShiftedTPCPos = qVecRe[kTPCPos * nCorrections + kRescale] * std::sin(deltaPsiTPCPos) + qVecIm[kTPCPos * nCorrections + kRescale] * std::cos(deltaPsiTPCPos);
-        float qVecReShiftedTPCNeg = qVecRe[kTPCNeg * nCorrections + kRescale] * std::cos(deltaPsiTPCNeg) - qVecIm[kTPCNeg * nCorrections + kRescale] * std::sin(deltaPsiTPCNeg);
-        float qVecImShiftedTPCNeg = qVecRe[kTPCNeg * nCorrections + kRescale] * std::sin(deltaPsiTPCNeg) + qVecIm[kTPCNeg * nCorrections + kRescale] * std::cos(deltaPsiTPCNeg);
-        float qVecReShiftedTPCAll = qVecRe[kTPCAll * nCorrections + kRescale] * std::cos(deltaPsiTPCAll) - qVecIm[kTPCAll * nCorrections + kRescale] * std::sin(deltaPsiTPCAll);
-        float qVecImShiftedTPCAll = qVecRe[kTPCAll * nCorrections + kRescale] * std::sin(deltaPsiTPCAll) + qVecIm[kTPCAll * nCorrections + kRescale] * std::cos(deltaPsiTPCAll);
-
-        qVecRe[kFT0C * nCorrections + kRescale] = qVecReShiftedFT0C;
-        qVecIm[kFT0C * nCorrections + kRescale] = qVecImShiftedFT0C;
-        qVecRe[kFT0A * nCorrections + kRescale] = qVecReShiftedFT0A;
-        qVecIm[kFT0A * nCorrections + kRescale] = qVecImShiftedFT0A;
-        qVecRe[kFT0M * nCorrections + kRescale] = qVecReShiftedFT0M;
-        qVecIm[kFT0M * nCorrections + kRescale] = qVecImShiftedFT0M;
-        qVecRe[kFV0A * nCorrections + kRescale] = qVecReShiftedFV0A;
-        qVecIm[kFV0A * nCorrections + kRescale] = qVecImShiftedFV0A;
-        qVecRe[kTPCPos * nCorrections + kRescale] = qVecReShiftedTPCPos;
-        qVecIm[kTPCPos * nCorrections + kRescale] = qVecImShiftedTPCPos;
-        qVecRe[kTPCNeg * nCorrections + kRescale] = qVecReShiftedTPCNeg;
-        qVecIm[kTPCNeg * nCorrections + kRescale] = qVecImShiftedTPCNeg;
-        qVecRe[kTPCAll * nCorrections + kRescale] = qVecReShiftedTPCAll;
-        qVecIm[kTPCAll * nCorrections + kRescale] = qVecImShiftedTPCAll;
+          float qVecReShifted = qVecRe[idxRescale] * std::cos(deltaPsi) - qVecIm[idxRescale] * std::sin(deltaPsi);
+          float qVecImShifted = qVecRe[idxRescale] * std::sin(deltaPsi) + qVecIm[idxRescale] * std::cos(deltaPsi);
+          qVecRe[idxRescale] = qVecReShifted;
+          qVecIm[idxRescale] = qVecImShifted;
+        }
       }
     }
   }
@@ -29,6 +29,7 @@
 #include <Framework/Logger.h>
 #include <Framework/RunningWorkflowInfo.h>
 
+#include <TAxis.h>
 #include <TFile.h>
 #include <TFormula.h>
 #include <TH1.h>
@@ -36,6 +37,7 @@
 #include <TProfile.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -381,6 +383,48 @@ class MultModule
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::common::multiplicity::standardConfigurables internalOpts;
 
+  //_________________________________________________
+  // flat copy of a 1D calibration histogram, compiled once per run:
+  // get(x) returns the same value as h->GetBinContent(h->FindFixBin(x))
+  // with a direct index for uniform binning and a binary search over the edges otherwise
+  struct CalibrationLookup {
+    int nBins = 0;
+    double xMin = 0.0;
+    double xMax = 0.0;
+    std::vector<double> edges;    // bin edges, empty for uniform binning
+    std::vector<double> contents; // bin contents, including underflow and overflow
+
+    void compile(const TH1* h)
+    {
+      const TAxis* axis = h->GetXaxis();
+      nBins = axis->GetNbins();
+      xMin = axis->GetXmin();
+      xMax = axis->GetXmax();
+      edges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->GetSize());
+      }
+      contents.resize(nBins + 2);
+      for (int i = 0; i < nBins + 2; i++) {
+        contents[i] = h->GetBinContent(i);
+      }
+    }
+    double get(double x) const
+    {
+      int bin = 0;
+      if (x < xMin) {
+        bin = 0;
+      } else if (!(x < xMax)) { // also catches NaN, as TAxis::FindFixBin
+        bin = nBins + 1;
+      } else if (edges.empty()) {
+        bin = 1 + static_cast<int>(nBins * (x - xMin) / (xMax - xMin));
+      } else {
+        bin = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      }
+      return contents[bin];
+    }
+  };
+
   //_________________________________________________
   // centrality-related objects
   struct TagRun2V0MCalibration {
@@ -390,37 +434,52 @@ class MultModule
     TH1* mhVtxAmpCorrV0A = nullptr;
     TH1* mhVtxAmpCorrV0C = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorrV0A;
+    CalibrationLookup mVtxAmpCorrV0C;
+    CalibrationLookup mMultSelCalib;
   } Run2V0MInfo;
   struct TagRun2V0ACalibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorrV0A = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorrV0A;
+    CalibrationLookup mMultSelCalib;
   } Run2V0AInfo;
   struct TagRun2SPDTrackletsCalibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorr = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorr;
+    CalibrationLookup mMultSelCalib;
   } Run2SPDTksInfo;
   struct TagRun2SPDClustersCalibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorrCL0 = nullptr;
     TH1* mhVtxAmpCorrCL1 = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorrCL0;
+    CalibrationLookup mVtxAmpCorrCL1;
+    CalibrationLookup mMultSelCalib;
   } Run2SPDClsInfo;
   struct TagRun2CL0Calibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorr = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorr;
+    CalibrationLookup mMultSelCalib;
   } Run2CL0Info;
   struct TagRun2CL1Calibration {
     bool mCalibrationStored = false;
     TH1* mhVtxAmpCorr = nullptr;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mVtxAmpCorr;
+    CalibrationLookup mMultSelCalib;
   } Run2CL1Info;
   struct CalibrationInfo {
     std::string name = "";
     bool mCalibrationStored = false;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationLookup mMultSelCalibLookup;
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
     explicit CalibrationInfo(std::string name)
@@ -1106,6 +1165,9 @@ class MultModule
                 LOGF(info, "MC Scale information from V0M for run %d not available", bc.runNumber());
               }
             }
+            Run2V0MInfo.mVtxAmpCorrV0A.compile(Run2V0MInfo.mhVtxAmpCorrV0A);
+            Run2V0MInfo.mVtxAmpCorrV0C.compile(Run2V0MInfo.mhVtxAmpCorrV0C);
+            Run2V0MInfo.mMultSelCalib.compile(Run2V0MInfo.mhMultSelCalib);
             Run2V0MInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1117,6 +1179,8 @@ class MultModule
           Run2V0AInfo.mhVtxAmpCorrV0A = getccdb("hVtx_fAmplitude_V0A_Normalized");
           Run2V0AInfo.mhMultSelCalib = getccdb("hMultSelCalib_V0A");
           if ((Run2V0AInfo.mhVtxAmpCorrV0A != nullptr) && (Run2V0AInfo.mhMultSelCalib != nullptr)) {
+            Run2V0AInfo.mVtxAmpCorrV0A.compile(Run2V0AInfo.mhVtxAmpCorrV0A);
+            Run2V0AInfo.mMultSelCalib.compile(Run2V0AInfo.mhMultSelCalib);
             Run2V0AInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1128,6 +1192,8 @@ class MultModule
           Run2SPDTksInfo.mhVtxAmpCorr = getccdb("hVtx_fnTracklets_Normalized");
           Run2SPDTksInfo.mhMultSelCalib = getccdb("hMultSelCalib_SPDTracklets");
           if ((Run2SPDTksInfo.mhVtxAmpCorr != nullptr) && (Run2SPDTksInfo.mhMultSelCalib != nullptr)) {
+            Run2SPDTksInfo.mVtxAmpCorr.compile(Run2SPDTksInfo.mhVtxAmpCorr);
+            Run2SPDTksInfo.mMultSelCalib.compile(Run2SPDTksInfo.mhMultSelCalib);
             Run2SPDTksInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1140,6 +1206,9 @@ class MultModule
           Run2SPDClsInfo.mhVtxAmpCorrCL1 = getccdb("hVtx_fnSPDClusters1_Normalized");
           Run2SPDClsInfo.mhMultSelCalib = getccdb("hMultSelCalib_SPDClusters");
           if ((Run2SPDClsInfo.mhVtxAmpCorrCL0 != nullptr) && (Run2SPDClsInfo.mhVtxAmpCorrCL1 != nullptr) && (Run2SPDClsInfo.mhMultSelCalib != nullptr)) {
+            Run2SPDClsInfo.mVtxAmpCorrCL0.compile(Run2SPDClsInfo.mhVtxAmpCorrCL0);
+            Run2SPDClsInfo.mVtxAmpCorrCL1.compile(Run2SPDClsInfo.mhVtxAmpCorrCL1);
+            Run2SPDClsInfo.mMultSelCalib.compile(Run2SPDClsInfo.mhMultSelCalib);
             Run2SPDClsInfo.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1151,6 +1220,8 @@ class MultModule
           Run2CL0Info.mhVtxAmpCorr = getccdb("hVtx_fnSPDClusters0_Normalized");
           Run2CL0Info.mhMultSelCalib = getccdb("hMultSelCalib_CL0");
           if ((Run2CL0Info.mhVtxAmpCorr != nullptr) && (Run2CL0Info.mhMultSelCalib != nullptr)) {
+            Run2CL0Info.mVtxAmpCorr.compile(Run2CL0Info.mhVtxAmpCorr);
+            Run2CL0Info.mMultSelCalib.compile(Run2CL0Info.mhMultSelCalib);
             Run2CL0Info.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1162,6 +1233,8 @@ class MultModule
           Run2CL1Info.mhVtxAmpCorr = getccdb("hVtx_fnSPDClusters1_Normalized");
           Run2CL1Info.mhMultSelCalib = getccdb("hMultSelCalib_CL1");
           if ((Run2CL1Info.mhVtxAmpCorr != nullptr) && (Run2CL1Info.mhMultSelCalib != nullptr)) {
+            Run2CL1Info.mVtxAmpCorr.compile(Run2CL1Info.mhVtxAmpCorr);
+            Run2CL1Info.mMultSelCalib.compile(Run2CL1Info.mhMultSelCalib);
             Run2CL1Info.mCalibrationStored = true;
           } else {
             // continue filling with non-valid values (105)
@@ -1249,6 +1322,7 @@ class MultModule
                 LOGF(warning, "MC Scale information from %s for run %d not available", estimator.name.c_str(), bc.runNumber());
               }
             }
+            estimator.mMultSelCalibLookup.compile(estimator.mhMultSelCalib);
             estimator.mCalibrationStored = true;
             estimator.isSane();
           } else {
@@ -1333,7 +1407,7 @@ class MultModule
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.mMultSelCalibLookup.get(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
@@ -1342,34 +1416,37 @@ class MultModule
         return percentile;
       };
 
-      // populate centralities per event
-      for (size_t iEv = 0; iEv < mults.size(); iEv++) {
-        bool isInelGt0 = (mults[iEv].multNContribsEta1 > 0);
-        if (internalOpts.mEnabledTables[kCentFV0As])
-          populateTable(cursors.centFV0A, fv0aInfo, mults[iEv].multFV0AZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Ms])
-          populateTable(cursors.centFT0M, ft0mInfo, mults[iEv].multFT0AZeq + mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Ms])
-          populateTable(cursors.centFT0MAnchorCol, ft0mColInfo, mults[iEv].multFT0AZeq + mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Ms])
-          populateTable(cursors.centFT0MAnchorBC, ft0mBcInfo, mults[iEv].multFT0AZeq + mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0As])
-          populateTable(cursors.centFT0A, ft0aInfo, mults[iEv].multFT0AZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0Cs])
-          populateTable(cursors.centFT0C, ft0cInfo, mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0CVariant1s])
-          populateTable(cursors.centFT0CVariant1, ft0cVariant1Info, mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFT0CVariant2s])
-          populateTable(cursors.centFT0CVariant2, ft0cVariant2Info, mults[iEv].multFT0CZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentFDDMs])
-          populateTable(cursors.centFDDM, fddmInfo, mults[iEv].multFDDAZeq + mults[iEv].multFDDCZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentNTPVs])
-          populateTable(cursors.centNTPV, ntpvInfo, mults[iEv].multNContribs, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentNGlobals])
-          populateTable(cursors.centNGlobals, nGlobalInfo, mults[iEv].multGlobalTracksZeq, isInelGt0);
-        if (internalOpts.mEnabledTables[kCentMFTs])
-          populateTable(cursors.centMFTs, mftInfo, mults[iEv].multMFTTracksZeq, isInelGt0);
-      }
+      // populate centralities per event, one estimator at a time over all collisions
+      auto populateColumn = [&](auto& table, struct CalibrationInfo& estimator, auto getMultiplicity) {
+        for (size_t iEv = 0; iEv < mults.size(); iEv++) {
+          bool isInelGt0 = (mults[iEv].multNContribsEta1 > 0);
+          populateTable(table, estimator, getMultiplicity(mults[iEv]), isInelGt0);
+        }
+      };
+      if (internalOpts.mEnabledTables[kCentFV0As])
+        populateColumn(cursors.centFV0A, fv0aInfo, [](auto const& mult) { return mult.multFV0AZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Ms])
+        populateColumn(cursors.centFT0M, ft0mInfo, [](auto const& mult) { return mult.multFT0AZeq + mult.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Ms])
+        populateColumn(cursors.centFT0MAnchorCol, ft0mColInfo, [](auto const& mult) { return mult.multFT0AZeq + mult.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Ms])
+        populateColumn(cursors.centFT0MAnchorBC, ft0mBcInfo, [](auto const& mult) { return mult.multFT0AZeq + mult.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0As])
+        populateColumn(cursors.centFT0A, ft0aInfo, [](auto const& mult) { return mult.multFT0AZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0Cs])
+        populateColumn(cursors.centFT0C, ft0cInfo, [](auto const& mult) { return mult.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0CVariant1s])
+        populateColumn(cursors.centFT0CVariant1, ft0cVariant1Info, [](auto const& mult) { return mult.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFT0CVariant2s])
+        populateColumn(cursors.centFT0CVariant2, ft0cVariant2Info, [](auto const& mult) { return mult.multFT0CZeq; });
+      if (internalOpts.mEnabledTables[kCentFDDMs])
+        populateColumn(cursors.centFDDM, fddmInfo, [](auto const& mult) { return mult.multFDDAZeq + mult.multFDDCZeq; });
+      if (internalOpts.mEnabledTables[kCentNTPVs])
+        populateColumn(cursors.centNTPV, ntpvInfo, [](auto const& mult) { return mult.multNContribs; });
+      if (internalOpts.mEnabledTables[kCentNGlobals])
+        populateColumn(cursors.centNGlobals, nGlobalInfo, [](auto const& mult) { return mult.multGlobalTracksZeq; });
+      if (internalOpts.mEnabledTables[kCentMFTs])
+        populateColumn(cursors.centMFTs, mftInfo, [](auto const& mult) { return mult.multMFTTracksZeq; });
 
       // populate centralities per BC
       for (size_t ibc = 0; ibc < static_cast<size_t>(bcs.size()); ibc++) {
@@ -1431,10 +1508,10 @@ class MultModule
               v0m = scaleMC(mults[iEv].multFV0A + mults[iEv].multFV0C, Run2V0MInfo.mMCScalePars);
               LOGF(debug, "Unscaled v0m: %f, scaled v0m: %f", mults[iEv].multFV0A + mults[iEv].multFV0C, v0m);
             } else {
-              v0m = mults[iEv].multFV0A * Run2V0MInfo.mhVtxAmpCorrV0A->GetBinContent(Run2V0MInfo.mhVtxAmpCorrV0A->FindFixBin(mults[iEv].posZ)) +
-                    mults[iEv].multFV0C * Run2V0MInfo.mhVtxAmpCorrV0C->GetBinContent(Run2V0MInfo.mhVtxAmpCorrV0C->FindFixBin(mults[iEv].posZ));
+              v0m = mults[iEv].multFV0A * Run2V0MInfo.mVtxAmpCorrV0A.get(mults[iEv].posZ) +
+                    mults[iEv].multFV0C * Run2V0MInfo.mVtxAmpCorrV0C.get(mults[iEv].posZ);
             }
-            cV0M = Run2V0MInfo.mhMultSelCalib->GetBinContent(Run2V0MInfo.mhMultSelCalib->FindFixBin(v0m));
+            cV0M = Run2V0MInfo.mMultSelCalib.get(v0m);
           }
           LOGF(debug, "centRun2V0M=%.0f", cV0M);
           // fill centrality columns
@@ -1443,8 +1520,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2V0As]) {
           float cV0A = 105.0f;
           if (Run2V0AInfo.mCalibrationStored) {
-            float v0a = mults[iEv].multFV0A * Run2V0AInfo.mhVtxAmpCorrV0A->GetBinContent(Run2V0AInfo.mhVtxAmpCorrV0A->FindFixBin(mults[iEv].posZ));
-            cV0A = Run2V0AInfo.mhMultSelCalib->GetBinContent(Run2V0AInfo.mhMultSelCalib->FindFixBin(v0a));
+            float v0a = mults[iEv].multFV0A * Run2V0AInfo.mVtxAmpCorrV0A.get(mults[iEv].posZ);
+            cV0A = Run2V0AInfo.mMultSelCalib.get(v0a);
           }
           LOGF(debug, "centRun2V0A=%.0f", cV0A);
           // fill centrality columns
@@ -1453,8 +1530,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2SPDTrks]) {
           float cSPD = 105.0f;
           if (Run2SPDTksInfo.mCalibrationStored) {
-            float spdm = mults[iEv].multTracklets * Run2SPDTksInfo.mhVtxAmpCorr->GetBinContent(Run2SPDTksInfo.mhVtxAmpCorr->FindFixBin(mults[iEv].posZ));
-            cSPD = Run2SPDTksInfo.mhMultSelCalib->GetBinContent(Run2SPDTksInfo.mhMultSelCalib->FindFixBin(spdm));
+            float spdm = mults[iEv].multTracklets * Run2SPDTksInfo.mVtxAmpCorr.get(mults[iEv].posZ);
+            cSPD = Run2SPDTksInfo.mMultSelCalib.get(spdm);
           }
           LOGF(debug, "centSPDTracklets=%.0f", cSPD);
           cursors.centRun2SPDTracklets(cSPD);
@@ -1462,9 +1539,9 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2SPDClss]) {
           float cSPD = 105.0f;
           if (Run2SPDClsInfo.mCalibrationStored) {
-            float spdm = mults[iEv].spdClustersL0 * Run2SPDClsInfo.mhVtxAmpCorrCL0->GetBinContent(Run2SPDClsInfo.mhVtxAmpCorrCL0->FindFixBin(mults[iEv].posZ)) +
-                         mults[iEv].spdClustersL1 * Run2SPDClsInfo.mhVtxAmpCorrCL1->GetBinContent(Run2SPDClsInfo.mhVtxAmpCorrCL1->FindFixBin(mults[iEv].posZ));
-            cSPD = Run2SPDClsInfo.mhMultSelCalib->GetBinContent(Run2SPDClsInfo.mhMultSelCalib->FindFixBin(spdm));
+            float spdm = mults[iEv].spdClustersL0 * Run2SPDClsInfo.mVtxAmpCorrCL0.get(mults[iEv].posZ) +
+                         mults[iEv].spdClustersL1 * Run2SPDClsInfo.mVtxAmpCorrCL1.get(mults[iEv].posZ);
+            cSPD = Run2SPDClsInfo.mMultSelCalib.get(spdm);
           }
           LOGF(debug, "centSPDClusters=%.0f", cSPD);
           cursors.centRun2SPDClusters(cSPD);
@@ -1472,8 +1549,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2CL0s]) {
           float cCL0 = 105.0f;
           if (Run2CL0Info.mCalibrationStored) {
-            float cl0m = mults[iEv].spdClustersL0 * Run2CL0Info.mhVtxAmpCorr->GetBinContent(Run2CL0Info.mhVtxAmpCorr->FindFixBin(mults[iEv].posZ));
-            cCL0 = Run2CL0Info.mhMultSelCalib->GetBinContent(Run2CL0Info.mhMultSelCalib->FindFixBin(cl0m));
+            float cl0m = mults[iEv].spdClustersL0 * Run2CL0Info.mVtxAmpCorr.get(mults[iEv].posZ);
+            cCL0 = Run2CL0Info.mMultSelCalib.get(cl0m);
           }
           LOGF(debug, "centCL0=%.0f", cCL0);
           cursors.centRun2CL0(cCL0);
@@ -1481,8 +1558,8 @@ class MultModule
         if (internalOpts.mEnabledTables[kCentRun2CL1s]) {
           float cCL1 = 105.0f;
           if (Run2CL1Info.mCalibrationStored) {
-            float cl1m = mults[iEv].spdClustersL1 * Run2CL1Info.mhVtxAmpCorr->GetBinContent(Run2CL1Info.mhVtxAmpCorr->FindFixBin(mults[iEv].posZ));
-            cCL1 = Run2CL1Info.mhMultSelCalib->GetBinContent(Run2CL1Info.mhMultSelCalib->FindFixBin(cl1m));
+            float cl1m = mults[iEv].spdClustersL1 * Run2CL1Info.mVtxAmpCorr.get(mults[iEv].posZ);
+            cCL1 = Run2CL1Info.mMultSelCalib.get(cl1m);
           }
           LOGF(debug, "centCL1=%.0f", cCL1);
           cursors.centRun2CL1(cCL1);
@@ -0,0 +1,149 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkTpcNSigmaBlock.cxx
+/// \brief  exec to time the block evaluation of the TPC PID response against the per-track getters
+///         and to check that both give the same expected signals, resolutions and nsigmas.
+///         Usage: o2-bench-tpc-nsigma-block [number of tracks] [repetitions]
+///
+
+#include "Common/Core/PID/TPCPIDResponse.h"
+
+#include <Framework/Logger.h>
+#include <ReconstructionDataFormats/PID.h>
+
+#include <TRandom3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+using namespace o2;
+
+/// Minimal track with the accessors used by the per-track getters of the response
+struct SyntheticTrack {
+  float mTpcInnerParam;
+  float mTpcSignal;
+  float mTpcNClsFound;
+  float mTgl;
+  float mSigned1Pt;
+  bool mHasTPC;
+  float tpcInnerParam() const { return mTpcInnerParam; }
+  float tpcSignal() const { return mTpcSignal; }
+  float tpcNClsFound() const { return mTpcNClsFound; }
+  float tgl() const { return mTgl; }
+  float signed1Pt() const { return mSigned1Pt; }
+  bool hasTPC() const { return mHasTPC; }
+};
+
+/// Times the per-track and the block evaluation of all species and returns the number of values which differ
+std::size_t process(const o2::pid::tpc::Response& response, const std::vector<SyntheticTrack>& tracks, const std::vector<long>& multTPC, const int repetitions)
+{
+  const std::size_t nTracks = tracks.size();
+  std::vector<o2::track::PID::ID> ids;
+  for (o2::track::PID::ID id = 0; id < o2::track::PID::NIDs; id++) {
+    ids.push_back(id);
+  }
+  const std::size_t nValues = ids.size() * nTracks;
+
+  // per-track path, as pidTPCModule evaluated it before the block kernel
+  std::vector<float> expSignal(nValues), expSigma(nValues), nSigma(nValues);
+  const auto startTrack = std::chrono::steady_clock::now();
+  for (int iRep = 0; iRep < repetitions; iRep++) {
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      const auto& trk = tracks[iTrack];
+      for (std::size_t iId = 0; iId < ids.size(); iId++) {
+        expSignal[iId * nTracks + iTrack] = response.GetExpectedSignal(trk, ids[iId]);
+        expSigma[iId * nTracks + iTrack] = response.GetExpectedSigmaAtMultiplicity(multTPC[iTrack], trk, ids[iId]);
+        nSigma[iId * nTracks + iTrack] = response.GetNumberOfSigmaMCTunedAtMultiplicity(multTPC[iTrack], trk, ids[iId], trk.tpcSignal());
+      }
+    }
+  }
+  const std::chrono::duration<double> timeTrack = std::chrono::steady_clock::now() - startTrack;
+
+  // block path
+  std::vector<float> tpcInnerParam(nTracks), tpcSignal(nTracks), tpcNClsFound(nTracks), tgl(nTracks), signed1Pt(nTracks), mult(nTracks);
+  std::vector<uint8_t> hasTPC(nTracks);
+  for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+    tpcInnerParam[iTrack] = tracks[iTrack].tpcInnerParam();
+    tpcSignal[iTrack] = tracks[iTrack].tpcSignal();
+    tpcNClsFound[iTrack] = tracks[iTrack].tpcNClsFound();
+    tgl[iTrack] = tracks[iTrack].tgl();
+    signed1Pt[iTrack] = tracks[iTrack].signed1Pt();
+    mult[iTrack] = static_cast<float>(multTPC[iTrack]);
+    hasTPC[iTrack] = tracks[iTrack].hasTPC();
+  }
+  const o2::pid::tpc::ResponseColumns columns{tpcInnerParam, tpcSignal, tpcNClsFound, tgl, signed1Pt, mult, hasTPC};
+  std::vector<float> blockExpSignal(nValues), blockExpSigma(nValues), blockNSigma(nValues);
+  const auto startBlock = std::chrono::steady_clock::now();
+  for (int iRep = 0; iRep < repetitions; iRep++) {
+    response.GetNumberOfSigmaBlock(columns, ids, blockExpSignal, blockExpSigma, blockNSigma);
+  }
+  const std::chrono::duration<double> timeBlock = std::chrono::steady_clock::now() - startBlock;
+
+  std::size_t nDifferent = 0;
+  float maxDifference = 0.f;
+  for (std::size_t i = 0; i < nValues; i++) {
+    for (const auto& [a, b] : {std::pair{expSignal[i], blockExpSignal[i]}, std::pair{expSigma[i], blockExpSigma[i]}, std::pair{nSigma[i], blockNSigma[i]}}) {
+      if (a != b && !(std::isnan(a) && std::isnan(b))) {
+        nDifferent++;
+        maxDifference = std::max(maxDifference, std::abs(a - b) / std::max(std::abs(a), 1.f));
+      }
+    }
+  }
+
+  const double nEvaluations = static_cast<double>(repetitions) * nValues;
+  LOGP(info, "{} resolution: per track {:.2f} ns, block {:.2f} ns per track and species, speed-up {:.2f}",
+       response.GetUseDefaultResolutionParam() ? "default" : "full", timeTrack.count() / nEvaluations * 1.e9, timeBlock.count() / nEvaluations * 1.e9, timeTrack.count() / timeBlock.count());
+  LOGP(info, "{} of {} values differ, max. relative difference {}", nDifferent, 3 * nValues, maxDifference);
+  return nDifferent;
+}
+
+int main(int argc, char* argv[])
+{
+  const std::size_t nTracks = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+  const int repetitions = argc > 2 ? std::atoi(argv[2]) : 1000;
+  LOG(info) << "Timing the TPC PID response for " << nTracks << " tracks, " << repetitions << " repetitions";
+
+  // synthetic tracks spanning the momentum and cluster ranges of the data, a few of them without TPC
+  TRandom3 random(1234);
+  std::vector<SyntheticTrack> tracks(nTracks);
+  std::vector<long> multTPC(nTracks);
+  for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+    auto& trk = tracks[iTrack];
+    trk.mTpcInnerParam = std::exp(random.Uniform(std::log(0.1), std::log(20.)));
+    trk.mTpcSignal = random.Uniform(20.f, 400.f);
+    trk.mTpcNClsFound = static_cast<float>(static_cast<int>(random.Uniform(0., 160.)));
+    trk.mTgl = random.Uniform(-1.f, 1.f);
+    trk.mSigned1Pt = (random.Rndm() < 0.5 ? -1.f : 1.f) / std::max(0.1f, trk.mTpcInnerParam * 0.9f);
+    trk.mHasTPC = random.Rndm() > 0.02;
+    multTPC[iTrack] = static_cast<long>(random.Uniform(0., 12000.));
+  }
+
+  o2::pid::tpc::Response response;
+  std::size_t nDifferent = 0;
+  response.SetUseDefaultResolutionParam(true);
+  nDifferent += process(response, tracks, multTPC, repetitions);
+  response.SetUseDefaultResolutionParam(false);
+  nDifferent += process(response, tracks, multTPC, repetitions);
+
+  if (nDifferent > 0) {
+    LOG(fatal) << "The block evaluation of the TPC PID response differs from the per-track evaluation";
+  }
+  LOG(info) << "The block evaluation of the TPC PID response agrees with the per-track evaluation";
+  return 0;
+} // main
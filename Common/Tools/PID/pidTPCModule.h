@@ -46,14 +46,19 @@
 #include <TRandom.h>
 #include <TString.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <map>
 #include <memory>
 #include <ratio>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <math.h>
@@ -105,6 +110,8 @@ struct pidTPCConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<std::string> networkPathCCDB{"networkPathCCDB", "Analysis/PID/TPC/ML", "Path on CCDB"};
   o2::framework::Configurable<bool> enableNetworkOptimizations{"enableNetworkOptimizations", 1, "(bool) If the neural network correction is used, this enables GraphOptimizationLevel::ORT_ENABLE_EXTENDED in the ONNX session"};
   o2::framework::Configurable<int> networkSetNumThreads{"networkSetNumThreads", 0, "Especially important for running on a SLURM cluster. Sets the number of threads used for execution."};
+  o2::framework::Configurable<int> networkNumWorkers{"networkNumWorkers", 1, "Number of worker threads (each with its own ONNX session) evaluating chunks of the network input concurrently"};
+  o2::framework::Configurable<int> networkChunkSize{"networkChunkSize", 0, "Number of (track, mass hypothesis) rows per network evaluation. 0: one evaluation per mass hypothesis"};
   // Configuration flags to include and exclude particle hypotheses
   o2::framework::Configurable<int> savedEdxsCorrected{"savedEdxsCorrected", -1, {"Save table with corrected dE/dx calculated on the spot. 0: off, 1: on, -1: auto"}};
   o2::framework::Configurable<bool> useCorrecteddEdx{"useCorrecteddEdx", false, "(bool) If true, use corrected dEdx value in Nsigma calculation instead of the one in the AO2D"};
@@ -215,6 +222,7 @@ class pidTPCModule
 
   // Network correction for TPC PID response
   ml::OnnxModel network;
+  std::vector<std::unique_ptr<ml::OnnxModel>> networkPool; // additional sessions for networkNumWorkers > 1
   std::map<std::string, std::string> metadata;
   std::map<std::string, std::string> headers;
   std::vector<int> speciesNetworkFlags = std::vector<int>(9);
@@ -231,6 +239,18 @@ class pidTPCModule
   ctpRateFetcher mRateFetcher;
   Str_dEdx_correction str_dedx_correction;
 
+  // block evaluation of the response: tracks are buffered in columns and the
+  // expected signals, resolutions and nsigmas of all enabled hypotheses are
+  // computed at once every NTracksPerBlock tracks
+  static constexpr std::size_t NTracksPerBlock = 1024;
+  std::vector<o2::track::PID::ID> blockIds;
+  std::array<std::size_t, o2::track::PID::NIDs> blockIdSlot{};
+  uint64_t blockFirstTrack = 0;
+  std::vector<float> blockTpcInnerParam, blockTpcSignal, blockTpcNClsFound, blockTgl, blockSigned1Pt, blockMultTPC;
+  std::vector<uint8_t> blockHasTPC;
+  std::vector<int> blockCountTracks;
+  std::vector<float> blockExpSignal, blockExpSigma, blockNSigma;
+
   //__________________________________________________
   template <typename TCCDB, typename TContext, typename TpidTPCOpts, typename TMetadataInfo>
   void init(TCCDB& ccdb, TContext& context, TpidTPCOpts const& external_pidtpcopts, TMetadataInfo const& metadataInfo)
@@ -417,6 +437,7 @@ class pidTPCModule
             network.initModel(pidTPCopts.networkPathLocally.value, pidTPCopts.enableNetworkOptimizations.value, pidTPCopts.networkSetNumThreads.value, strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
             std::vector<float> dummyInput(network.getNumInputNodes(), 1.);
             network.evalModel(dummyInput); /// Init the model evaluations
+            initNetworkPool(strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
             LOGP(info, "Retrieved NN corrections for production tag {}, pass number {}, and NN-Version {}", headers["LPMProductionTag"], headers["RecoPassName"], headers["NN-Version"]);
           } else {
             LOG(fatal) << "No valid NN object found matching retrieved Bethe-Bloch parametrisation for pass " << metadata["RecoPassName"] << ". Please ensure that the requested pass has dedicated NN corrections available";
@@ -430,6 +451,7 @@ class pidTPCModule
           network.initModel(pidTPCopts.networkPathLocally.value, pidTPCopts.enableNetworkOptimizations.value, pidTPCopts.networkSetNumThreads.value);
           std::vector<float> dummyInput(network.getNumInputNodes(), 1.);
           network.evalModel(dummyInput); // This is an initialisation and might reduce the overhead of the model
+          initNetworkPool();
         }
       } else {
         return;
@@ -441,6 +463,19 @@ class pidTPCModule
     }
   } // end init
 
+  //__________________________________________________
+  /// Loads one additional ONNX session per extra network worker from the (already retrieved) local network file
+  void initNetworkPool(const uint64_t validFrom = 0, const uint64_t validUntil = 0)
+  {
+    networkPool.clear();
+    for (int iWorker = 1; iWorker < pidTPCopts.networkNumWorkers.value; iWorker++) {
+      auto& model = networkPool.emplace_back(std::make_unique<ml::OnnxModel>());
+      model->initModel(pidTPCopts.networkPathLocally.value, pidTPCopts.enableNetworkOptimizations.value, pidTPCopts.networkSetNumThreads.value, validFrom, validUntil);
+      std::vector<float> dummyInput(model->getNumInputNodes(), 1.);
+      model->evalModel(dummyInput);
+    }
+  }
+
   //__________________________________________________
   template <typename TCCDB, typename M, typename T, typename B>
   std::vector<float> createNetworkPrediction(TCCDB& ccdb, soa::Join<aod::Collisions, aod::EvSels> const& collisions, M const& mults, T const& tracks, B const& bcs, const size_t size)
@@ -492,6 +527,7 @@ class pidTPCModule
           network.initModel(pidTPCopts.networkPathLocally.value, pidTPCopts.enableNetworkOptimizations.value, pidTPCopts.networkSetNumThreads.value, strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
           std::vector<float> dummyInput(network.getNumInputNodes(), 1.);
           network.evalModel(dummyInput);
+          initNetworkPool(strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
           LOGP(info, "Retrieved NN corrections for production tag {}, pass number {}, NN-Version number {}", headers["LPMProductionTag"], headers["RecoPassName"], headers["NN-Version"]);
         } else {
           LOG(fatal) << "No valid NN object found matching retrieved Bethe-Bloch parametrisation for pass " << metadata["RecoPassName"] << ". Please ensure that the requested pass has dedicated NN corrections available";
@@ -509,9 +545,9 @@ class pidTPCModule
     const float nNclNormalization = response->GetNClNormalization();
     float duration_network = 0;
 
-    std::vector<float> track_properties(track_prop_size);
+    // The mass-hypothesis independent features are built once per track
+    std::vector<float> trackFeatures(track_prop_size);
     uint64_t counter_track_props = 0;
-    int loop_counter = 0;
 
     // To load the Hadronic rate once for each collision
     float hadronicRateBegin = 0.;
@@ -533,8 +569,7 @@ class pidTPCModule
       hadronicRateBegin = 0.0f;
     }
 
-    // Filling a std::vector<float> to be evaluated by the network
-    // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector
+    // Filling a std::vector<float> with the features of each track
     static constexpr int NParticleTypes = 9;
     constexpr int ExpectedInputDimensionsNNV2 = 7;
     constexpr int ExpectedInputDimensionsNNV3 = 8;
@@ -542,78 +577,99 @@ class pidTPCModule
     constexpr auto NetworkVersionV2 = "2";
     constexpr auto NetworkVersionV3 = "3";
     constexpr auto NetworkVersionV4 = "4";
-    for (int j = 0; j < NParticleTypes; j++) { // Loop over particle number for which network correction is used
-      for (auto const& trk : tracks) {
-        if (!trk.hasTPC()) {
+    for (auto const& trk : tracks) {
+      if (!trk.hasTPC()) {
+        continue;
+      }
+      if (pidTPCopts.skipTPCOnly) {
+        if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
           continue;
         }
-        if (pidTPCopts.skipTPCOnly) {
-          if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
-            continue;
+      }
+      trackFeatures[counter_track_props] = trk.tpcInnerParam();
+      trackFeatures[counter_track_props + 1] = trk.tgl();
+      trackFeatures[counter_track_props + 2] = trk.signed1Pt();
+      trackFeatures[counter_track_props + 3] = 0.f; // mass hypothesis, filled per evaluated row
+      trackFeatures[counter_track_props + 4] = (trk.has_collision() && mults.size() > 0) ? mults[trk.collisionId()] / 11000. : 1.;
+      trackFeatures[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
+      if (input_dimensions == ExpectedInputDimensionsNNV2 && networkVersion == NetworkVersionV2) {
+        trackFeatures[counter_track_props + 6] = (trk.has_collision() && mults.size() > 0) ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
+      }
+      if (input_dimensions == ExpectedInputDimensionsNNV3 && networkVersion == NetworkVersionV3) {
+        trackFeatures[counter_track_props + 6] = (trk.has_collision() && mults.size() > 0) ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
+        if (trk.has_collision() && mults.size() > 0) {
+          if (collsys == CollisionSystemType::kCollSyspp) {
+            trackFeatures[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
+          } else {
+            trackFeatures[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
           }
-        }
-        track_properties[counter_track_props] = trk.tpcInnerParam();
-        track_properties[counter_track_props + 1] = trk.tgl();
-        track_properties[counter_track_props + 2] = trk.signed1Pt();
-        track_properties[counter_track_props + 3] = o2::track::pid_constants::sMasses[j];
-        track_properties[counter_track_props + 4] = (trk.has_collision() && mults.size() > 0) ? mults[trk.collisionId()] / 11000. : 1.;
-        track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
-        if (input_dimensions == ExpectedInputDimensionsNNV2 && networkVersion == NetworkVersionV2) {
-          track_properties[counter_track_props + 6] = (trk.has_collision() && mults.size() > 0) ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-        }
-        if (input_dimensions == ExpectedInputDimensionsNNV3 && networkVersion == NetworkVersionV3) {
-          track_properties[counter_track_props + 6] = (trk.has_collision() && mults.size() > 0) ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-          if (trk.has_collision() && mults.size() > 0) {
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
-            }
+        } else {
+          // asign Hadronic Rate at beginning of run  if track does not belong to a collision
+          if (collsys == CollisionSystemType::kCollSyspp) {
+            trackFeatures[counter_track_props + 7] = hadronicRateBegin / 1500.;
           } else {
-            // asign Hadronic Rate at beginning of run  if track does not belong to a collision
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 50.;
-            }
+            trackFeatures[counter_track_props + 7] = hadronicRateBegin / 50.;
           }
         }
+      }
 
-        if (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4) {
-          track_properties[counter_track_props + 6] = (trk.has_collision() && mults.size() > 0) ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-          if (trk.has_collision() && mults.size() > 0) {
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
-            }
+      if (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4) {
+        trackFeatures[counter_track_props + 6] = (trk.has_collision() && mults.size() > 0) ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
+        if (trk.has_collision() && mults.size() > 0) {
+          if (collsys == CollisionSystemType::kCollSyspp) {
+            trackFeatures[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
           } else {
-            // asign Hadronic Rate at beginning of run  if track does not belong to a collision
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 50.;
-            }
+            trackFeatures[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
+          }
+        } else {
+          // asign Hadronic Rate at beginning of run  if track does not belong to a collision
+          if (collsys == CollisionSystemType::kCollSyspp) {
+            trackFeatures[counter_track_props + 7] = hadronicRateBegin / 1500.;
+          } else {
+            trackFeatures[counter_track_props + 7] = hadronicRateBegin / 50.;
           }
-          track_properties[counter_track_props + 8] = std::fmod(std::fmod(trk.phi(), 2 * M_PI) + 2 * M_PI, M_PI / 9.0);
         }
-        counter_track_props += input_dimensions;
+        trackFeatures[counter_track_props + 8] = std::fmod(std::fmod(trk.phi(), 2 * M_PI) + 2 * M_PI, M_PI / 9.0);
       }
+      counter_track_props += input_dimensions;
+    }
 
-      auto start_network_eval = std::chrono::high_resolution_clock::now();
-      float* output_network = network.evalModel(track_properties);
-      auto stop_network_eval = std::chrono::high_resolution_clock::now();
-      duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
-      for (uint64_t k = 0; k < prediction_size; k += output_dimensions) {
-        for (int l = 0; l < output_dimensions; l++) {
-          network_prediction[k + l + prediction_size * loop_counter] = output_network[k + l];
+    // Evaluation on single tracks brings huge overhead: Thus (track, mass hypothesis) rows are evaluated in large chunks, by default one per hypothesis.
+    // With several workers, each one builds the input of its next chunk while the others are evaluating, so only the chunk buffers are held in memory
+    const uint64_t nRows = NParticleTypes * size;
+    const uint64_t chunkRows = pidTPCopts.networkChunkSize.value > 0 ? static_cast<uint64_t>(pidTPCopts.networkChunkSize.value) : size;
+    const uint64_t nChunks = chunkRows > 0 ? (nRows + chunkRows - 1) / chunkRows : 0;
+    std::atomic<uint64_t> nextChunk{0};
+    auto evaluateChunks = [&](ml::OnnxModel& model) {
+      std::vector<float> chunkProperties;
+      std::vector<float> chunkPrediction;
+      for (uint64_t iChunk = nextChunk++; iChunk < nChunks; iChunk = nextChunk++) {
+        const uint64_t firstRow = iChunk * chunkRows;
+        const uint64_t lastRow = std::min(firstRow + chunkRows, nRows);
+        chunkProperties.resize((lastRow - firstRow) * input_dimensions);
+        for (uint64_t row = firstRow; row < lastRow; row++) {
+          float* properties = chunkProperties.data() + (row - firstRow) * input_dimensions;
+          std::copy_n(trackFeatures.data() + (row % size) * input_dimensions, input_dimensions, properties);
+          properties[3] = o2::track::pid_constants::sMasses[row / size];
+        }
+        if (!model.evalModel(chunkProperties, chunkPrediction) || chunkPrediction.size() != (lastRow - firstRow) * output_dimensions) {
+          LOG(fatal) << "Neural Network for the TPC PID response correction: evaluation of rows " << firstRow << " to " << lastRow << " failed";
         }
+        std::copy(chunkPrediction.begin(), chunkPrediction.end(), network_prediction.begin() + firstRow * output_dimensions);
       }
+    };
 
-      counter_track_props = 0;
-      loop_counter += 1;
+    auto start_network_eval = std::chrono::high_resolution_clock::now();
+    std::vector<std::thread> workers;
+    for (auto& model : networkPool) {
+      workers.emplace_back(evaluateChunks, std::ref(*model));
     }
-    track_properties.clear();
+    evaluateChunks(network);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    auto stop_network_eval = std::chrono::high_resolution_clock::now();
+    duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
 
     auto stop_network_total = std::chrono::high_resolution_clock::now();
     LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (size * 9) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
@@ -624,7 +680,7 @@ class pidTPCModule
 
   //__________________________________________________
   template <typename T, typename NSF, typename NST>
-  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const int64_t multTPC, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
+  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const float expSignalResponse, const float expSigmaResponse, const float nSigmaResponse, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
   {
     if (flagFull != 1 && flagTiny != 1) {
       return;
@@ -645,9 +701,9 @@ class pidTPCModule
         return;
       }
     }
-    auto expSignal = response->GetExpectedSignal(trk, pid);
-    auto expSigma = trk.has_collision() ? response->GetExpectedSigmaAtMultiplicity(multTPC, trk, pid) : 0.07 * expSignal; // use default sigma value of 7% if no collision information to estimate resolution
-    if (expSignal < 0. || expSigma < 0.) {                                                                                // skip if expected signal invalid
+    auto expSignal = expSignalResponse;
+    auto expSigma = trk.has_collision() ? expSigmaResponse : 0.07 * expSignal; // use default sigma value of 7% if no collision information to estimate resolution
+    if (expSignal < 0. || expSigma < 0.) {                                     // skip if expected signal invalid
       if (flagFull)
         tableFull(-999.f, -999.f);
       if (flagTiny)
@@ -680,7 +736,7 @@ class pidTPCModule
         LOGF(fatal, "Network output dimensions incompatible!");
       }
     } else {
-      nSigma = response->GetNumberOfSigmaMCTunedAtMultiplicity(multTPC, trk, pid, tpcSignal);
+      nSigma = nSigmaResponse;
     }
     if (flagFull)
       tableFull(expSigma, nSigma);
@@ -688,6 +744,56 @@ class pidTPCModule
       aod::pidtpc_tiny::binning::packInTable(nSigma, tableTiny);
   };
 
+  //__________________________________________________
+  // evaluates the response for the buffered tracks and fills the PID tables.
+  // Every table is filled in track order, as in the per-track evaluation
+  template <typename TTracks, typename TProducts>
+  void evaluatePidBlock(TTracks const& tracks, TProducts& products, const std::vector<float>& network_prediction, const int tracksForNet_size)
+  {
+    const std::size_t nTracks = blockTpcSignal.size();
+    if (nTracks == 0) {
+      return;
+    }
+    if (!blockIds.empty()) {
+      blockExpSignal.resize(blockIds.size() * nTracks);
+      blockExpSigma.resize(blockIds.size() * nTracks);
+      blockNSigma.resize(blockIds.size() * nTracks);
+      const o2::pid::tpc::ResponseColumns columns{blockTpcInnerParam, blockTpcSignal, blockTpcNClsFound, blockTgl, blockSigned1Pt, blockMultTPC, blockHasTPC};
+      response->GetNumberOfSigmaBlock(columns, blockIds, blockExpSignal, blockExpSigma, blockNSigma);
+    }
+
+    auto makePidTablesBlock = [&](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
+      if (flagFull != 1 && flagTiny != 1) {
+        return;
+      }
+      const std::size_t offset = blockIdSlot[pid] * nTracks;
+      for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+        const auto& trk = tracks.rawIteratorAt(blockFirstTrack + iTrack);
+        this->makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, blockTpcSignal[iTrack], trk, blockExpSignal[offset + iTrack], blockExpSigma[offset + iTrack], blockNSigma[offset + iTrack], network_prediction, blockCountTracks[iTrack], tracksForNet_size);
+      }
+    };
+
+    makePidTablesBlock(pidTPCopts.pidFullEl, products.tablePIDFullEl, pidTPCopts.pidTinyEl, products.tablePIDTinyEl, o2::track::PID::Electron);
+    makePidTablesBlock(pidTPCopts.pidFullMu, products.tablePIDFullMu, pidTPCopts.pidTinyMu, products.tablePIDTinyMu, o2::track::PID::Muon);
+    makePidTablesBlock(pidTPCopts.pidFullPi, products.tablePIDFullPi, pidTPCopts.pidTinyPi, products.tablePIDTinyPi, o2::track::PID::Pion);
+    makePidTablesBlock(pidTPCopts.pidFullKa, products.tablePIDFullKa, pidTPCopts.pidTinyKa, products.tablePIDTinyKa, o2::track::PID::Kaon);
+    makePidTablesBlock(pidTPCopts.pidFullPr, products.tablePIDFullPr, pidTPCopts.pidTinyPr, products.tablePIDTinyPr, o2::track::PID::Proton);
+    makePidTablesBlock(pidTPCopts.pidFullDe, products.tablePIDFullDe, pidTPCopts.pidTinyDe, products.tablePIDTinyDe, o2::track::PID::Deuteron);
+    makePidTablesBlock(pidTPCopts.pidFullTr, products.tablePIDFullTr, pidTPCopts.pidTinyTr, products.tablePIDTinyTr, o2::track::PID::Triton);
+    makePidTablesBlock(pidTPCopts.pidFullHe, products.tablePIDFullHe, pidTPCopts.pidTinyHe, products.tablePIDTinyHe, o2::track::PID::Helium3);
+    makePidTablesBlock(pidTPCopts.pidFullAl, products.tablePIDFullAl, pidTPCopts.pidTinyAl, products.tablePIDTinyAl, o2::track::PID::Alpha);
+
+    blockFirstTrack += nTracks;
+    blockTpcInnerParam.clear();
+    blockTpcSignal.clear();
+    blockTpcNClsFound.clear();
+    blockTgl.clear();
+    blockSigned1Pt.clear();
+    blockMultTPC.clear();
+    blockHasTPC.clear();
+    blockCountTracks.clear();
+  }
+
   //__________________________________________________
   template <typename TCCDB, typename TBCs, typename TTracks, typename TTracksQA, typename TProducts>
   void process(TCCDB& ccdb, TBCs const& bcs, soa::Join<aod::Collisions, aod::EvSels> const& cols, TTracks const& tracks, TTracksQA const& tracksQA, TProducts& products)
@@ -758,6 +864,25 @@ class pidTPCModule
 
     uint64_t count_tracks = 0;
 
+    // hypotheses evaluated in blocks, in the order of the tables
+    blockIds.clear();
+    auto enableBlockId = [this](const int flagFull, const int flagTiny, const o2::track::PID::ID pid) {
+      if (flagFull == 1 || flagTiny == 1) {
+        blockIdSlot[pid] = blockIds.size();
+        blockIds.push_back(pid);
+      }
+    };
+    enableBlockId(pidTPCopts.pidFullEl, pidTPCopts.pidTinyEl, o2::track::PID::Electron);
+    enableBlockId(pidTPCopts.pidFullMu, pidTPCopts.pidTinyMu, o2::track::PID::Muon);
+    enableBlockId(pidTPCopts.pidFullPi, pidTPCopts.pidTinyPi, o2::track::PID::Pion);
+    enableBlockId(pidTPCopts.pidFullKa, pidTPCopts.pidTinyKa, o2::track::PID::Kaon);
+    enableBlockId(pidTPCopts.pidFullPr, pidTPCopts.pidTinyPr, o2::track::PID::Proton);
+    enableBlockId(pidTPCopts.pidFullDe, pidTPCopts.pidTinyDe, o2::track::PID::Deuteron);
+    enableBlockId(pidTPCopts.pidFullTr, pidTPCopts.pidTinyTr, o2::track::PID::Triton);
+    enableBlockId(pidTPCopts.pidFullHe, pidTPCopts.pidTinyHe, o2::track::PID::Helium3);
+    enableBlockId(pidTPCopts.pidFullAl, pidTPCopts.pidTinyAl, o2::track::PID::Alpha);
+    blockFirstTrack = 0;
+
     //_______________________________________
     // process tracksQA in case present
     std::vector<int64_t> indexTrack2TrackQA(outTable_size, -1);
@@ -883,6 +1008,7 @@ class pidTPCModule
         } else {
           LOGP(info, "Retrieving TPC Response for timestamp {} and recoPass {}:", bc.timestamp(), pidTPCopts.recoPass.value);
         }
+        evaluatePidBlock(tracks, products, network_prediction, tracksForNet_size); // buffered tracks use the current response object
         response = ccdb->template getSpecific<o2::pid::tpc::Response>(pidTPCopts.ccdbPath.value, bc.timestamp(), metadata, &headers);
         if (!response) {
           LOGP(warning, "!! Could not find a valid TPC response object for specific pass name {}! Falling back to latest uploaded object.", metadata["RecoPassName"]);
@@ -950,24 +1076,24 @@ class pidTPCModule
         }
       }
 
-      auto makePidTablesDefault = [&trk, &tpcSignalToEvaluatePID, &multTPC, &network_prediction, &count_tracks, &tracksForNet_size, this](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
-        this->makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, tpcSignalToEvaluatePID, trk, multTPC, network_prediction, count_tracks, tracksForNet_size);
-      };
-
-      makePidTablesDefault(pidTPCopts.pidFullEl, products.tablePIDFullEl, pidTPCopts.pidTinyEl, products.tablePIDTinyEl, o2::track::PID::Electron);
-      makePidTablesDefault(pidTPCopts.pidFullMu, products.tablePIDFullMu, pidTPCopts.pidTinyMu, products.tablePIDTinyMu, o2::track::PID::Muon);
-      makePidTablesDefault(pidTPCopts.pidFullPi, products.tablePIDFullPi, pidTPCopts.pidTinyPi, products.tablePIDTinyPi, o2::track::PID::Pion);
-      makePidTablesDefault(pidTPCopts.pidFullKa, products.tablePIDFullKa, pidTPCopts.pidTinyKa, products.tablePIDTinyKa, o2::track::PID::Kaon);
-      makePidTablesDefault(pidTPCopts.pidFullPr, products.tablePIDFullPr, pidTPCopts.pidTinyPr, products.tablePIDTinyPr, o2::track::PID::Proton);
-      makePidTablesDefault(pidTPCopts.pidFullDe, products.tablePIDFullDe, pidTPCopts.pidTinyDe, products.tablePIDTinyDe, o2::track::PID::Deuteron);
-      makePidTablesDefault(pidTPCopts.pidFullTr, products.tablePIDFullTr, pidTPCopts.pidTinyTr, products.tablePIDTinyTr, o2::track::PID::Triton);
-      makePidTablesDefault(pidTPCopts.pidFullHe, products.tablePIDFullHe, pidTPCopts.pidTinyHe, products.tablePIDTinyHe, o2::track::PID::Helium3);
-      makePidTablesDefault(pidTPCopts.pidFullAl, products.tablePIDFullAl, pidTPCopts.pidTinyAl, products.tablePIDTinyAl, o2::track::PID::Alpha);
+      // buffer the track for the block evaluation of the PID tables
+      blockTpcInnerParam.push_back(trk.tpcInnerParam());
+      blockTpcSignal.push_back(tpcSignalToEvaluatePID);
+      blockTpcNClsFound.push_back(static_cast<float>(trk.tpcNClsFound()));
+      blockTgl.push_back(trk.tgl());
+      blockSigned1Pt.push_back(trk.signed1Pt());
+      blockMultTPC.push_back(static_cast<float>(multTPC));
+      blockHasTPC.push_back(trk.hasTPC());
+      blockCountTracks.push_back(static_cast<int>(count_tracks));
+      if (blockTpcSignal.size() == NTracksPerBlock) {
+        evaluatePidBlock(tracks, products, network_prediction, tracksForNet_size);
+      }
 
       if (trk.hasTPC() && (!pidTPCopts.skipTPCOnly || trk.hasITS() || trk.hasTRD() || trk.hasTOF())) {
         count_tracks++; // Increment network track counter only if track has TPC, and (not skipping TPConly) or (is not TPConly)
       }
     }
+    evaluatePidBlock(tracks, products, network_prediction, tracksForNet_size);
   } // end process function
 };
 
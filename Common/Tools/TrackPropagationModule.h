@@ -39,11 +39,17 @@
 #include <TH1.h>
 #include <TH2.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 //__________________________________________
 // track propagation module
@@ -79,6 +85,10 @@ struct TrackPropagationConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<bool> fillTrackTunerTable{"fillTrackTunerTable", false, "flag to fill track tuner table"};
   o2::framework::Configurable<int> trackTunerConfigSource{"trackTunerConfigSource", aod::track_tuner::InputString, "1: input string; 2: TrackTuner Configurables"};
   o2::framework::Configurable<std::string> trackTunerParams{"trackTunerParams", "debugInfo=0|updateTrackDCAs=1|updateTrackCovMat=1|updateCurvature=0|updateCurvatureIU=0|updatePulls=0|isInputFileFromCCDB=1|pathInputFile=Users/m/mfaggin/test/inputsTrackTuner/PbPb2022|nameInputFile=trackTuner_DataLHC22sPass5_McLHC22l1b2_run529397.root|pathFileQoverPt=Users/h/hsharma/qOverPtGraphs|nameFileQoverPt=D0sigma_Data_removal_itstps_MC_LHC22b1b.root|usePvRefitCorrections=0|qOverPtMC=-1.|qOverPtData=-1.", "TrackTuner parameter initialization (format: <name>=<value>|<name>=<value>)"};
+  // multi-threaded propagation: tracks are propagated in chunks by worker threads
+  // into per-track buffers; the tables are then filled in track order
+  o2::framework::Configurable<int> nThreads{"nThreads", 1, "number of worker threads for track propagation. 1 (default): serial propagation. Not used with the TrackTuner"};
+  o2::framework::Configurable<int> nTracksPerChunk{"nTracksPerChunk", 512, "number of tracks handed to a worker thread at a time"};
   o2::framework::ConfigurableAxis axisPtQA{"axisPtQA", {o2::framework::VARIABLE_WIDTH, 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f, 1.8f, 1.9f, 2.0f, 2.2f, 2.4f, 2.6f, 2.8f, 3.0f, 3.2f, 3.4f, 3.6f, 3.8f, 4.0f, 4.4f, 4.8f, 5.2f, 5.6f, 6.0f, 6.5f, 7.0f, 7.5f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 17.0f, 19.0f, 21.0f, 23.0f, 25.0f, 30.0f, 35.0f, 40.0f, 50.0f}, "pt axis for QA histograms"};
 };
 
@@ -108,6 +118,18 @@ class TrackPropagationModule
   o2::track::TrackParametrizationWithError<float> mTrackParCov;
   bool autoDetectDcaCalib = false; // track tuner setting
 
+  // per-track results of the multi-threaded propagation
+  enum PropagationStatus : uint8_t {
+    kNotPropagated = 0,
+    kPropagationFailed,
+    kPropagationOK
+  };
+  std::vector<o2::track::TrackParametrization<float>> mTrackParBuffer;
+  std::vector<std::array<float, 2>> mDcaInfoBuffer;
+  std::vector<o2::track::TrackParametrizationWithError<float>> mTrackParCovBuffer;
+  std::vector<o2::dataformats::DCA> mDcaInfoCovBuffer;
+  std::vector<uint8_t> mPropagationStatus;
+
   template <typename TConfigurableGroup, typename TInitContext, typename THistoRegistry>
   void init(TConfigurableGroup const& cGroup, TrackTuner& trackTunerObj, THistoRegistry& registry, TInitContext& initContext)
   {
@@ -210,6 +232,111 @@ class TrackPropagationModule
     registry.template add<TH2>("hDCAzVsPtMC", "hDCAzVsPtMC", o2::framework::HistType::kTH2F, {axisBinsDCA, cGroup.axisPtQA});
   }
 
+  //__________________________________________________
+  // propagates trackParCov to the vertex of its collision, or to the mean vertex
+  // if the track is not assigned to a collision. vtx is used as scratch space
+  template <typename TCCDBLoader, typename TCollisions, typename TTrack>
+  bool propagateTrackParCov(TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTrack const& track, o2::dataformats::VertexBase& vtx, o2::track::TrackParametrizationWithError<float>& trackParCov, o2::dataformats::DCA& dcaInfoCov) const
+  {
+    if (track.has_collision()) {
+      auto const& collision = collisions.rawIteratorAt(track.collisionId());
+      vtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+      vtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    } else {
+      vtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
+      vtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
+    }
+    return o2::base::Propagator::Instance()->propagateToDCABxByBz(vtx, trackParCov, 2.f, matCorr, &dcaInfoCov);
+  }
+
+  //__________________________________________________
+  // same as propagateTrackParCov, without covariance
+  template <typename TCCDBLoader, typename TCollisions, typename TTrack>
+  bool propagateTrackPar(TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTrack const& track, o2::track::TrackParametrization<float>& trackPar, std::array<float, 2>& dcaInfo) const
+  {
+    if (track.has_collision()) {
+      auto const& collision = collisions.rawIteratorAt(track.collisionId());
+      return o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackPar, 2.f, matCorr, &dcaInfo);
+    }
+    return o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, trackPar, 2.f, matCorr, &dcaInfo);
+  }
+
+  //__________________________________________________
+  // propagates all tracks concurrently into the per-track buffers. Chunks of
+  // tracks are handed out dynamically; the calling thread participates as well.
+  // Every worker owns its vertex scratch space, while the propagator (field and
+  // material LUT) is shared read-only, as in the multi-threaded O2 vertexers
+  template <typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTracks>
+  void propagateTracksParallel(TConfigurableGroup const& cGroup, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTracks const& tracks)
+  {
+    const std::size_t nTracks = tracks.size();
+    mPropagationStatus.assign(nTracks, kNotPropagated);
+    if (fillTracksCov) {
+      mTrackParCovBuffer.resize(nTracks);
+      mDcaInfoCovBuffer.resize(nTracks);
+    } else {
+      mTrackParBuffer.resize(nTracks);
+      mDcaInfoBuffer.resize(nTracks);
+    }
+
+    const std::size_t chunkSize = std::max(1, cGroup.nTracksPerChunk.value);
+    const std::size_t nWorkers = std::min(static_cast<std::size_t>(cGroup.nThreads.value), (nTracks + chunkSize - 1) / chunkSize);
+    std::atomic<std::size_t> nextChunk{0};
+    auto worker = [&]() {
+      o2::dataformats::VertexBase vtx;
+      for (std::size_t begin = nextChunk.fetch_add(chunkSize); begin < nTracks; begin = nextChunk.fetch_add(chunkSize)) {
+        const std::size_t end = std::min(begin + chunkSize, nTracks);
+        for (std::size_t iTrack = begin; iTrack < end; iTrack++) {
+          auto const& track = tracks.rawIteratorAt(iTrack);
+          const bool propagate = track.trackType() == o2::aod::track::TrackIU && track.x() < cGroup.minPropagationRadius.value;
+          bool isPropagationOK = true;
+          if (fillTracksCov) {
+            auto& trackParCov = mTrackParCovBuffer[iTrack];
+            auto& dcaInfoCov = mDcaInfoCovBuffer[iTrack];
+            if (fillTracksDCA || fillTracksDCACov) {
+              dcaInfoCov.set(999, 999, 999, 999, 999);
+            }
+            setTrackParCov(track, trackParCov);
+            if (cGroup.useTrkPid.value) {
+              trackParCov.setPID(track.pidForTracking());
+            }
+            if (propagate) {
+              isPropagationOK = propagateTrackParCov(ccdbLoader, collisions, track, vtx, trackParCov, dcaInfoCov);
+            }
+          } else {
+            auto& trackPar = mTrackParBuffer[iTrack];
+            auto& dcaInfo = mDcaInfoBuffer[iTrack];
+            if (fillTracksDCA) {
+              dcaInfo[0] = 999;
+              dcaInfo[1] = 999;
+            }
+            setTrackPar(track, trackPar);
+            if (cGroup.useTrkPid.value) {
+              trackPar.setPID(track.pidForTracking());
+            }
+            if (propagate) {
+              isPropagationOK = propagateTrackPar(ccdbLoader, collisions, track, trackPar, dcaInfo);
+            }
+          }
+          if (propagate) {
+            mPropagationStatus[iTrack] = isPropagationOK ? kPropagationOK : kPropagationFailed;
+          }
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers);
+    for (std::size_t iWorker = 1; iWorker < nWorkers; iWorker++) {
+      threads.emplace_back(worker);
+    }
+    if (nWorkers > 0) {
+      worker();
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
   template <bool isMc, typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTracks, typename TOutputGroup, typename THistoRegistry>
   void fillTrackTables(TConfigurableGroup const& cGroup, TrackTuner& trackTunerObj, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTracks const& tracks, TOutputGroup& cursors, THistoRegistry& registry)
   {
@@ -254,6 +381,13 @@ class TrackPropagationModule
       cursors.tunertable.reserve(tracks.size());
     }
 
+    // the TrackTuner modifies tracks and fills histograms while propagating:
+    // it always runs in the serial loop
+    if (cGroup.nThreads.value > 1 && !cGroup.useTrackTuner.value) {
+      fillTrackTablesParallel<isMc>(cGroup, ccdbLoader, collisions, tracks, cursors, registry);
+      return;
+    }
+
     for (const auto& track : tracks) {
       if (fillTracksCov) {
         if (fillTracksDCA || fillTracksDCACov) {
@@ -296,23 +430,10 @@ class TrackPropagationModule
         }
         bool isPropagationOK = true;
 
-        if (track.has_collision()) {
-          auto const& collision = collisions.rawIteratorAt(track.collisionId());
-          if (fillTracksCov) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
+        if (fillTracksCov) {
+          isPropagationOK = propagateTrackParCov(ccdbLoader, collisions, track, mVtx, mTrackParCov, mDcaInfoCov);
         } else {
-          if (fillTracksCov) {
-            mVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
-            mVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
+          isPropagationOK = propagateTrackPar(ccdbLoader, collisions, track, mTrackPar, mDcaInfo);
         }
         if (isPropagationOK) {
           trackType = o2::aod::track::Track;
@@ -339,30 +460,83 @@ class TrackPropagationModule
       }
       // LOG(info) <<  " trackPropagation (this value filled in tuner table)--> "  << q2OverPtNew;
       if (fillTracksCov) {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackParCov.getX(), mTrackParCov.getAlpha(), mTrackParCov.getY(), mTrackParCov.getZ(), mTrackParCov.getSnp(), mTrackParCov.getTgl(), mTrackParCov.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackParCov.getPt(), mTrackParCov.getP(), mTrackParCov.getEta(), mTrackParCov.getPhi());
-        // TODO do we keep the rho as 0? Also the sigma's are duplicated information
-        cursors.tracksParCovPropagated(std::sqrt(mTrackParCov.getSigmaY2()), std::sqrt(mTrackParCov.getSigmaZ2()), std::sqrt(mTrackParCov.getSigmaSnp2()),
-                                       std::sqrt(mTrackParCov.getSigmaTgl2()), std::sqrt(mTrackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-        cursors.tracksParCovExtensionPropagated(mTrackParCov.getSigmaY2(), mTrackParCov.getSigmaZY(), mTrackParCov.getSigmaZ2(), mTrackParCov.getSigmaSnpY(),
-                                                mTrackParCov.getSigmaSnpZ(), mTrackParCov.getSigmaSnp2(), mTrackParCov.getSigmaTglY(), mTrackParCov.getSigmaTglZ(), mTrackParCov.getSigmaTglSnp(),
-                                                mTrackParCov.getSigmaTgl2(), mTrackParCov.getSigma1PtY(), mTrackParCov.getSigma1PtZ(), mTrackParCov.getSigma1PtSnp(), mTrackParCov.getSigma1PtTgl(),
-                                                mTrackParCov.getSigma1Pt2());
-        if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfoCov.getY(), mDcaInfoCov.getZ());
-        }
-        if (fillTracksDCACov) {
-          cursors.tracksDCACov(mDcaInfoCov.getSigmaY2(), mDcaInfoCov.getSigmaZ2());
-        }
+        fillPropagatedTrack(cursors, track.collisionId(), trackType, mTrackParCov, mDcaInfoCov);
       } else {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackPar.getX(), mTrackPar.getAlpha(), mTrackPar.getY(), mTrackPar.getZ(), mTrackPar.getSnp(), mTrackPar.getTgl(), mTrackPar.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackPar.getPt(), mTrackPar.getP(), mTrackPar.getEta(), mTrackPar.getPhi());
-        if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfo[0], mDcaInfo[1]);
+        fillPropagatedTrack(cursors, track.collisionId(), trackType, mTrackPar, mDcaInfo);
+      }
+    }
+  }
+
+  //__________________________________________________
+  // multi-threaded counterpart of the track loop in fillTrackTables: tracks are
+  // propagated concurrently, then the tables and QA histograms are filled from
+  // the buffers in track order, so that the output is identical to the serial loop
+  template <bool isMc, typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTracks, typename TOutputGroup, typename THistoRegistry>
+  void fillTrackTablesParallel(TConfigurableGroup const& cGroup, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTracks const& tracks, TOutputGroup& cursors, THistoRegistry& registry)
+  {
+    propagateTracksParallel(cGroup, ccdbLoader, collisions, tracks);
+
+    const std::size_t nTracks = tracks.size();
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      auto const& track = tracks.rawIteratorAt(iTrack);
+      o2::aod::track::TrackTypeEnum trackType = (o2::aod::track::TrackTypeEnum)track.trackType();
+      if (mPropagationStatus[iTrack] == kPropagationOK) {
+        trackType = o2::aod::track::Track;
+      }
+      if (fillTracksCov) {
+        auto const& trackParCov = mTrackParCovBuffer[iTrack];
+        auto const& dcaInfoCov = mDcaInfoCovBuffer[iTrack];
+        if constexpr (isMc) {
+          if (mPropagationStatus[iTrack] == kPropagationOK && track.has_mcParticle()) {
+            auto mcParticle1 = track.mcParticle();
+            if (mcParticle1.isPhysicalPrimary()) {
+              registry.fill(HIST("hDCAxyVsPtRec"), dcaInfoCov.getY(), trackParCov.getPt());
+              registry.fill(HIST("hDCAxyVsPtMC"), dcaInfoCov.getY(), mcParticle1.pt());
+              registry.fill(HIST("hDCAzVsPtRec"), dcaInfoCov.getZ(), trackParCov.getPt());
+              registry.fill(HIST("hDCAzVsPtMC"), dcaInfoCov.getZ(), mcParticle1.pt());
+            }
+          }
         }
+        fillPropagatedTrack(cursors, track.collisionId(), trackType, trackParCov, dcaInfoCov);
+      } else {
+        fillPropagatedTrack(cursors, track.collisionId(), trackType, mTrackParBuffer[iTrack], mDcaInfoBuffer[iTrack]);
       }
     }
   }
+
+  //__________________________________________________
+  // fills one row of the propagated track tables (with covariance)
+  template <typename TOutputGroup>
+  void fillPropagatedTrack(TOutputGroup& cursors, int collisionId, o2::aod::track::TrackTypeEnum trackType, o2::track::TrackParametrizationWithError<float> const& trackParCov, o2::dataformats::DCA const& dcaInfoCov)
+  {
+    cursors.tracksParPropagated(collisionId, trackType, trackParCov.getX(), trackParCov.getAlpha(), trackParCov.getY(), trackParCov.getZ(), trackParCov.getSnp(), trackParCov.getTgl(), trackParCov.getQ2Pt());
+    cursors.tracksParExtensionPropagated(trackParCov.getPt(), trackParCov.getP(), trackParCov.getEta(), trackParCov.getPhi());
+    // TODO do we keep the rho as 0? Also the sigma's are duplicated information
+    cursors.tracksParCovPropagated(std::sqrt(trackParCov.getSigmaY2()), std::sqrt(trackParCov.getSigmaZ2()), std::sqrt(trackParCov.getSigmaSnp2()),
+                                   std::sqrt(trackParCov.getSigmaTgl2()), std::sqrt(trackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    cursors.tracksParCovExtensionPropagated(trackParCov.getSigmaY2(), trackParCov.getSigmaZY(), trackParCov.getSigmaZ2(), trackParCov.getSigmaSnpY(),
+                                            trackParCov.getSigmaSnpZ(), trackParCov.getSigmaSnp2(), trackParCov.getSigmaTglY(), trackParCov.getSigmaTglZ(), trackParCov.getSigmaTglSnp(),
+                                            trackParCov.getSigmaTgl2(), trackParCov.getSigma1PtY(), trackParCov.getSigma1PtZ(), trackParCov.getSigma1PtSnp(), trackParCov.getSigma1PtTgl(),
+                                            trackParCov.getSigma1Pt2());
+    if (fillTracksDCA) {
+      cursors.tracksDCA(dcaInfoCov.getY(), dcaInfoCov.getZ());
+    }
+    if (fillTracksDCACov) {
+      cursors.tracksDCACov(dcaInfoCov.getSigmaY2(), dcaInfoCov.getSigmaZ2());
+    }
+  }
+
+  //__________________________________________________
+  // fills one row of the propagated track tables (without covariance)
+  template <typename TOutputGroup>
+  void fillPropagatedTrack(TOutputGroup& cursors, int collisionId, o2::aod::track::TrackTypeEnum trackType, o2::track::TrackParametrization<float> const& trackPar, std::array<float, 2> const& dcaInfo)
+  {
+    cursors.tracksParPropagated(collisionId, trackType, trackPar.getX(), trackPar.getAlpha(), trackPar.getY(), trackPar.getZ(), trackPar.getSnp(), trackPar.getTgl(), trackPar.getQ2Pt());
+    cursors.tracksParExtensionPropagated(trackPar.getPt(), trackPar.getP(), trackPar.getEta(), trackPar.getPhi());
+    if (fillTracksDCA) {
+      cursors.tracksDCA(dcaInfo[0], dcaInfo[1]);
+    }
+  }
 };
 
 } // namespace common
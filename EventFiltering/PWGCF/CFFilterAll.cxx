@@ -53,6 +53,7 @@
 #include <TH1.h>
 #include <TH2.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
@@ -272,6 +273,7 @@ struct CFFilterAll {
                                               cf_trigger::limitNames,
                                               cf_trigger::filterNames},
                                              "Limits for trigger. Tight limit without downsampling and loose with downsampling"};
+    Configurable<bool> fullTripletQA{"fullTripletQA", true, "Evaluate all PPP, PPL, PLL and LLL triplets and fill their QA histograms. If false, use a pruned search that stops once the trigger decisions are final"};
   } TriggerSelections;
 
   struct : ConfigurableGroup {
@@ -339,6 +341,9 @@ struct CFFilterAll {
   std::array<int, cf_trigger::kNTriggers> signalTightLimit;
   std::array<int, cf_trigger::kNTriggers> signalLooseLimit;
 
+  // pair terms of Q3 for the pruned triplet search
+  std::vector<float> pairQ3Same, pairQ3Mixed;
+
   void init(o2::framework::InitContext&)
   {
 
@@ -1275,6 +1280,58 @@ struct CFFilterAll {
     return std::sqrt(-q32);
   }
 
+  // Fills sqrt(-q_ij^2) for all pairs of candidates in vecA and vecB
+  void fillPairQ3(const std::vector<ROOT::Math::PtEtaPhiMVector>& vecA, const std::vector<ROOT::Math::PtEtaPhiMVector>& vecB, std::vector<float>& pairQ3)
+  {
+    pairQ3.resize(vecA.size() * vecB.size());
+    for (size_t i = 0; i < vecA.size(); i++) {
+      for (size_t j = 0; j < vecB.size(); j++) {
+        pairQ3[i * vecB.size() + j] = std::sqrt(static_cast<float>(-getqij(vecA.at(i), vecB.at(j)).M2()));
+      }
+    }
+  }
+
+  // Pruned search for triplets (a1, a2, c) below the Q3 limits, with a1 < a2 from vecA and c from vecC (c > a2 if sameSpecies).
+  // Q3^2 is the sum of the three non-negative pair terms -q_ij^2, so no triplet containing a pair with sqrt(-q_ij^2) above the limit can be selected.
+  // Once a loose triplet is found only the tight limit is searched for, and the search stops at the first tight triplet since both decisions are then final.
+  // No QA histograms are filled.
+  template <typename TSkip>
+  void searchTriplets(const std::vector<ROOT::Math::PtEtaPhiMVector>& vecA, const std::vector<ROOT::Math::PtEtaPhiMVector>& vecC, bool sameSpecies, float looseLimit, float tightLimit, TSkip skip, int& signalLoose, int& signalTight)
+  {
+    tightLimit = std::min(tightLimit, looseLimit); // tight triplets have to pass the loose limit as well
+    if (signalTight > 0 || vecA.size() < 2 || vecC.empty()) {
+      return;
+    }
+    fillPairQ3(vecA, vecA, pairQ3Same);
+    if (!sameSpecies) {
+      fillPairQ3(vecA, vecC, pairQ3Mixed);
+    }
+    const std::vector<float>& pairQ3AC = sameSpecies ? pairQ3Same : pairQ3Mixed;
+    const size_t nA = vecA.size();
+    const size_t nC = vecC.size();
+    for (size_t a1 = 0; a1 < nA; a1++) {
+      for (size_t a2 = a1 + 1; a2 < nA; a2++) {
+        if (pairQ3Same[a1 * nA + a2] >= (signalLoose > 0 ? tightLimit : looseLimit)) {
+          continue;
+        }
+        for (size_t c = sameSpecies ? a2 + 1 : 0; c < nC; c++) {
+          const float limit = signalLoose > 0 ? tightLimit : looseLimit;
+          if (pairQ3AC[a1 * nC + c] >= limit || pairQ3AC[a2 * nC + c] >= limit || skip(a1, a2, c)) {
+            continue;
+          }
+          float q3 = getQ3(vecA.at(a1), vecA.at(a2), vecC.at(c));
+          if (q3 < looseLimit) {
+            signalLoose += 1;
+            if (q3 < tightLimit) {
+              signalTight += 1;
+              return;
+            }
+          }
+        }
+      }
+    }
+  }
+
   template <typename T>
   float itsSignal(T const& track)
   {
@@ -1866,7 +1923,7 @@ struct CFFilterAll {
     float q3 = 999.f, kstar = 999.f;
 
     // PPP
-    if (TriggerSelections.filterSwitches->get("Switch", "PPP") > 0) {
+    if (TriggerSelections.filterSwitches->get("Switch", "PPP") > 0 && TriggerSelections.fullTripletQA.value) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t p2 = p1 + 1; p2 < vecProton.size(); p2++) {
           for (size_t p3 = p2 + 1; p3 < vecProton.size(); p3++) {
@@ -1931,7 +1988,7 @@ struct CFFilterAll {
       }
     }
     // PPL
-    if (TriggerSelections.filterSwitches->get("Switch", "PPL") > 0) {
+    if (TriggerSelections.filterSwitches->get("Switch", "PPL") > 0 && TriggerSelections.fullTripletQA.value) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
         for (size_t p2 = p1 + 1; p2 < vecProton.size(); p2++) {
           for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
@@ -2002,7 +2059,7 @@ struct CFFilterAll {
       }
     }
     // PLL
-    if (TriggerSelections.filterSwitches->get("Switch", "PLL") > 0) {
+    if (TriggerSelections.filterSwitches->get("Switch", "PLL") > 0 && TriggerSelections.fullTripletQA.value) {
       for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
         for (size_t l2 = l1 + 1; l2 < vecLambda.size(); l2++) {
           for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
@@ -2079,7 +2136,7 @@ struct CFFilterAll {
       }
     }
     // LLL
-    if (TriggerSelections.filterSwitches->get("Switch", "LLL") > 0) {
+    if (TriggerSelections.filterSwitches->get("Switch", "LLL") > 0 && TriggerSelections.fullTripletQA.value) {
       for (size_t l1 = 0; l1 < vecLambda.size(); l1++) {
         for (size_t l2 = l1 + 1; l2 < vecLambda.size(); l2++) {
           for (size_t l3 = l2 + 1; l3 < vecLambda.size(); l3++) {
@@ -2153,6 +2210,59 @@ struct CFFilterAll {
         }
       }
     }
+    // PPP, PPL, PLL and LLL without triplet QA
+    if (!TriggerSelections.fullTripletQA.value) {
+      auto skipNone = [](size_t, size_t, size_t) { return false; };
+      auto skipPPL = [&](size_t p1, size_t p2, size_t l1) {
+        return idxProton.at(p1) == idxLambdaDaughProton.at(l1) || idxProton.at(p2) == idxLambdaDaughProton.at(l1);
+      };
+      auto skipAntiPPL = [&](size_t p1, size_t p2, size_t l1) {
+        return idxAntiProton.at(p1) == idxAntiLambdaDaughProton.at(l1) || idxAntiProton.at(p2) == idxAntiLambdaDaughProton.at(l1);
+      };
+      auto skipPLL = [&](size_t l1, size_t l2, size_t p1) {
+        return idxProton.at(p1) == idxLambdaDaughProton.at(l1) || idxProton.at(p1) == idxLambdaDaughProton.at(l2) ||
+               idxLambdaDaughProton.at(l1) == idxLambdaDaughProton.at(l2) || idxLambdaDaughPion.at(l1) == idxLambdaDaughPion.at(l2);
+      };
+      auto skipAntiPLL = [&](size_t l1, size_t l2, size_t p1) {
+        return idxAntiProton.at(p1) == idxAntiLambdaDaughProton.at(l1) || idxAntiProton.at(p1) == idxAntiLambdaDaughProton.at(l2) ||
+               idxAntiLambdaDaughProton.at(l1) == idxAntiLambdaDaughProton.at(l2) || idxAntiLambdaDaughPion.at(l1) == idxAntiLambdaDaughPion.at(l2);
+      };
+      auto skipLLL = [&](size_t l1, size_t l2, size_t l3) {
+        return idxLambdaDaughProton.at(l1) == idxLambdaDaughProton.at(l2) || idxLambdaDaughPion.at(l1) == idxLambdaDaughPion.at(l2) ||
+               idxLambdaDaughProton.at(l2) == idxLambdaDaughProton.at(l3) || idxLambdaDaughPion.at(l2) == idxLambdaDaughPion.at(l3) ||
+               idxLambdaDaughProton.at(l3) == idxLambdaDaughProton.at(l1) || idxLambdaDaughPion.at(l3) == idxLambdaDaughPion.at(l1);
+      };
+      auto skipAntiLLL = [&](size_t l1, size_t l2, size_t l3) {
+        return idxAntiLambdaDaughProton.at(l1) == idxAntiLambdaDaughProton.at(l2) || idxAntiLambdaDaughPion.at(l1) == idxAntiLambdaDaughPion.at(l2) ||
+               idxAntiLambdaDaughProton.at(l2) == idxAntiLambdaDaughProton.at(l3) || idxAntiLambdaDaughPion.at(l2) == idxAntiLambdaDaughPion.at(l3) ||
+               idxAntiLambdaDaughProton.at(l3) == idxAntiLambdaDaughProton.at(l1) || idxAntiLambdaDaughPion.at(l3) == idxAntiLambdaDaughPion.at(l1);
+      };
+      if (TriggerSelections.filterSwitches->get("Switch", "PPP") > 0) {
+        float looseLimit = TriggerSelections.limits->get("Loose Limit", "PPP");
+        float tightLimit = TriggerSelections.limits->get("Tight Limit", "PPP");
+        searchTriplets(vecProton, vecProton, true, looseLimit, tightLimit, skipNone, signalLooseLimit[cf_trigger::kPPP], signalTightLimit[cf_trigger::kPPP]);
+        searchTriplets(vecAntiProton, vecAntiProton, true, looseLimit, tightLimit, skipNone, signalLooseLimit[cf_trigger::kPPP], signalTightLimit[cf_trigger::kPPP]);
+      }
+      if (TriggerSelections.filterSwitches->get("Switch", "PPL") > 0) {
+        float looseLimit = TriggerSelections.limits->get("Loose Limit", "PPL");
+        float tightLimit = TriggerSelections.limits->get("Tight Limit", "PPL");
+        searchTriplets(vecProton, vecLambda, false, looseLimit, tightLimit, skipPPL, signalLooseLimit[cf_trigger::kPPL], signalTightLimit[cf_trigger::kPPL]);
+        searchTriplets(vecAntiProton, vecAntiLambda, false, looseLimit, tightLimit, skipAntiPPL, signalLooseLimit[cf_trigger::kPPL], signalTightLimit[cf_trigger::kPPL]);
+      }
+      if (TriggerSelections.filterSwitches->get("Switch", "PLL") > 0) {
+        float looseLimit = TriggerSelections.limits->get("Loose Limit", "PLL");
+        float tightLimit = TriggerSelections.limits->get("Tight Limit", "PLL");
+        searchTriplets(vecLambda, vecProton, false, looseLimit, tightLimit, skipPLL, signalLooseLimit[cf_trigger::kPLL], signalTightLimit[cf_trigger::kPLL]);
+        searchTriplets(vecAntiLambda, vecAntiProton, false, looseLimit, tightLimit, skipAntiPLL, signalLooseLimit[cf_trigger::kPLL], signalTightLimit[cf_trigger::kPLL]);
+      }
+      if (TriggerSelections.filterSwitches->get("Switch", "LLL") > 0) {
+        float looseLimit = TriggerSelections.limits->get("Loose Limit", "LLL");
+        float tightLimit = TriggerSelections.limits->get("Tight Limit", "LLL");
+        searchTriplets(vecLambda, vecLambda, true, looseLimit, tightLimit, skipLLL, signalLooseLimit[cf_trigger::kLLL], signalTightLimit[cf_trigger::kLLL]);
+        searchTriplets(vecAntiLambda, vecAntiLambda, true, looseLimit, tightLimit, skipAntiLLL, signalLooseLimit[cf_trigger::kLLL], signalTightLimit[cf_trigger::kLLL]);
+      }
+    }
+
     // PPPhi
     if (TriggerSelections.filterSwitches->get("Switch", "PPPhi") > 0) {
       for (size_t p1 = 0; p1 < vecProton.size(); p1++) {
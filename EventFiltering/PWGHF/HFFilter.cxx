@@ -264,6 +264,26 @@ struct HfFilter { // Main struct for HF triggers
   // helper object
   HfFilterHelper helper;
 
+  // tracks associated to the current collision, propagated to its primary vertex and preselected as bachelors once for all the charm candidates
+  struct BachelorTrack {
+    int64_t trackId{-1};
+    o2::track::TrackParCov trackPar{};
+    std::array<float, 2> dca{};
+    std::array<float, 3> pVec{};
+    int16_t selBeauty3P{kRejected}; // isSelectedTrackForSoftPionOrBeauty<kBeauty3P>
+    int16_t selBeauty4P{kRejected}; // isSelectedTrackForSoftPionOrBeauty<kBeauty4P>
+    int16_t selBtoJPsi{kRejected};  // isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>, same for all B -> J/psi channels
+  };
+  std::vector<BachelorTrack> bachelorTracks{};
+  bool areBachelorTracksFilled{false};
+
+  // vertex of the current charm-hadron candidate, fitted once for all the beauty hypotheses
+  struct CharmVertex {
+    bool isFitted{false};
+    int nVtx{0};
+    o2::track::TrackParCov trackPar{}; // charm-hadron track at the secondary vertex
+  };
+
   HistogramRegistry registry{"registry"};
 
   void init(InitContext& initContext)
@@ -470,6 +490,60 @@ struct HfFilter { // Main struct for HF triggers
     thresholdBDTScores = {thresholdsBDT.thresholdBDTScoreD0ToKPi, thresholdsBDT.thresholdBDTScoreDPlusToPiKPi, thresholdsBDT.thresholdBDTScoreDSToPiKK, thresholdsBDT.thresholdBDTScoreLcToPiKP, thresholdsBDT.thresholdBDTScoreXicToPiKP};
   }
 
+  /// Propagates the tracks associated to the collision to its primary vertex and computes their beauty bachelor selections, once per collision
+  /// \param collision is the collision
+  /// \param trackIdsThisCollision are the indices of the tracks associated to the collision
+  /// \param tracks is the track table
+  template <typename Coll, typename TrackIds, typename Tracks>
+  void fillBachelorTracks(Coll const& collision, TrackIds const& trackIdsThisCollision, Tracks const& tracks)
+  {
+    if (areBachelorTracksFilled) {
+      return;
+    }
+    areBachelorTracksFilled = true;
+    bachelorTracks.clear();
+    bachelorTracks.reserve(trackIdsThisCollision.size());
+    for (const auto& trackId : trackIdsThisCollision) {
+      auto track = tracks.rawIteratorAt(trackId.trackId());
+      auto& bachelor = bachelorTracks.emplace_back();
+      bachelor.trackId = trackId.trackId();
+      bachelor.trackPar = getTrackParCov(track);
+      bachelor.dca = {track.dcaXY(), track.dcaZ()};
+      bachelor.pVec = track.pVector();
+      if (track.collisionId() != collision.globalIndex()) {
+        o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, bachelor.trackPar, 2.f, noMatCorr, &bachelor.dca);
+        getPxPyPz(bachelor.trackPar, bachelor.pVec);
+      }
+      bachelor.selBeauty3P = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty3P>(track, bachelor.trackPar, bachelor.dca);
+      bachelor.selBeauty4P = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty4P>(track, bachelor.trackPar, bachelor.dca);
+      bachelor.selBtoJPsi = helper.isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>(track, bachelor.trackPar, bachelor.dca);
+    }
+  }
+
+  /// Fits the vertex of the charm-hadron candidate at the first call and keeps it for the following beauty hypotheses
+  /// \param vertex is the vertex of the current charm-hadron candidate
+  /// \param fitter is the DCA fitter for the charm-hadron vertex
+  /// \param charge is the absolute charge assigned to the charm-hadron track
+  /// \param trackPars are the track parameters of the charm-hadron daughters
+  template <typename Fitter, typename... TrackPars>
+  void fitCharmVertex(CharmVertex& vertex, Fitter& fitter, int charge, TrackPars const&... trackPars)
+  {
+    if (vertex.isFitted) {
+      return;
+    }
+    vertex.isFitted = true;
+    try {
+      vertex.nVtx = fitter.process(trackPars...);
+    } catch (...) {
+      LOG(error) << "Exception caught in DCA fitter process call for charm " << sizeof...(TrackPars) << "-prong!";
+      vertex.nVtx = 0;
+    }
+    if (vertex.nVtx != 0) {
+      vertex.trackPar = fitter.createParentTrackParCov();
+      vertex.trackPar.setAbsCharge(charge); // to be sure
+    }
+  }
+
   void process(CollsWithEvSel const& collisions,
                aod::BCsWithTimestamps const&,
                aod::V0s const& v0s,
@@ -483,6 +557,8 @@ struct HfFilter { // Main struct for HF triggers
                aod::V0PhotonsKF const& photons,
                aod::V0Legs const&)
   {
+    auto tracksWithItsPid = soa::Attach<BigTracksPID, aod::pidits::ITSNSigmaPr, aod::pidits::ITSNSigmaDe>(tracks);
+
     for (const auto& collision : collisions) {
 
       // all processed collisions
@@ -535,6 +611,10 @@ struct HfFilter { // Main struct for HF triggers
         currentRun = bc.runNumber();
       }
 
+      // tracks associated to this collision, propagated to its primary vertex at the first charm candidate looking for bachelors
+      auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
+      areBachelorTracksFilled = false;
+
       std::vector<std::vector<int64_t>> indicesDau2Prong{}, indicesDau2ProngPrompt{};
 
       auto cand2ProngsThisColl = cand2Prongs.sliceBy(hf2ProngPerCollision, thisCollId);
@@ -640,26 +720,22 @@ struct HfFilter { // Main struct for HF triggers
           massD0BarCand = RecoDecay::m(std::array{pVecPos, pVecNeg}, std::array{massKa, massPi});
         }
 
-        auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
-        auto tracksWithItsPid = soa::Attach<BigTracksPID, aod::pidits::ITSNSigmaPr, aod::pidits::ITSNSigmaDe>(tracks);
-        for (const auto& trackId : trackIdsThisCollision) { // start loop over tracks
-          auto track = tracksWithItsPid.rawIteratorAt(trackId.trackId());
+        CharmVertex charmVertex2Prong{};
+        fillBachelorTracks(collision, trackIdsThisCollision, tracksWithItsPid);
+        for (const auto& bachelor : bachelorTracks) { // start loop over tracks
+          auto track = tracksWithItsPid.rawIteratorAt(bachelor.trackId);
 
           if (track.globalIndex() == trackPos.globalIndex() || track.globalIndex() == trackNeg.globalIndex()) {
             continue;
           }
 
-          auto trackParThird = getTrackParCov(track);
-          std::array<float, 2> dcaThird{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecThird = track.pVector();
-          if (track.collisionId() != thisCollId) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParThird, 2.f, noMatCorr, &dcaThird);
-            getPxPyPz(trackParThird, pVecThird);
-          }
+          const auto& trackParThird = bachelor.trackPar;
+          const auto& dcaThird = bachelor.dca;
+          const auto& pVecThird = bachelor.pVec;
 
           // Beauty with D0
           if (!keepEvent[kBeauty3P] && isD0BeautyTagged) {
-            int16_t isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty3P>(track, trackParThird, dcaThird);
+            int16_t isTrackSelected = bachelor.selBeauty3P;
             if (TESTBIT(isTrackSelected, kForBeauty) && ((TESTBIT(selD0InMass, 0) && track.sign() < 0) || (TESTBIT(selD0InMass, 1) && track.sign() > 0))) { // D0 pi-/K- and D0bar pi+/K+
               auto massCandD0Pi = RecoDecay::m(std::array{pVec2Prong, pVecThird}, std::array{massD0, massPi});
               auto massCandD0K = RecoDecay::m(std::array{pVec2Prong, pVecThird}, std::array{massD0, massKa});
@@ -688,20 +764,10 @@ struct HfFilter { // Main struct for HF triggers
                       hMassVsPtB[kBc]->Fill(ptCand, massCandD0K);
                   }
                 } else {
-                  int nVtxD{0};
-                  try {
-                    nVtxD = df2.process(trackParPos, trackParNeg);
-                  } catch (...) {
-                    LOG(error) << "Exception caught in DCA fitter process call for charm 2-prong!";
-                    nVtxD = 0;
-                  }
-                  if (nVtxD != 0) {
-                    std::array<float, 3> pVecPosVtx{}, pVecNegVtx{};
-                    df2.getTrack(0).getPxPyPzGlo(pVecPosVtx);
-                    df2.getTrack(1).getPxPyPzGlo(pVecNegVtx);
-                    auto trackParD = df2.createParentTrackParCov();
-                    trackParD.setAbsCharge(0); // to be sure
-                    auto pVec2ProngVtx = RecoDecay::pVec(pVecPosVtx, pVecNegVtx);
+                  fitCharmVertex(charmVertex2Prong, df2, 0, trackParPos, trackParNeg);
+                  if (charmVertex2Prong.nVtx != 0) {
+                    auto trackParD = charmVertex2Prong.trackPar;
+                    std::array<float, 3> pVec2ProngVtx{};
                     int nVtxB{0};
                     try {
                       nVtxB = dfB.process(trackParD, trackParThird);
@@ -766,20 +832,16 @@ struct HfFilter { // Main struct for HF triggers
                 if (activateQA) {
                   hMassVsPtC[kNCharmParticles]->Fill(ptCand, massDiffDstar);
                 }
-                for (const auto& trackIdB : trackIdsThisCollision) { // start loop over tracks
-                  auto trackB = tracks.rawIteratorAt(trackIdB.trackId());
+                for (const auto& bachelorB : bachelorTracks) { // start loop over tracks
+                  auto trackB = tracks.rawIteratorAt(bachelorB.trackId);
                   if (track.globalIndex() == trackB.globalIndex()) {
                     continue;
                   }
-                  auto trackParFourth = getTrackParCov(trackB);
-                  std::array<float, 2> dcaFourth{trackB.dcaXY(), trackB.dcaZ()};
-                  std::array<float, 3> pVecFourth = trackB.pVector();
-                  if (trackB.collisionId() != thisCollId) {
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-                    getPxPyPz(trackParFourth, pVecFourth);
-                  }
+                  const auto& trackParFourth = bachelorB.trackPar;
+                  const auto& dcaFourth = bachelorB.dca;
+                  const auto& pVecFourth = bachelorB.pVec;
 
-                  auto isTrackFourthSelected = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty3P>(trackB, trackParFourth, dcaFourth);
+                  auto isTrackFourthSelected = bachelorB.selBeauty3P;
                   if (track.sign() * trackB.sign() < 0 && TESTBIT(isTrackFourthSelected, kForBeauty)) {
                     auto massCandB0 = RecoDecay::m(std::array{pVecBeauty3Prong, pVecFourth}, std::array{massDStar, massPi});
                     auto pVecBeauty4Prong = RecoDecay::pVec(pVec2Prong, pVecThird, pVecFourth);
@@ -798,23 +860,12 @@ struct HfFilter { // Main struct for HF triggers
                           hMassVsPtB[kB0toDStar]->Fill(ptCandBeauty4Prong, massCandB0);
                         }
                       } else {
-                        int nVtxD{0};
-                        try {
-                          nVtxD = df2.process(trackParPos, trackParNeg);
-                        } catch (...) {
-                          LOG(error) << "Exception caught in DCA fitter process call for charm 2-prong!";
-                          nVtxD = 0;
-                        }
-                        if (nVtxD > 0) {
-                          std::array<float, 3> pVecPosVtx{}, pVecNegVtx{};
-                          df2.getTrack(0).getPxPyPzGlo(pVecPosVtx);
-                          df2.getTrack(1).getPxPyPzGlo(pVecNegVtx);
-                          auto trackParD = df2.createParentTrackParCov();
-                          trackParD.setAbsCharge(0); // to be sure
-                          auto pVec2ProngVtx = RecoDecay::pVec(pVecPosVtx, pVecNegVtx);
+                        fitCharmVertex(charmVertex2Prong, df2, 0, trackParPos, trackParNeg);
+                        if (charmVertex2Prong.nVtx > 0) {
+                          std::array<float, 3> pVec2ProngVtx{};
                           int nVtxB{0};
                           try {
-                            nVtxB = dfBtoDstar.process(trackParD, trackParThird, trackParFourth);
+                            nVtxB = dfBtoDstar.process(charmVertex2Prong.trackPar, trackParThird, trackParFourth);
                           } catch (...) {
                             LOG(error) << "Exception caught in DCA fitter process call for beauty to D*!";
                             nVtxB = 0;
@@ -886,7 +937,7 @@ struct HfFilter { // Main struct for HF triggers
 
           // Beauty with JPsi
           if (preselJPsiToMuMu) {
-            if (!TESTBIT(helper.isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>(track, trackParThird, dcaThird), kForBeauty)) { // same for all channels
+            if (!TESTBIT(bachelor.selBtoJPsi, kForBeauty)) { // same for all channels
               continue;
             }
             std::array<float, 3> pVecPosVtx{}, pVecNegVtx{}, pVecThirdVtx{}, pVecFourthVtx{};
@@ -915,22 +966,16 @@ struct HfFilter { // Main struct for HF triggers
             }
             // 4-prong vertices
             if (!keepEvent[kBtoJPsiKstar] || !keepEvent[kBtoJPsiPhi] || !keepEvent[kBtoJPsiPrKa]) {
-              for (const auto& trackIdB : trackIdsThisCollision) { // start loop over tracks
+              for (const auto& bachelorB : bachelorTracks) { // start loop over tracks
                 if (keepEvent[kBtoJPsiKstar] && keepEvent[kBtoJPsiPhi] && keepEvent[kBtoJPsiPrKa]) {
                   break;
                 }
-                auto trackFourth = tracksWithItsPid.rawIteratorAt(trackIdB.trackId());
+                auto trackFourth = tracksWithItsPid.rawIteratorAt(bachelorB.trackId);
                 if (trackFourth.globalIndex() == track.globalIndex() || trackFourth.globalIndex() == trackPos.globalIndex() || trackFourth.globalIndex() == trackNeg.globalIndex() || trackFourth.sign() * track.sign() > 0) {
                   continue;
                 }
-                auto trackParFourth = getTrackParCov(trackFourth);
-                std::array<float, 2> dcaFourth{trackFourth.dcaXY(), trackFourth.dcaZ()};
-                std::array<float, 3> pVecFourth = trackFourth.pVector();
-                if (trackFourth.collisionId() != thisCollId) {
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-                  getPxPyPz(trackParFourth, pVecFourth);
-                }
-                if (!TESTBIT(helper.isSelectedTrackForSoftPionOrBeauty<kBtoJPsiKa>(trackFourth, trackParFourth, dcaFourth), kForBeauty)) { // same for all channels
+                const auto& trackParFourth = bachelorB.trackPar;
+                if (!TESTBIT(bachelorB.selBtoJPsi, kForBeauty)) { // same for all channels
                   continue;
                 }
                 int nVtxB{0};
@@ -1027,19 +1072,15 @@ struct HfFilter { // Main struct for HF triggers
             if (!keepEvent[kV0Charm2P] && TESTBIT(selV0, kK0S)) {
 
               // we first look for a D*+
-              for (const auto& trackBachelorId : trackIdsThisCollision) { // start loop over tracks
-                auto trackBachelor = tracks.rawIteratorAt(trackBachelorId.trackId());
+              for (const auto& bachelor : bachelorTracks) { // start loop over tracks
+                auto trackBachelor = tracks.rawIteratorAt(bachelor.trackId);
                 if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex() || trackBachelor.globalIndex() == v0.posTrackId() || trackBachelor.globalIndex() == v0.negTrackId()) {
                   continue;
                 }
 
-                auto trackParBachelor = getTrackPar(trackBachelor);
-                std::array<float, 2> dcaBachelor{trackBachelor.dcaXY(), trackBachelor.dcaZ()};
-                std::array<float, 3> pVecBachelor = trackBachelor.pVector();
-                if (trackBachelor.collisionId() != thisCollId) {
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelor, 2.f, noMatCorr, &dcaBachelor);
-                  getPxPyPz(trackParBachelor, pVecBachelor);
-                }
+                const auto& trackParBachelor = bachelor.trackPar;
+                const auto& dcaBachelor = bachelor.dca;
+                const auto& pVecBachelor = bachelor.pVec;
 
                 auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kV0Charm2P>(trackBachelor, trackParBachelor, dcaBachelor);
                 if (TESTBIT(isTrackSelected, kSoftPion) && ((TESTBIT(selD0InMass, 0) && trackBachelor.sign() > 0) || (TESTBIT(selD0InMass, 1) && trackBachelor.sign() < 0))) {
@@ -1140,21 +1181,17 @@ struct HfFilter { // Main struct for HF triggers
             if (isSelPIDProton) {
               if (!keepEvent[kPrCharm2P]) {
                 // we first look for a D*+
-                for (const auto& trackBachelorId : trackIdsThisCollision) { // start loop over tracks to find bachelor pion
+                for (const auto& bachelor : bachelorTracks) { // start loop over tracks to find bachelor pion
                   if (!helper.isSelectedProtonFromLcResoOrThetaC<true>(trackProton)) {
                     continue;
                   } // stop here if proton below pT threshold for thetaC to avoid computational losses
-                  auto trackBachelor = tracks.rawIteratorAt(trackBachelorId.trackId());
+                  auto trackBachelor = tracks.rawIteratorAt(bachelor.trackId);
                   if (trackBachelor.globalIndex() == trackPos.globalIndex() || trackBachelor.globalIndex() == trackNeg.globalIndex() || trackBachelor.globalIndex() == trackProton.globalIndex()) {
                     continue;
                   }
-                  auto trackParBachelor = getTrackPar(trackBachelor);
-                  std::array<float, 2> dcaBachelor{trackBachelor.dcaXY(), trackBachelor.dcaZ()};
-                  std::array<float, 3> pVecBachelor = trackBachelor.pVector();
-                  if (trackBachelor.collisionId() != thisCollId) {
-                    o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParBachelor, 2.f, noMatCorr, &dcaBachelor);
-                    getPxPyPz(trackParBachelor, pVecBachelor);
-                  }
+                  const auto& trackParBachelor = bachelor.trackPar;
+                  const auto& dcaBachelor = bachelor.dca;
+                  const auto& pVecBachelor = bachelor.pVec;
                   auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kPrCharm2P>(trackBachelor, trackParBachelor, dcaBachelor);
                   if (TESTBIT(isTrackSelected, kSoftPion) && ((TESTBIT(selD0InMass, 0) && trackBachelor.sign() > 0) || (TESTBIT(selD0InMass, 1) && trackBachelor.sign() < 0))) {
                     if (pt2Prong < cutsPtDeltaMassCharmReso->get(3u, 12u)) {
@@ -1428,27 +1465,22 @@ struct HfFilter { // Main struct for HF triggers
           }
         } // end high-pT selection
 
-        auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
-        auto tracksWithItsPid = soa::Attach<BigTracksPID, aod::pidits::ITSNSigmaPr, aod::pidits::ITSNSigmaDe>(tracks);
-
-        for (const auto& trackId : trackIdsThisCollision) { // start loop over track indices as associated to this collision in HF code
-          auto track = tracksWithItsPid.rawIteratorAt(trackId.trackId());
+        CharmVertex charmVertex3Prong{};
+        fillBachelorTracks(collision, trackIdsThisCollision, tracksWithItsPid);
+        for (const auto& bachelor : bachelorTracks) { // start loop over track indices as associated to this collision in HF code
+          auto track = tracksWithItsPid.rawIteratorAt(bachelor.trackId);
           if (track.globalIndex() == trackFirst.globalIndex() || track.globalIndex() == trackSecond.globalIndex() || track.globalIndex() == trackThird.globalIndex()) {
             continue;
           }
 
-          auto trackParFourth = getTrackParCov(track);
-          std::array<float, 2> dcaFourth{track.dcaXY(), track.dcaZ()};
-          std::array<float, 3> pVecFourth = track.pVector();
-          if (track.collisionId() != thisCollId) {
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParFourth, 2.f, noMatCorr, &dcaFourth);
-            getPxPyPz(trackParFourth, pVecFourth);
-          }
+          const auto& trackParFourth = bachelor.trackPar;
+          const auto& dcaFourth = bachelor.dca;
+          const auto& pVecFourth = bachelor.pVec;
 
           int charmParticleID[kNBeautyParticles - 3] = {o2::constants::physics::Pdg::kDPlus, o2::constants::physics::Pdg::kDS, o2::constants::physics::Pdg::kLambdaCPlus, o2::constants::physics::Pdg::kXiCPlus};
 
           float massCharmHypos[kNBeautyParticles - 3] = {massDPlus, massDs, massLc, massXic};
-          auto isTrackSelected = helper.isSelectedTrackForSoftPionOrBeauty<kBeauty4P>(track, trackParFourth, dcaFourth);
+          auto isTrackSelected = bachelor.selBeauty4P;
           if (track.sign() * sign3Prong < 0 && TESTBIT(isTrackSelected, kForBeauty)) {
             for (int iHypo{0}; iHypo < kNBeautyParticles - 3 && !keepEvent[kBeauty4P]; ++iHypo) {
               if (isBeautyTagged[iHypo] && (TESTBIT(is3ProngInMass[iHypo], 0) || TESTBIT(is3ProngInMass[iHypo], 1))) {
@@ -1468,21 +1500,10 @@ struct HfFilter { // Main struct for HF triggers
                       hMassVsPtB[iHypo + 3]->Fill(ptCandBeauty4Prong, massCandB);
                     }
                   } else {
-                    int nVtxD{0};
-                    try {
-                      nVtxD = df3.process(trackParFirst, trackParSecond, trackParThird);
-                    } catch (...) {
-                      LOG(error) << "Exception caught in DCA fitter process call for charm 3-prong!";
-                      nVtxD = 0;
-                    }
-                    if (nVtxD != 0) {
-                      std::array<float, 3> pVecFirstVtx{}, pVecSecondVtx{}, pVecThirdVtx{};
-                      df3.getTrack(0).getPxPyPzGlo(pVecFirstVtx);
-                      df3.getTrack(1).getPxPyPzGlo(pVecSecondVtx);
-                      df3.getTrack(1).getPxPyPzGlo(pVecThirdVtx);
-                      auto trackParD = df3.createParentTrackParCov();
-                      trackParD.setAbsCharge(sign3Prong); // to be sure
-                      auto pVec3ProngVtx = RecoDecay::pVec(pVecFirstVtx, pVecSecondVtx, pVecThirdVtx);
+                    fitCharmVertex(charmVertex3Prong, df3, sign3Prong, trackParFirst, trackParSecond, trackParThird);
+                    if (charmVertex3Prong.nVtx != 0) {
+                      auto trackParD = charmVertex3Prong.trackPar;
+                      std::array<float, 3> pVec3ProngVtx{};
                       int nVtxB{0};
                       try {
                         nVtxB = dfB.process(trackParD, trackParFourth);
@@ -1569,10 +1590,10 @@ struct HfFilter { // Main struct for HF triggers
             // we need a candidate Lc->pKpi and a candidate soft kaon, and also need a candidate of proton for sigmaC correlation
 
             // look for SigmaC++ candidates
-            for (const auto& trackSoftPiId : trackIdsThisCollision) { // start loop over tracks (soft pi)
+            for (const auto& softPi : bachelorTracks) { // start loop over tracks (soft pi)
 
               // soft pion candidates
-              auto trackSoftPi = tracks.rawIteratorAt(trackSoftPiId.trackId());
+              auto trackSoftPi = tracks.rawIteratorAt(softPi.trackId);
               auto globalIndexSoftPi = trackSoftPi.globalIndex();
 
               // exclude tracks already used to build the 3-prong candidate
@@ -1590,15 +1611,10 @@ struct HfFilter { // Main struct for HF triggers
               int chargeSc = std::accumulate(chargesSc.begin(), chargesSc.end(), 0); // SIGNED electric charge of SigmaC candidate
 
               // select soft pion candidates
-              auto trackParSoftPi = getTrackPar(trackSoftPi);
-              std::array<float, 2> dcaSoftPi{trackSoftPi.dcaXY(), trackSoftPi.dcaZ()};
-              std::array<float, 3> pVecSoftPi = trackSoftPi.pVector();
-              if (trackSoftPi.collisionId() != thisCollId) {
-                // This is a track reassociated to this PV by the track-to-collision-associator
-                // Let's propagate this track to it, and calculate dcaXY, dcaZ
-                o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParSoftPi, 2.f, noMatCorr, &dcaSoftPi);
-                getPxPyPz(trackParSoftPi, pVecSoftPi);
-              }
+              // tracks reassociated to this PV by the track-to-collision-associator are already propagated to it
+              const auto& trackParSoftPi = softPi.trackPar;
+              const auto& dcaSoftPi = softPi.dca;
+              const auto& pVecSoftPi = softPi.pVec;
               int16_t isSoftPionSelected = helper.isSelectedTrackForSoftPionOrBeauty<kSigmaCPPK>(trackSoftPi, trackParSoftPi, dcaSoftPi);
               if (TESTBIT(isSoftPionSelected, kSoftPionForSigmaC) /*&& (TESTBIT(is3Prong[2], 0) || TESTBIT(is3Prong[2], 1))*/) {
 
@@ -1783,10 +1799,10 @@ struct HfFilter { // Main struct for HF triggers
             // we pair SigmaC0 with V0
             if (!keepEvent[kSigmaC0K0] && (isGoodLcToPKPi || isGoodLcToPiKP) && TESTBIT(selV0, kK0S)) {
               // look for SigmaC0 candidates
-              for (const auto& trackSoftPiId : trackIdsThisCollision) { // start loop over tracks (soft pi)
+              for (const auto& softPi : bachelorTracks) { // start loop over tracks (soft pi)
 
                 // soft pion candidates
-                auto trackSoftPi = tracks.rawIteratorAt(trackSoftPiId.trackId());
+                auto trackSoftPi = tracks.rawIteratorAt(softPi.trackId);
                 auto globalIndexSoftPi = trackSoftPi.globalIndex();
 
                 // exclude tracks already used to build the 3-prong candidate
@@ -1803,15 +1819,10 @@ struct HfFilter { // Main struct for HF triggers
                 }
 
                 // select soft pion candidates
-                auto trackParSoftPi = getTrackPar(trackSoftPi);
-                std::array<float, 2> dcaSoftPi{trackSoftPi.dcaXY(), trackSoftPi.dcaZ()};
-                std::array<float, 3> pVecSoftPi = trackSoftPi.pVector();
-                if (trackSoftPi.collisionId() != thisCollId) {
-                  // This is a track reassociated to this PV by the track-to-collision-associator
-                  // Let's propagate this track to it, and calculate dcaXY, dcaZ
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParSoftPi, 2.f, noMatCorr, &dcaSoftPi);
-                  getPxPyPz(trackParSoftPi, pVecSoftPi);
-                }
+                // tracks reassociated to this PV by the track-to-collision-associator are already propagated to it
+                const auto& trackParSoftPi = softPi.trackPar;
+                const auto& dcaSoftPi = softPi.dca;
+                const auto& pVecSoftPi = softPi.pVec;
                 int16_t isSoftPionSelected = helper.isSelectedTrackForSoftPionOrBeauty<kSigmaC0K0>(trackSoftPi, trackParSoftPi, dcaSoftPi);
                 if (TESTBIT(isSoftPionSelected, kSoftPionForSigmaC) /*&& (TESTBIT(is3Prong[2], 0) || TESTBIT(is3Prong[2], 1))*/) {
 
@@ -1926,7 +1937,6 @@ struct HfFilter { // Main struct for HF triggers
             o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParCascTrack, 2.f, matCorr, &dcaInfo);
           }
 
-          auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, thisCollId);
           for (const auto& trackId : trackIdsThisCollision) { // start loop over tracks (first bachelor)
             auto track = tracks.rawIteratorAt(trackId.trackId());
 
@@ -39,7 +39,9 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
@@ -85,6 +87,23 @@ bool readJsonFile(std::string& config, Document& d)
   return true;
 }
 
+/// Reads nBits (<= 64) bits of an Arrow bitmap (least significant bit first) starting at bit position pos
+uint64_t readBitmapWord(const uint8_t* bitmap, int64_t pos, int nBits)
+{
+  const uint8_t* bytes{bitmap + pos / 8};
+  const int shift{static_cast<int>(pos % 8)};
+  const int nBytes{(shift + nBits + 7) / 8};
+  uint64_t word{0ull};
+  for (int iB{0}; iB < std::min(nBytes, 8); ++iB) {
+    word |= static_cast<uint64_t>(bytes[iB]) << (8 * iB);
+  }
+  word >>= shift;
+  if (nBytes > 8) {
+    word |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+  }
+  return nBits < 64 ? word & ((1ull << nBits) - 1) : word;
+}
+
 std::unordered_map<std::string, std::unordered_map<std::string, float>> mDownscaling;
 static const std::vector<std::string> downscalingName{"Downscaling"};
 static const float defaultDownscaling[128][1]{
@@ -328,6 +347,8 @@ struct centralEventFilterTask {
 
     int64_t nEvents{collTabPtr->num_rows()};
     std::vector<std::array<uint64_t, 2>> outTrigger, outDecision;
+    // Counts are accumulated per DF and only flushed to the histograms at the end
+    std::vector<uint64_t> scalerCounts(mScalers->GetNbinsX() + 2, 0ull), filteredCounts(mFiltered->GetNbinsX() + 2, 0ull);
     for (auto& tableName : mDownscaling) {
       if (!pc.inputs().isValid(tableName.first)) {
         LOG(fatal) << tableName.first << " table is not valid.";
@@ -347,7 +368,6 @@ struct centralEventFilterTask {
       auto schema{tablePtr->schema()};
       for (auto& colName : tableName.second) {
         uint64_t bin{static_cast<uint64_t>(mScalers->GetXaxis()->FindBin(colName.first.data()))};
-        double binCenter{mScalers->GetXaxis()->GetBinCenter(bin)};
         uint64_t decisionBin{(bin - 2) / 64};
         uint64_t triggerBit{BIT((bin - 2) % 64)};
         auto column{tablePtr->GetColumnByName(colName.first)};
@@ -357,17 +377,21 @@ struct centralEventFilterTask {
           for (int64_t iC{0}; iC < column->num_chunks(); ++iC) {
             auto chunk{column->chunk(iC)};
             auto boolArray = std::static_pointer_cast<arrow::BooleanArray>(chunk);
-            for (int64_t iS{startCollision}; iS < chunk->length(); ++iS) {
-              if (boolArray->Value(iS)) {
-                mScalers->Fill(binCenter);
-                outTrigger[entry][decisionBin] |= triggerBit;
+            // scan the value bitmap one word at a time, visiting only the fired events (in increasing order, keeping the sequence of random draws)
+            const uint8_t* bitmap{boolArray->values()->data()};
+            for (int64_t iW{startCollision}; iW < chunk->length(); iW += 64) {
+              const int nBits{static_cast<int>(std::min<int64_t>(64, chunk->length() - iW))};
+              for (uint64_t word{readBitmapWord(bitmap, boolArray->offset() + iW, nBits)}; word; word &= word - 1) {
+                const int64_t iEntry{entry + iW - startCollision + std::countr_zero(word)};
+                scalerCounts[bin]++;
+                outTrigger[iEntry][decisionBin] |= triggerBit;
                 if (mUniformGenerator(mGeneratorEngine) < downscaling) {
-                  mFiltered->Fill(binCenter);
-                  outDecision[entry][decisionBin] |= triggerBit;
+                  filteredCounts[bin]++;
+                  outDecision[iEntry][decisionBin] |= triggerBit;
                 }
               }
-              entry++;
             }
+            entry += chunk->length() - startCollision;
           }
         }
       }
@@ -375,34 +399,62 @@ struct centralEventFilterTask {
     mScalers->SetBinContent(1, mScalers->GetBinContent(1) + nEvents - startCollision);
     mFiltered->SetBinContent(1, mFiltered->GetBinContent(1) + nEvents - startCollision);
 
+    constexpr int NTriggerBits{128};
+    std::vector<uint64_t> covarianceCounts(NTriggerBits * NTriggerBits, 0ull);
+    uint64_t nTriggered{0ull}, nSelected{0ull};
+    std::array<int, NTriggerBits> firedBits;
     for (uint64_t iE{0}; iE < outTrigger.size(); ++iE) {
       const auto& triggerWord{outTrigger[iE]};
-      bool triggered{false}, selected{false};
+      int nFired{0};
       for (uint64_t iD{0}; iD < triggerWord.size(); ++iD) {
-        for (int iB{0}; iB < 64; ++iB) {
-          if (!(triggerWord[iD] & BIT(iB))) {
-            continue;
-          }
-          uint64_t xIndex{iD * 64 + iB};
-          for (uint64_t jD{0}; jD < triggerWord.size(); ++jD) {
-            for (int jB{0}; jB < 64; ++jB) {
-              uint64_t yIndex{jD * 64 + jB};
-              if (xIndex <= yIndex && triggerWord[jD] & BIT(jB)) {
-                mCovariance->Fill(iD * 64 + iB, jD * 64 + jB);
-              }
-            }
-          }
+        for (uint64_t word{triggerWord[iD]}; word; word &= word - 1) {
+          firedBits[nFired++] = iD * 64 + std::countr_zero(word);
         }
-        triggered = triggered || triggerWord[iD];
-        selected = selected || outDecision[iE][iD];
       }
-      if (triggered) {
-        mScalers->Fill(mScalers->GetNbinsX() - 1);
+      for (int iF{0}; iF < nFired; ++iF) {
+        for (int jF{iF}; jF < nFired; ++jF) {
+          covarianceCounts[firedBits[iF] * NTriggerBits + firedBits[jF]]++;
+        }
       }
-      if (selected) {
-        mFiltered->Fill(mFiltered->GetNbinsX() - 1);
+      nTriggered += nFired > 0;
+      nSelected += outDecision[iE][0] || outDecision[iE][1];
+    }
+
+    // add the counts as bin contents rather than weighted fills, which would enable Sumw2 on the scalers,
+    // then set entries and statistics to what one unit fill per fired event would have given
+    double nScalerEntries{mScalers->GetEntries()}, nFilteredEntries{mFiltered->GetEntries()}, nCovarianceEntries{mCovariance->GetEntries()};
+    for (int iBin{0}; iBin < static_cast<int>(scalerCounts.size()); ++iBin) {
+      if (scalerCounts[iBin]) {
+        mScalers->AddBinContent(iBin, scalerCounts[iBin]);
+        nScalerEntries += scalerCounts[iBin];
       }
+      if (filteredCounts[iBin]) {
+        mFiltered->AddBinContent(iBin, filteredCounts[iBin]);
+        nFilteredEntries += filteredCounts[iBin];
+      }
+    }
+    for (int xIndex{0}; xIndex < NTriggerBits; ++xIndex) {
+      for (int yIndex{xIndex}; yIndex < NTriggerBits; ++yIndex) {
+        if (covarianceCounts[xIndex * NTriggerBits + yIndex]) {
+          mCovariance->AddBinContent(mCovariance->FindBin(xIndex, yIndex), covarianceCounts[xIndex * NTriggerBits + yIndex]);
+          nCovarianceEntries += covarianceCounts[xIndex * NTriggerBits + yIndex];
+        }
+      }
+    }
+    if (nTriggered) {
+      mScalers->AddBinContent(mScalers->FindBin(mScalers->GetNbinsX() - 1), nTriggered);
+      nScalerEntries += nTriggered;
+    }
+    if (nSelected) {
+      mFiltered->AddBinContent(mFiltered->FindBin(mFiltered->GetNbinsX() - 1), nSelected);
+      nFilteredEntries += nSelected;
     }
+    mScalers->ResetStats();
+    mScalers->SetEntries(nScalerEntries);
+    mFiltered->ResetStats();
+    mFiltered->SetEntries(nFilteredEntries);
+    mCovariance->ResetStats();
+    mCovariance->SetEntries(nCovarianceEntries);
 
     if (outDecision.size() != static_cast<uint64_t>(nEvents)) {
       LOGF(fatal, "Inconsistent number of rows across Collision table and CEFP decision vector.");
@@ -23,12 +23,13 @@
 #include <TLorentzVector.h>
 #include <TVector3.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
-#include <string>
 #include <vector>
 
 #define THETA(eta) 2.0 * std::atan(std::exp(-eta))
@@ -95,24 +96,39 @@ inline std::unique_ptr<double[]> calc_var_bins(const int& N, const float& xmax,
 
 namespace o2::aod::singletrackselector
 {
+// bin [binning[bin], binning[bin + 1]) containing the value, found with a binary search over the (sorted) bin edges,
+// and the sub-bin containing the value when each bin is divided into NsubBins; returns false if the value is outside the binning
+inline bool getBinAndSubBin(float const& value, std::vector<float> const& binning, int const& NsubBins, int& bin, int& subBin)
+{
+  auto upperEdge = std::upper_bound(binning.begin(), binning.end(), value);
+  if (upperEdge == binning.begin() || upperEdge == binning.end())
+    return false;
+
+  bin = upperEdge - binning.begin() - 1;
+  subBin = 0;
+  if (NsubBins > 1) {
+    float subBinWidth = (binning[bin + 1] - binning[bin]) / NsubBins;
+    subBin = std::floor((value - binning[bin]) / subBinWidth);
+  }
+  return true;
+}
+
 template <typename Type>
 Type getBinIndex(float const& value, std::vector<float> const& binning, int const& NsubBins = 1)
 {
   Type res = 10e6;
-  for (unsigned int i = 0; i < binning.size() - 1; i++) {
-    if (value >= binning[i] && binning[i + 1] > value) {
-      if (NsubBins < 2) {
-        res = (Type)i;
-        break;
-      } else {
-        float subBinWidth = (binning[i + 1] - binning[i]) / NsubBins;
-        int subBin = std::floor((value - binning[i]) / subBinWidth);
-        int delimeter = std::pow(10, std::to_string(NsubBins).size());
-
-        res = (Type)i + (Type)subBin / delimeter;
-        break;
-      }
-    }
+  int bin = 0, subBin = 0;
+  if (!getBinAndSubBin(value, binning, NsubBins, bin, subBin))
+    return res;
+
+  if (NsubBins < 2) {
+    res = (Type)bin;
+  } else {
+    int delimeter = 10; // 10^(number of digits of NsubBins)
+    for (int n = NsubBins; n >= 10; n /= 10)
+      delimeter *= 10;
+
+    res = (Type)bin + (Type)subBin / delimeter;
   }
   return res;
 }
@@ -147,6 +163,85 @@ TVector3 GetQLCMSFrom4vectors(TLorentzVector& first4momentum, TLorentzVector& se
   return fourmomentadif.Vect();
 }
 
+//====================================================================================
+// closed-form pair kinematics on four-momenta stored as (px, py, pz, E), equivalent to the TLorentzVector versions above
+
+inline std::array<double, 4> FourMomentumFromPtEtaPhiM(const double& pt, const double& eta, const double& phi, const double& mass)
+{
+  const double px = pt * std::cos(phi);
+  const double py = pt * std::sin(phi);
+  const double pz = pt * std::sinh(eta);
+  return {px, py, pz, std::sqrt(px * px + py * py + pz * pz + mass * mass)};
+}
+
+inline float GetKstarFromFourMomenta(std::array<double, 4> const& first4momentum, std::array<double, 4> const& second4momentum, bool isIdentical)
+{
+  std::array<double, 4> sum, dif;
+  for (int i = 0; i < 4; i++) {
+    sum[i] = first4momentum[i] + second4momentum[i];
+    dif[i] = first4momentum[i] - second4momentum[i];
+  }
+  const double difdif = dif[3] * dif[3] - dif[0] * dif[0] - dif[1] * dif[1] - dif[2] * dif[2];
+  if (isIdentical)
+    return 0.5 * std::sqrt(std::fabs(difdif));
+
+  // relative momentum in the pair rest frame: |q*|^2 = (q.P)^2 / P^2 - q^2
+  const double sumsum = sum[3] * sum[3] - sum[0] * sum[0] - sum[1] * sum[1] - sum[2] * sum[2];
+  const double difsum = dif[3] * sum[3] - dif[0] * sum[0] - dif[1] * sum[1] - dif[2] * sum[2];
+  return 0.5 * std::sqrt(std::fabs(difsum * difsum / sumsum - difdif));
+}
+
+inline std::array<double, 3> GetQLCMSFromFourMomenta(std::array<double, 4> const& first4momentum, std::array<double, 4> const& second4momentum)
+{
+  std::array<double, 4> sum, dif;
+  for (int i = 0; i < 4; i++) {
+    sum[i] = first4momentum[i] + second4momentum[i];
+    dif[i] = first4momentum[i] - second4momentum[i];
+  }
+  const double sumPt = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1]);
+  const double cosPhi = sumPt > 0 ? sum[0] / sumPt : 1.0; // X axis along pair's kT
+  const double sinPhi = sumPt > 0 ? sum[1] / sumPt : 0.0;
+
+  const double qOut = dif[0] * cosPhi + dif[1] * sinPhi;
+  const double qSide = dif[1] * cosPhi - dif[0] * sinPhi;
+  const double qLong = (sum[3] * dif[2] - sum[2] * dif[3]) / std::sqrt(sum[3] * sum[3] - sum[2] * sum[2]); // boost to LCMS
+
+  return {qOut, qSide, qLong};
+}
+
+//====================================================================================
+
+// kinematics of a selected track stored by value (e.g. in a flat per-dataframe array),
+// with the accessors of the SingleTrackSels table used by FemtoPair
+class FemtoTrack
+{
+ public:
+  FemtoTrack() {}
+  template <typename T>
+  explicit FemtoTrack(T const& track) : _p(track.p()), _eta(track.eta()), _phi(track.phi()), _pt(track.pt()), _px(track.px()), _py(track.py()), _sign(track.sign())
+  {
+  }
+
+  float p() const { return _p; }
+  float eta() const { return _eta; }
+  float phi() const { return _phi; }
+  float pt() const { return _pt; }
+  float px() const { return _px; }
+  float py() const { return _py; }
+  int8_t sign() const { return _sign; }
+  float phiStar(const float& magfield = 0.0, const float& radius = 1.6) const
+  {
+    if (magfield == 0.0)
+      return -1000.0;
+    return _phi + std::asin(-0.3 * magfield * _sign * radius / (2.0 * _p / std::cosh(_eta)));
+  }
+
+ private:
+  float _p = 0.0, _eta = 0.0, _phi = 0.0;
+  float _pt = 0.0, _px = 0.0, _py = 0.0;
+  int8_t _sign = 0;
+};
+
 //====================================================================================
 
 template <typename TrackType>
@@ -196,8 +291,16 @@ class FemtoPair
   void SetIdentical(const bool& isidentical) { _isidentical = isidentical; }
   void SetMagField1(const float& magfield1) { _magfield1 = magfield1; }
   void SetMagField2(const float& magfield2) { _magfield2 = magfield2; }
-  void SetPDG1(const int& PDG1) { _PDG1 = PDG1; }
-  void SetPDG2(const int& PDG2) { _PDG2 = PDG2; }
+  void SetPDG1(const int& PDG1)
+  {
+    _PDG1 = PDG1;
+    _mass1 = PDG1 == 0 ? 0.0 : particle_mass(PDG1);
+  }
+  void SetPDG2(const int& PDG2)
+  {
+    _PDG2 = PDG2;
+    _mass2 = PDG2 == 0 ? 0.0 : particle_mass(PDG2);
+  }
   int GetPDG1() { return _PDG1; }
   int GetPDG2() { return _PDG2; }
   void ResetPair();
@@ -242,6 +345,7 @@ class FemtoPair
   TrackType _second = NULL;
   float _magfield1 = 0.0, _magfield2 = 0.0;
   int _PDG1 = 0, _PDG2 = 0;
+  double _mass1 = 0.0, _mass2 = 0.0;
   bool _isidentical = true;
   std::array<float, 9> TPCradii = {0.85, 1.05, 1.25, 1.45, 1.65, 1.85, 2.05, 2.25, 2.45};
 };
@@ -262,6 +366,8 @@ void FemtoPair<TrackType>::ResetAll()
   _magfield2 = 0.0;
   _PDG1 = 0;
   _PDG2 = 0;
+  _mass1 = 0.0;
+  _mass2 = 0.0;
   _isidentical = true;
 }
 
@@ -345,12 +451,10 @@ float FemtoPair<TrackType>::GetKstar() const
   if (_PDG1 * _PDG2 == 0)
     return -1000;
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
+  const auto first4momentum = FourMomentumFromPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), _mass1);
+  const auto second4momentum = FourMomentumFromPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), _mass2);
 
-  return GetKstarFrom4vectors(first4momentum, second4momentum, _isidentical);
+  return GetKstarFromFourMomenta(first4momentum, second4momentum, _isidentical);
 }
 
 template <typename TrackType>
@@ -363,12 +467,11 @@ TVector3 FemtoPair<TrackType>::GetQLCMS() const
   if (_PDG1 * _PDG2 == 0)
     return TVector3(-1000, -1000, -1000);
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
+  const auto first4momentum = FourMomentumFromPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), _mass1);
+  const auto second4momentum = FourMomentumFromPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), _mass2);
+  const auto qLCMS = GetQLCMSFromFourMomenta(first4momentum, second4momentum);
 
-  return GetQLCMSFrom4vectors(first4momentum, second4momentum);
+  return TVector3(qLCMS[0], qLCMS[1], qLCMS[2]);
 }
 
 template <typename TrackType>
@@ -395,14 +498,12 @@ float FemtoPair<TrackType>::GetMt() const
   if (_PDG1 * _PDG2 == 0)
     return -1000;
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
+  const auto first4momentum = FourMomentumFromPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), _mass1);
+  const auto second4momentum = FourMomentumFromPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), _mass2);
+  const double sumE = first4momentum[3] + second4momentum[3];
+  const double sumPz = first4momentum[2] + second4momentum[2];
 
-  TLorentzVector fourmomentasum = first4momentum + second4momentum;
-
-  return 0.5 * fourmomentasum.Mt();
+  return 0.5 * std::sqrt(sumE * sumE - sumPz * sumPz);
 }
 
 template <typename TrackType>
@@ -420,17 +521,16 @@ float FemtoPair<TrackType>::GetGammaOut() const
   // double Qout_PRF = sqrt(Qinv * Qinv - QLCMS.Y() * QLCMS.Y() - QLCMS.Z() * QLCMS.Z());
   // return std::fabs(QLCMS.X() / Qout_PRF);
 
-  TLorentzVector first4momentum;
-  first4momentum.SetPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), particle_mass(_PDG1));
-  TLorentzVector second4momentum;
-  second4momentum.SetPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), particle_mass(_PDG2));
-
-  TLorentzVector fourmomentasum = first4momentum + second4momentum;
-
-  fourmomentasum.Boost(0.0, 0.0, (-1) * fourmomentasum.BoostVector().Z()); // boost to LCMS
-  fourmomentasum.RotateZ((-1) * fourmomentasum.Phi());                     // rotate so the X axis is along pair's kT
+  const auto first4momentum = FourMomentumFromPtEtaPhiM(_first->pt(), _first->eta(), _first->phi(), _mass1);
+  const auto second4momentum = FourMomentumFromPtEtaPhiM(_second->pt(), _second->eta(), _second->phi(), _mass2);
+  const double sumPx = first4momentum[0] + second4momentum[0];
+  const double sumPy = first4momentum[1] + second4momentum[1];
+  const double sumPz = first4momentum[2] + second4momentum[2];
+  const double sumE = first4momentum[3] + second4momentum[3];
 
-  return fourmomentasum.Gamma();
+  // in the LCMS the pair energy is its transverse mass and its momentum is its pT
+  const double sumMt2 = sumE * sumE - sumPz * sumPz;
+  return std::sqrt(sumMt2 / (sumMt2 - sumPx * sumPx - sumPy * sumPy));
 }
 } // namespace o2::aod::singletrackselector
 
@@ -35,13 +35,17 @@
 #include <TString.h>
 #include <TVector3.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
-#include <map>
 #include <memory>
+#include <numeric>
 #include <random>
+#include <span>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -134,14 +138,31 @@ struct FemtoCorrelations {
   // using FilteredTracks = soa::Join<aod::SingleTrackSels, aod::SinglePIDPis, aod::SinglePIDKas, aod::SinglePIDPrs, aod::SinglePIDDes, aod::SinglePIDTrs, aod::SinglePIDHes>; // main
   using FilteredTracks = soa::Join<aod::SingleTrackSels, aod::SinglePIDPrs, aod::SinglePIDDes>; // tmp solution till the HL is fixed
 
-  typedef std::shared_ptr<soa::Filtered<FilteredTracks>::iterator> trkType;
-  typedef std::shared_ptr<soa::Filtered<FilteredCollisions>::iterator> colType;
+  typedef o2::aod::singletrackselector::FemtoTrack trkType;
 
-  std::map<int64_t, std::vector<trkType>> selectedtracks_1;
-  std::map<int64_t, std::vector<trkType>> selectedtracks_2;
-  std::map<std::pair<int, float>, std::vector<colType>> mixbins;
+  // collision to be mixed, with the (vertex, centrality, centrality sub-bin) bucket it belongs to
+  struct MixingCollision {
+    int vertexBin;
+    int centBin;
+    int centSubBin;
+    int64_t index;
+    float magField;
+    int mult;
+  };
 
-  std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType>>();
+  // selected tracks of the dataframe stored flat and grouped by collision:
+  // the tracks of the collision with index i are [trackOffsets[i], trackOffsets[i + 1])
+  std::vector<std::pair<int64_t, trkType>> stagedtracks_1; // (collision index, track) in the table order
+  std::vector<std::pair<int64_t, trkType>> stagedtracks_2;
+  std::vector<trkType> selectedtracks_1;
+  std::vector<trkType> selectedtracks_2;
+  std::vector<int> trackOffsets_1;
+  std::vector<int> trackOffsets_2;
+  std::vector<int> fillPositions;
+
+  std::vector<MixingCollision> mixbins; // sorted into contiguous buckets before the mixing
+
+  std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType const*>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType const*>>();
 
   Filter pFilter = o2::aod::singletrackselector::p > _min_P&& o2::aod::singletrackselector::p < _max_P;
   Filter etaFilter = nabs(o2::aod::singletrackselector::eta) < _eta;
@@ -311,7 +332,7 @@ struct FemtoCorrelations {
     for (unsigned int ii = 0; ii < tracks.size(); ii++) { // nested loop for all the combinations
       for (unsigned int iii = ii + 1; iii < tracks.size(); iii++) {
 
-        Pair->SetPair(tracks[ii], tracks[iii]);
+        Pair->SetPair(&tracks[ii], &tracks[iii]);
         float pair_kT = Pair->GetKt();
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
@@ -356,10 +377,10 @@ struct FemtoCorrelations {
     if (_fill3dCF && multBin > SEhistos_3D.size())
       LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (3D)");
 
-    for (auto ii : tracks1) {
-      for (auto iii : tracks2) {
+    for (const auto& ii : tracks1) {
+      for (const auto& iii : tracks2) {
 
-        Pair->SetPair(ii, iii);
+        Pair->SetPair(&ii, &iii);
         float pair_kT = Pair->GetKt();
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
@@ -418,39 +439,65 @@ struct FemtoCorrelations {
     }
   }
 
+  // counting sort of the staged tracks by collision index, keeping the table order within each collision
+  void groupByCollision(std::vector<std::pair<int64_t, trkType>> const& stagedtracks, std::vector<trkType>& selectedtracks, std::vector<int>& trackOffsets)
+  {
+    int64_t nCollisions = 0;
+    for (const auto& stagedtrack : stagedtracks)
+      nCollisions = std::max(nCollisions, stagedtrack.first + 1);
+
+    trackOffsets.assign(nCollisions + 1, 0);
+    for (const auto& stagedtrack : stagedtracks)
+      trackOffsets[stagedtrack.first + 1]++;
+    std::partial_sum(trackOffsets.begin(), trackOffsets.end(), trackOffsets.begin());
+
+    fillPositions.assign(trackOffsets.begin(), trackOffsets.end() - 1);
+    selectedtracks.resize(stagedtracks.size());
+    for (const auto& stagedtrack : stagedtracks)
+      selectedtracks[fillPositions[stagedtrack.first]++] = stagedtrack.second;
+  }
+
+  std::span<const trkType> getTracks(std::vector<trkType> const& selectedtracks, std::vector<int> const& trackOffsets, int64_t collisionIndex) const
+  {
+    if (collisionIndex < 0 || collisionIndex + 1 >= static_cast<int64_t>(trackOffsets.size()))
+      return {};
+    return std::span<const trkType>(selectedtracks.data() + trackOffsets[collisionIndex], trackOffsets[collisionIndex + 1] - trackOffsets[collisionIndex]);
+  }
+
   void process(soa::Filtered<FilteredCollisions> const& collisions, soa::Filtered<FilteredTracks> const& tracks)
   {
     if (_particlePDG_1 == 0 || _particlePDG_2 == 0)
       LOGF(fatal, "One of passed PDG is 0!!!");
 
     for (const auto& track : tracks) {
-      if (std::fabs(track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().posZ()) > _vertexZ)
+      auto trackCollision = track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>();
+      if (std::fabs(trackCollision.posZ()) > _vertexZ)
         continue;
-      if (_removeSameBunchPileup && !track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().isNoSameBunchPileup())
+      if (_removeSameBunchPileup && !trackCollision.isNoSameBunchPileup())
         continue;
-      if (_requestGoodZvtxFT0vsPV && !track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().isGoodZvtxFT0vsPV())
+      if (_requestGoodZvtxFT0vsPV && !trackCollision.isGoodZvtxFT0vsPV())
         continue;
-      if (_requestVertexITSTPC && !track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().isVertexITSTPC())
+      if (_requestVertexITSTPC && !trackCollision.isVertexITSTPC())
         continue;
-      if (_requestVertexTOForTRDmatched > track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().isVertexTOForTRDmatched())
+      if (_requestVertexTOForTRDmatched > trackCollision.isVertexTOForTRDmatched())
         continue;
-      if (_requestNoCollInTimeRangeStandard && !track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().noCollInTimeRangeStandard())
+      if (_requestNoCollInTimeRangeStandard && !trackCollision.noCollInTimeRangeStandard())
         continue;
-      if (_requestIsGoodITSLayersAll && !track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().isGoodITSLayersAll())
+      if (_requestIsGoodITSLayersAll && !trackCollision.isGoodITSLayersAll())
         continue;
       if (track.tpcFractionSharedCls() > _tpcFractionSharedCls || track.itsNCls() < _itsNCls)
         continue;
-      if (track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().multPerc() < *_centBins.value.begin() || track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().multPerc() >= *(_centBins.value.end() - 1))
+      if (trackCollision.multPerc() < *_centBins.value.begin() || trackCollision.multPerc() >= *(_centBins.value.end() - 1))
         continue;
-      if (track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().hadronicRate() < _IRcut.value.first || track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().hadronicRate() >= _IRcut.value.second)
+      if (trackCollision.hadronicRate() < _IRcut.value.first || trackCollision.hadronicRate() >= _IRcut.value.second)
         continue;
-      if (track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().occupancy() < _OccupancyCut.value.first || track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().occupancy() >= _OccupancyCut.value.second)
+      if (trackCollision.occupancy() < _OccupancyCut.value.first || trackCollision.occupancy() >= _OccupancyCut.value.second)
         continue;
       if (std::fabs(track.dcaXY()) > _dcaXY.value[0] + _dcaXY.value[1] * std::pow(track.pt(), _dcaXY.value[2]) || std::fabs(track.dcaZ()) > _dcaZ.value[0] + _dcaZ.value[1] * std::pow(track.pt(), _dcaZ.value[2]))
         continue;
 
       if (track.sign() == _sign_1 && (track.p() < _PIDtrshld_1 ? o2::aod::singletrackselector::TPCselection<true>(track, TPCcuts_1, _itsNSigma_1.value) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_1, _tpcNSigmaResidual_1.value))) { // filling the map: eventID <-> selected particles1
-        selectedtracks_1[track.singleCollSelId()].push_back(std::make_shared<soa::Filtered<FilteredTracks>::iterator>(track));
+        stagedtracks_1.emplace_back(track.singleCollSelId(), trkType(track));
 
         pHisto_first->Fill(track.p());
         ITShisto_first->Fill(track.p(), o2::aod::singletrackselector::getITSNsigma(track, _particlePDG_1));
@@ -461,7 +508,7 @@ struct FemtoCorrelations {
       if (IsIdentical) {
         continue;
       } else if (track.sign() != _sign_2 && !TOFselection(track, std::make_pair(_particlePDGtoReject, _rejectWithinNsigmaTOF)) && (track.p() < _PIDtrshld_2 ? o2::aod::singletrackselector::TPCselection<true>(track, TPCcuts_2, _itsNSigma_2.value) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_2, _tpcNSigmaResidual_2.value))) { // filling the map: eventID <-> selected particles2 if (see condition above ^)
-        selectedtracks_2[track.singleCollSelId()].push_back(std::make_shared<soa::Filtered<FilteredTracks>::iterator>(track));
+        stagedtracks_2.emplace_back(track.singleCollSelId(), trkType(track));
 
         pHisto_second->Fill(track.p());
         ITShisto_second->Fill(track.p(), o2::aod::singletrackselector::getITSNsigma(track, _particlePDG_2));
@@ -470,6 +517,10 @@ struct FemtoCorrelations {
       }
     }
 
+    groupByCollision(stagedtracks_1, selectedtracks_1, trackOffsets_1);
+    if (!IsIdentical)
+      groupByCollision(stagedtracks_2, selectedtracks_2, trackOffsets_2);
+
     for (const auto& collision : collisions) {
       if (collision.multPerc() < *_centBins.value.begin() || collision.multPerc() >= *(_centBins.value.end() - 1))
         continue;
@@ -490,103 +541,113 @@ struct FemtoCorrelations {
         continue;
       if (_requestIsGoodITSLayersAll && !collision.isGoodITSLayersAll())
         continue;
-      if (selectedtracks_1.find(collision.globalIndex()) == selectedtracks_1.end()) {
+      if (getTracks(selectedtracks_1, trackOffsets_1, collision.globalIndex()).empty()) {
         if (IsIdentical)
           continue;
-        else if (selectedtracks_2.find(collision.globalIndex()) == selectedtracks_2.end())
+        else if (getTracks(selectedtracks_2, trackOffsets_2, collision.globalIndex()).empty())
           continue;
       }
       int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
-      float centBinToMix = o2::aod::singletrackselector::getBinIndex<float>(collision.multPerc(), _centBins, _multNsubBins);
+      int centBinToMix = 0, centSubBinToMix = 0;
+      o2::aod::singletrackselector::getBinAndSubBin(collision.multPerc(), _centBins, _multNsubBins, centBinToMix, centSubBinToMix);
 
-      mixbins[std::pair<int, float>{vertexBinToMix, centBinToMix}].push_back(std::make_shared<soa::Filtered<FilteredCollisions>::iterator>(collision));
+      mixbins.push_back(MixingCollision{vertexBinToMix, centBinToMix, centSubBinToMix, collision.index(), collision.magField(), collision.mult()});
     }
 
+    // same order of the buckets and of the collisions within them as in the table
+    std::stable_sort(mixbins.begin(), mixbins.end(), [](MixingCollision const& a, MixingCollision const& b) {
+      return std::tie(a.vertexBin, a.centBin, a.centSubBin) < std::tie(b.vertexBin, b.centBin, b.centSubBin);
+    });
+
     //====================================== mixing starts here ======================================
 
     if (IsIdentical) { //====================================== mixing identical ======================================
 
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
-        unsigned int EvPerBin = (i->second).size();
+      for (std::size_t binBegin = 0, binEnd = 0; binBegin < mixbins.size(); binBegin = binEnd) { // iterating over all vertex&mult bins
+        binEnd = binBegin + 1;
+        while (binEnd < mixbins.size() && std::tie(mixbins[binEnd].vertexBin, mixbins[binEnd].centBin, mixbins[binEnd].centSubBin) == std::tie(mixbins[binBegin].vertexBin, mixbins[binBegin].centBin, mixbins[binBegin].centSubBin))
+          binEnd++;
 
-        for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
+        for (std::size_t indx1 = binBegin; indx1 < binEnd; indx1++) { // loop over all the events in each vertex&mult bin
 
-          auto col1 = (i->second)[indx1];
+          const auto& col1 = mixbins[indx1];
 
-          Pair->SetMagField1(col1->magField());
-          Pair->SetMagField2(col1->magField());
+          Pair->SetMagField1(col1.magField);
+          Pair->SetMagField2(col1.magField);
 
-          unsigned int centBin = std::floor((i->first).second);
-          MultHistos[centBin]->Fill(col1->mult());
+          unsigned int centBin = col1.centBin;
+          MultHistos[centBin]->Fill(col1.mult);
 
-          if (selectedtracks_1[col1->index()].size() > 1) {
-            MultHistos_pair[centBin]->Fill(col1->mult());
+          auto tracks1 = getTracks(selectedtracks_1, trackOffsets_1, col1.index);
+          if (tracks1.size() > 1) {
+            MultHistos_pair[centBin]->Fill(col1.mult);
           }
 
-          mixTracks(selectedtracks_1[col1->index()], centBin); // mixing SE identical
+          mixTracks(tracks1, centBin); // mixing SE identical
 
-          for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
+          for (std::size_t indx2 = indx1 + 1; indx2 < binEnd; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
             if (_MEreductionFactor.value > 1) {
               std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
               if ((mt() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
                 continue;
             }
 
-            auto col2 = (i->second)[indx2];
+            const auto& col2 = mixbins[indx2];
 
-            Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_1[col2->index()], centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
+            Pair->SetMagField2(col2.magField);
+            mixTracks<1>(tracks1, getTracks(selectedtracks_1, trackOffsets_1, col2.index), centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
           }
         }
       }
 
     } else { //====================================== mixing non-identical ======================================
 
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
-        unsigned int EvPerBin = (i->second).size();
+      for (std::size_t binBegin = 0, binEnd = 0; binBegin < mixbins.size(); binBegin = binEnd) { // iterating over all vertex&mult bins
+        binEnd = binBegin + 1;
+        while (binEnd < mixbins.size() && std::tie(mixbins[binEnd].vertexBin, mixbins[binEnd].centBin, mixbins[binEnd].centSubBin) == std::tie(mixbins[binBegin].vertexBin, mixbins[binBegin].centBin, mixbins[binBegin].centSubBin))
+          binEnd++;
 
-        for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
+        for (std::size_t indx1 = binBegin; indx1 < binEnd; indx1++) { // loop over all the events in each vertex&mult bin
 
-          auto col1 = (i->second)[indx1];
+          const auto& col1 = mixbins[indx1];
 
-          Pair->SetMagField1(col1->magField());
-          Pair->SetMagField2(col1->magField());
+          Pair->SetMagField1(col1.magField);
+          Pair->SetMagField2(col1.magField);
 
-          unsigned int centBin = std::floor((i->first).second);
-          MultHistos[centBin]->Fill(col1->mult());
+          unsigned int centBin = col1.centBin;
+          MultHistos[centBin]->Fill(col1.mult);
 
-          mixTracks<0>(selectedtracks_1[col1->index()], selectedtracks_2[col1->index()], centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
+          auto tracks1 = getTracks(selectedtracks_1, trackOffsets_1, col1.index);
+          mixTracks<0>(tracks1, getTracks(selectedtracks_2, trackOffsets_2, col1.index), centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
 
-          for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
+          for (std::size_t indx2 = indx1 + 1; indx2 < binEnd; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
             if (_MEreductionFactor.value > 1) {
               std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
               if (mt() % (_MEreductionFactor.value + 1) < _MEreductionFactor.value)
                 continue;
             }
 
-            auto col2 = (i->second)[indx2];
+            const auto& col2 = mixbins[indx2];
 
-            Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_2[col2->index()], centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
+            Pair->SetMagField2(col2.magField);
+            mixTracks<1>(tracks1, getTracks(selectedtracks_2, trackOffsets_2, col2.index), centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
           }
         }
       }
 
     } //====================================== end of mixing non-identical ======================================
 
-    // clearing up
-    for (auto i = selectedtracks_1.begin(); i != selectedtracks_1.end(); i++)
-      (i->second).clear();
+    // clearing up (the allocated memory is kept for the next dataframe)
+    stagedtracks_1.clear();
     selectedtracks_1.clear();
+    trackOffsets_1.clear();
 
     if (!IsIdentical) {
-      for (auto i = selectedtracks_2.begin(); i != selectedtracks_2.end(); i++)
-        (i->second).clear();
+      stagedtracks_2.clear();
       selectedtracks_2.clear();
+      trackOffsets_2.clear();
     }
 
-    for (auto i = mixbins.begin(); i != mixbins.end(); i++)
-      (i->second).clear();
     mixbins.clear();
   }
 };
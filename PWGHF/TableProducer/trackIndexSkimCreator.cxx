@@ -369,6 +369,14 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
   static const int nCuts = 4;
   // array of 2-prong and 3-prong cuts
   std::array<LabeledArray<double>, CandidateType::NCandidateTypes> cutsSingleTrack{};
+  // single-track cuts per candidate type flattened at init, to avoid label look-ups per track
+  std::array<double, CandidateType::NCandidateTypes> ptMinTrack{};
+  std::array<double, CandidateType::NCandidateTypes> etaMinTrack{};
+  std::array<double, CandidateType::NCandidateTypes> etaMaxTrack{};
+  std::array<std::vector<std::array<double, 4>>, CandidateType::NCandidateTypes> cutsDcaPerPtBin{}; // [candidate type][pT bin] = {min DCAxy, max DCAxy, min DCAz, max DCAz}
+  // light-nucleus track-quality cuts and TPC Bethe-Bloch parameters per species, copied at init for the same reason
+  std::array<std::array<float, hf_presel_lightnuclei::NVarCuts>, hf_presel_lightnuclei::NParticleRows> cutsLightNuclei{};
+  std::array<std::array<float, hf_presel_lightnuclei::NBetheBlochParams>, hf_presel_lightnuclei::NParticleRows> bbParamsLightNuclei{};
   // proton PID, if enabled
   std::array<TrackSelectorPr, ChannelsProtonPid::NChannelsProtonPid> selectorProton{};
   TrackSelectorKa selectorKaon;
@@ -410,6 +418,26 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
       config.etaMinTrackBachLfCasc.value = -config.etaMaxTrackBachLfCasc;
     }
 
+    ptMinTrack = {config.ptMinTrack2Prong, config.ptMinTrack3Prong, config.ptMinTrackBach, config.ptMinSoftPionForDstar, config.ptMinTrackBachLfCasc};
+    etaMinTrack = {config.etaMinTrack2Prong, config.etaMinTrack3Prong, config.etaMinTrackBach, config.etaMinSoftPionForDstar, config.etaMinTrackBachLfCasc};
+    etaMaxTrack = {config.etaMaxTrack2Prong, config.etaMaxTrack3Prong, config.etaMaxTrackBach, config.etaMaxSoftPionForDstar, config.etaMaxTrackBachLfCasc};
+    const auto nBinsPt = config.binsPtTrack->size() - 1;
+    for (int iCandType = 0; iCandType < CandidateType::NCandidateTypes; iCandType++) {
+      cutsDcaPerPtBin[iCandType].resize(nBinsPt);
+      for (auto iBinPt{0u}; iBinPt < nBinsPt; ++iBinPt) {
+        cutsDcaPerPtBin[iCandType][iBinPt] = {cutsSingleTrack[iCandType].get(iBinPt, "min_dcaxytoprimary"), cutsSingleTrack[iCandType].get(iBinPt, "max_dcaxytoprimary"),
+                                              cutsSingleTrack[iCandType].get(iBinPt, "min_dcaztoprimary"), cutsSingleTrack[iCandType].get(iBinPt, "max_dcaztoprimary")};
+      }
+    }
+    for (int iRow = 0; iRow < hf_presel_lightnuclei::NParticleRows; iRow++) {
+      for (int iCut = 0; iCut < hf_presel_lightnuclei::NVarCuts; iCut++) {
+        cutsLightNuclei[iRow][iCut] = config.selectionsLightNuclei->get(iRow, iCut);
+      }
+      for (int iParam = 0; iParam < hf_presel_lightnuclei::NBetheBlochParams; iParam++) {
+        bbParamsLightNuclei[iRow][iParam] = config.tpcPidBBParamsLightNuclei->get(iRow, iParam);
+      }
+    }
+
     if (config.fillHistograms) {
       const AxisSpec axisPtProng{360, 0., 36., "#it{p}_{T}^{track} (GeV/#it{c})"};
       const AxisSpec axisDca{400, -2., 2., "DCAxy to prim. vtx. (cm)"};
@@ -538,18 +566,19 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     }
 
     // Load cuts for the selected species.
-    const float itsPidNsigmaMin = config.selectionsLightNuclei->get(row, 0u);
-    const float itsClusterSizeMin = config.selectionsLightNuclei->get(row, 1u);
-    const float itsClusterMin = config.selectionsLightNuclei->get(row, 2u);
-    const float itsIbClusterMin = config.selectionsLightNuclei->get(row, 3u);
-    const float tpcClusterMin = config.selectionsLightNuclei->get(row, 4u);
-    const float tpcCrossedRowsMin = config.selectionsLightNuclei->get(row, 5u);
-    const float tpcCrossedRowsOverFindMin = config.selectionsLightNuclei->get(row, 6u);
-    const float tpcSharedMax = config.selectionsLightNuclei->get(row, 7u);
-    const float tpcFracSharedMax = config.selectionsLightNuclei->get(row, 8u);
+    const auto& cuts = cutsLightNuclei[row];
+    const float itsPidNsigmaMin = cuts[0];
+    const float itsClusterSizeMin = cuts[1];
+    const float itsClusterMin = cuts[2];
+    const float itsIbClusterMin = cuts[3];
+    const float tpcClusterMin = cuts[4];
+    const float tpcCrossedRowsMin = cuts[5];
+    const float tpcCrossedRowsOverFindMin = cuts[6];
+    const float tpcSharedMax = cuts[7];
+    const float tpcFracSharedMax = cuts[8];
 
     // Optional: BB-based TPC nσ selection (only if enabled)
-    const float tpcBbPidNsigmaMax = config.selectionsLightNuclei->get(row, 9u);
+    const float tpcBbPidNsigmaMax = cuts[9];
 
     if (nSigmaIts < itsPidNsigmaMin) {
       return false;
@@ -606,12 +635,13 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     }
 
     // Columns: [0..4] BB params, [5] relative resolution (sigma/mean)
-    const double bb0 = config.tpcPidBBParamsLightNuclei->get(row, 0u);
-    const double bb1 = config.tpcPidBBParamsLightNuclei->get(row, 1u);
-    const double bb2 = config.tpcPidBBParamsLightNuclei->get(row, 2u);
-    const double bb3 = config.tpcPidBBParamsLightNuclei->get(row, 3u);
-    const double bb4 = config.tpcPidBBParamsLightNuclei->get(row, 4u);
-    const double relRes = config.tpcPidBBParamsLightNuclei->get(row, 5u);
+    const auto& bbParams = bbParamsLightNuclei[row];
+    const double bb0 = bbParams[0];
+    const double bb1 = bbParams[1];
+    const double bb2 = bbParams[2];
+    const double bb3 = bbParams[3];
+    const double bb4 = bbParams[4];
+    const double relRes = bbParams[5];
 
     if (relRes <= 0.f) {
       return -999.f;
@@ -728,71 +758,23 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
 
     int iCut{2};
     // pT cut
-    if (trackPt < config.ptMinTrack2Prong) {
-      CLRBIT(statusProng, CandidateType::Cand2Prong); // set the nth bit to 0
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::Cand2Prong + iCut);
-      }
-    }
-    if (trackPt < config.ptMinTrack3Prong) {
-      CLRBIT(statusProng, CandidateType::Cand3Prong);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::Cand3Prong + iCut);
-      }
-    }
-
-    if (trackPt < config.ptMinTrackBach) {
-      CLRBIT(statusProng, CandidateType::CandV0bachelor);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::CandV0bachelor + iCut);
-      }
-    }
-    if (trackPt < config.ptMinSoftPionForDstar) {
-      CLRBIT(statusProng, CandidateType::CandDstar);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::CandDstar + iCut);
-      }
-    }
-    if (trackPt < config.ptMinTrackBachLfCasc) {
-      CLRBIT(statusProng, CandidateType::CandCascadeBachelor);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::CandCascadeBachelor + iCut);
+    for (int iCandType = 0; iCandType < CandidateType::NCandidateTypes; iCandType++) {
+      if (trackPt < ptMinTrack[iCandType]) {
+        CLRBIT(statusProng, iCandType); // set the nth bit to 0
+        if (config.fillHistograms) {
+          registry.fill(HIST("hRejTracks"), (nCuts + 1) * iCandType + iCut);
+        }
       }
     }
 
     iCut = 3;
     // eta cut
-    if (TESTBIT(statusProng, CandidateType::Cand2Prong) && (trackEta > config.etaMaxTrack2Prong || trackEta < config.etaMinTrack2Prong)) {
-      CLRBIT(statusProng, CandidateType::Cand2Prong);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::Cand2Prong + iCut);
-      }
-    }
-    if (TESTBIT(statusProng, CandidateType::Cand3Prong) && (trackEta > config.etaMaxTrack3Prong || trackEta < config.etaMinTrack3Prong)) {
-      CLRBIT(statusProng, CandidateType::Cand3Prong);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::Cand3Prong + iCut);
-      }
-    }
-
-    if (TESTBIT(statusProng, CandidateType::CandV0bachelor) && (trackEta > config.etaMaxTrackBach || trackEta < config.etaMinTrackBach)) {
-      CLRBIT(statusProng, CandidateType::CandV0bachelor);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::CandV0bachelor + iCut);
-      }
-    }
-
-    if (TESTBIT(statusProng, CandidateType::CandDstar) && (trackEta > config.etaMaxSoftPionForDstar || trackEta < config.etaMinSoftPionForDstar)) {
-      CLRBIT(statusProng, CandidateType::CandDstar);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::CandDstar + iCut);
-      }
-    }
-
-    if (TESTBIT(statusProng, CandidateType::CandCascadeBachelor) && (trackEta > config.etaMaxTrackBachLfCasc || trackEta < config.etaMinTrackBachLfCasc)) {
-      CLRBIT(statusProng, CandidateType::CandCascadeBachelor);
-      if (config.fillHistograms) {
-        registry.fill(HIST("hRejTracks"), (nCuts + 1) * CandidateType::CandCascadeBachelor + iCut);
+    for (int iCandType = 0; iCandType < CandidateType::NCandidateTypes; iCandType++) {
+      if (TESTBIT(statusProng, iCandType) && (trackEta > etaMaxTrack[iCandType] || trackEta < etaMinTrack[iCandType])) {
+        CLRBIT(statusProng, iCandType);
+        if (config.fillHistograms) {
+          registry.fill(HIST("hRejTracks"), (nCuts + 1) * iCandType + iCut);
+        }
       }
     }
 
@@ -890,8 +872,9 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     // DCA cut
     iCut = 5;
     if (statusProng > 0) {
+      const int binPt = findBin(config.binsPtTrack, trackPt); // same pT binning for all candidate types
       for (int iCandType = 0; iCandType < CandidateType::NCandidateTypes; ++iCandType) {
-        if (TESTBIT(statusProng, iCandType) && !isSelectedTrackDca(config.binsPtTrack, &cutsSingleTrack[iCandType], trackPt, dca[0], dca[1])) {
+        if (TESTBIT(statusProng, iCandType) && !isSelectedTrackDcaPerPtBin(iCandType, binPt, dca)) {
           CLRBIT(statusProng, iCandType);
           if (config.fillHistograms) {
             registry.fill(HIST("hRejTracks"), (nCuts + 1) * iCandType + iCut);
@@ -936,67 +919,88 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     }
   }
 
+  /// Single-track DCA selection with the cuts flattened at init, equivalent to isSelectedTrackDca
+  /// \param iCandType is the candidate type
+  /// \param binPt is the track pT bin, -1 if out of range
+  /// \param dca is a 2-element array with dca in transverse and longitudinal directions
+  /// \return true if track passes all cuts
+  bool isSelectedTrackDcaPerPtBin(const int iCandType, const int binPt, const std::array<float, 2>& dca)
+  {
+    if (binPt == -1) {
+      return false;
+    }
+    const auto& cuts = cutsDcaPerPtBin[iCandType][binPt];
+    const auto absDcaXY = std::abs(dca[0]);
+    const auto absDcaZ = std::abs(dca[1]);
+    return !(absDcaXY < cuts[0]) && !(absDcaXY > cuts[1]) && !(absDcaZ < cuts[2]) && !(absDcaZ > cuts[3]);
+  }
+
+  /// PV refit inputs shared by all the tracks of a collision
+  struct PvRefitContext {
+    std::vector<int64_t> vecPvContributorGlobId{};
+    std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
+    std::vector<bool> vecPvRefitContributorUsed{};
+    o2::dataformats::VertexBase primVtx{};
+    o2::vertexing::PVertexer vertexer{};
+    bool pvRefitDoable{false};
+  };
+
+  /// Method to prepare the PV refit once per collision, shared by all its tracks
+  /// \param collision is a collision
+  /// \param pvContrCollision are the PV contributors of this collision
+  /// \param context is the PV refit context to be prepared
+  template <typename GroupedPvContributors>
+  void preparePvRefit(aod::Collision const& collision,
+                      GroupedPvContributors const& pvContrCollision,
+                      PvRefitContext& context)
+  {
+    // set the magnetic field from CCDB
+    const auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
+    initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
+
+    /// retrieve PV contributors for the current collision
+    context.vecPvContributorGlobId.reserve(pvContrCollision.size());
+    context.vecPvContributorTrackParCov.reserve(pvContrCollision.size());
+    for (const auto& contributor : pvContrCollision) {
+      context.vecPvContributorGlobId.push_back(contributor.globalIndex());
+      context.vecPvContributorTrackParCov.push_back(getTrackParCov(contributor));
+    }
+    context.vecPvRefitContributorUsed.assign(context.vecPvContributorGlobId.size(), true);
+    if (config.debugPvRefit) {
+      LOG(info) << "### vecPvContributorGlobId.size()=" << context.vecPvContributorGlobId.size() << ", vecPvContributorTrackParCov.size()=" << context.vecPvContributorTrackParCov.size() << ", N. original contributors=" << collision.numContrib();
+    }
+
+    // build the VertexBase to initialize the vertexer
+    context.primVtx.setX(collision.posX());
+    context.primVtx.setY(collision.posY());
+    context.primVtx.setZ(collision.posZ());
+    context.primVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    // configure PVertexer
+    o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
+    context.vertexer.init();
+    context.pvRefitDoable = context.vertexer.prepareVertexRefit(context.vecPvContributorTrackParCov, context.primVtx);
+  }
+
   /// Method for the PV refit and DCA recalculation for tracks with a collision assigned
   /// \param collision is a collision
-  /// \param bcWithTimeStamps is a table of bunch crossing joined with timestamps used to query the CCDB for B and material budget
-  /// \param vecPvContributorGlobId is a vector containing the global ID of PV contributors for the current collision
-  /// \param vecPvContributorTrackParCov is a vector containing the TrackParCov of PV contributors for the current collision
+  /// \param context is the PV refit context of the collision, prepared with preparePvRefit
   /// \param trackToRemove is the track to be removed, if contributor, from the PV refit
   /// \param pvCoord is an array containing the coordinates of the refitted PV
   /// \param pvCovMatrix is an array containing the covariance matrix values of the refitted PV
   /// \param dcaXYdcaZ is an array containing the dcaXY and dcaZ of trackToRemove with respect to the refitted PV
   template <typename TTrack>
   void performPvRefitTrack(aod::Collision const& collision,
-                           aod::BCsWithTimestamps const&,
-                           std::vector<int64_t> const& vecPvContributorGlobId,
-                           std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
+                           PvRefitContext& context,
                            TTrack const& trackToRemove,
                            std::array<float, 3>& pvCoord,
                            std::array<float, 6>& pvCovMatrix,
                            std::array<float, 2>& dcaXYdcaZ)
   {
-    std::vector<bool> vecPvRefitContributorUsed(vecPvContributorGlobId.size(), true);
-
-    /// Prepare the vertex refitting
-    // set the magnetic field from CCDB
-    const auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
-    initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
-    /*if (runNumber != bc.runNumber()) {
-
-      if (isRun2) { // Run 2 GRP object
-        o2::parameters::GRPObject* grpo = ccdb->getForTimeStamp<o2::parameters::GRPObject>(ccdbPathGrp, bc.timestamp());
-        if (grpo != nullptr) {
-          o2::base::Propagator::initFieldFromGRP(grpo);
-          o2::base::Propagator::Instance()->setMatLUT(lut);
-          LOGF(info, "Setting magnetic field to %d kG for run %d from its GRP CCDB object (type o2::parameters::GRPObject)", grpo->getNominalL3Field(), bc.runNumber());
-        } else {
-          LOGF(fatal, "Run 2 GRP object (type o2::parameters::GRPObject) is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
-        }
-      } else { // Run 3 GRP object
-        o2::parameters::GRPMagField* grpo = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(ccdbPathGrpMag, bc.timestamp());
-        if (grpo != nullptr) {
-          o2::base::Propagator::initFieldFromGRP(grpo);
-          o2::base::Propagator::Instance()->setMatLUT(lut);
-          LOG(info) << "Setting magnetic field to current" << grpo->getL3Current() << " A for run" << bc.runNumber() << " from its GRP CCDB object (type o2::parameters::GRPMagField)";
-        } else {
-          LOGF(fatal, "Run 3 GRP object (type o2::parameters::GRPMagField) is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
-        }
-      }
-
-      runNumber = bc.runNumber();
-    }*/
-
-    // build the VertexBase to initialize the vertexer
-    o2::dataformats::VertexBase primVtx;
-    primVtx.setX(collision.posX());
-    primVtx.setY(collision.posY());
-    primVtx.setZ(collision.posZ());
-    primVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-    // configure PVertexer
-    o2::vertexing::PVertexer vertexer;
-    o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
-    vertexer.init();
-    const bool pvRefitDoable = vertexer.prepareVertexRefit(vecPvContributorTrackParCov, primVtx);
+    const auto& vecPvContributorGlobId = context.vecPvContributorGlobId;
+    auto& vecPvRefitContributorUsed = context.vecPvRefitContributorUsed;
+    const auto& primVtx = context.primVtx;
+    auto& vertexer = context.vertexer;
+    const bool pvRefitDoable = context.pvRefitDoable;
     if (!pvRefitDoable) {
       LOG(info) << "Not enough tracks accepted for the refit";
       if (config.doPvRefit && config.fillHistograms) {
@@ -1004,7 +1008,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
       }
     }
     if (config.debugPvRefit) {
-      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << vecPvContributorTrackParCov.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
+      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << context.vecPvContributorTrackParCov.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
     }
 
     if (config.fillHistograms) {
@@ -1049,7 +1053,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
           registry.fill(HIST("PvRefit/hChi2vsNContrib"), primVtxRefitted.getNContributors(), primVtxRefitted.getChi2());
         }
 
-        vecPvRefitContributorUsed[entry] = true; /// restore the track for the next PV refitting (probably not necessary here)
+        vecPvRefitContributorUsed[entry] = true; /// restore the track for the next PV refitting of this collision
 
         if (recalcImpPar) {
           // fill the histograms for refitted PV with good Chi2
@@ -1123,7 +1127,6 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
   /// \param collision is the collision iterator
   /// \param trackIndicesCollision are the track indices associated to this collision (from track-to-collision-associator)
   /// \param pvContrCollision are the PV contributors of this collision
-  /// \param bcWithTimeStamps is the bc with timestamp for PVrefit
   /// \param pvRefitDcaPerTrack is a vector to be filled with track dcas after PV refit
   /// \param pvRefitPvCoordPerTrack is a vector to be filled with PV coordinates after PV refit
   /// \param pvRefitPvCovMatrixPerTrack is a vector to be filled with PV coordinate covariances after PV refit
@@ -1132,13 +1135,15 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
                        TTracks const& tracks,
                        GroupedTrackIndices const& trackIndicesCollision,
                        GroupedPvContributors const& pvContrCollision,
-                       aod::BCsWithTimestamps const& bcWithTimeStamps,
+                       aod::BCsWithTimestamps const&,
                        std::vector<std::array<float, 2>>& pvRefitDcaPerTrack,
                        std::vector<std::array<float, 3>>& pvRefitPvCoordPerTrack,
                        std::vector<std::array<float, 6>>& pvRefitPvCovMatrixPerTrack)
   {
     const auto thisCollId = collision.globalIndex();
     auto tracksWithItsPid = soa::Attach<TTracks, aod::pidits::ITSNSigmaDe, aod::pidits::ITSNSigmaTr, aod::pidits::ITSNSigmaHe, aod::pidits::ITSNSigmaAl>(tracks);
+    // PV contributors and vertexer are prepared once per collision, when the first PV contributor is met
+    std::optional<PvRefitContext> pvRefitContext{};
 
     for (const auto& trackId : trackIndicesCollision) {
       int statusProng = BIT(CandidateType::NCandidateTypes) - 1; // all bits on
@@ -1157,20 +1162,14 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
         pvRefitPvCoord = {collision.posX(), collision.posY(), collision.posZ()};
         pvRefitPvCovMatrix = {collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
 
-        /// retrieve PV contributors for the current collision
-        std::vector<int64_t> vecPvContributorGlobId{};
-        std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
-
-        for (const auto& contributor : pvContrCollision) {
-          vecPvContributorGlobId.push_back(contributor.globalIndex());
-          vecPvContributorTrackParCov.push_back(getTrackParCov(contributor));
+        if (!pvRefitContext) {
+          preparePvRefit(collision, pvContrCollision, pvRefitContext.emplace());
         }
         if (config.debugPvRefit) {
-          LOG(info) << "### vecPvContributorGlobId.size()=" << vecPvContributorGlobId.size() << ", vecPvContributorTrackParCov.size()=" << vecPvContributorTrackParCov.size() << ", N. original contributors=" << collision.numContrib();
           /// Perform the PV refit only for tracks with an assigned collision
           LOG(info) << "[BEFORE performPvRefitTrack] track.collision().globalIndex(): " << collision.globalIndex();
         }
-        performPvRefitTrack(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, track, pvRefitPvCoord, pvRefitPvCovMatrix, pvRefitDcaXYDcaZ);
+        performPvRefitTrack(collision, *pvRefitContext, track, pvRefitPvCoord, pvRefitPvCovMatrix, pvRefitDcaXYDcaZ);
         // we subtract the offset since trackIdx is the global index referred to the total track table
         const auto trackIdx = track.globalIndex();
         pvRefitDcaPerTrack[trackIdx] = pvRefitDcaXYDcaZ;
@@ -20,6 +20,7 @@
 #include "PWGHF/Core/DecayChannels.h"
 #include "PWGHF/Utils/utilsMcMatching.h"
 
+#include "Common/Core/McDecayIndex.h"
 #include "Common/Core/RecoDecay.h"
 
 #include <CommonConstants/PhysicsConstants.h>
@@ -132,7 +133,8 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
                           TMcParticlesPerColl const& mcParticlesPerMcColl,
                           TCursor& rowMcMatchGen,
                           const bool rejectBackground,
-                          std::vector<int> const& pdgMothersCorrelBkg = {})
+                          std::vector<int> const& pdgMothersCorrelBkg = {},
+                          McDecayIndex* mcIndex = nullptr)
 {
   using namespace o2::constants::physics;
   using namespace o2::hf_decay::hf_cand_3prong;
@@ -180,17 +182,17 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
           if (finalState.size() == 5) { // o2-linter: disable=magic-number (partially reconstructed 3-prong decays from 5-prong decays)
             std::array<int, 5> arrPdgDaughtersMain5Prongs = std::array{finalState[0], finalState[1], finalState[2], finalState[3], finalState[4]};
             o2::hf_decay::flipPdgSign(particle.pdgCode(), +kPi0, arrPdgDaughtersMain5Prongs);
-            RecoDecay::getDaughters<false>(particle, &arrAllDaughtersIndex, arrPdgDaughtersMain5Prongs, depthMainMax);
-            matched = RecoDecay::isMatchedMCGen(mcParticles, particle, pdgMother, arrPdgDaughtersMain5Prongs, true, &sign, -1);
+            RecoDecay::getDaughters<false>(mcIndex, particle, &arrAllDaughtersIndex, arrPdgDaughtersMain5Prongs, depthMainMax);
+            matched = RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, pdgMother, arrPdgDaughtersMain5Prongs, true, &sign, -1);
           } else if (finalState.size() == 4) { // o2-linter: disable=magic-number (partially reconstructed 3-prong decays from 4-prong decays)
             std::array<int, 4> arrPdgDaughtersMain4Prongs = std::array{finalState[0], finalState[1], finalState[2], finalState[3]};
             o2::hf_decay::flipPdgSign(particle.pdgCode(), +kPi0, arrPdgDaughtersMain4Prongs);
-            RecoDecay::getDaughters<false>(particle, &arrAllDaughtersIndex, arrPdgDaughtersMain4Prongs, depthMainMax);
-            matched = RecoDecay::isMatchedMCGen(mcParticles, particle, pdgMother, arrPdgDaughtersMain4Prongs, true, &sign, -1);
+            RecoDecay::getDaughters<false>(mcIndex, particle, &arrAllDaughtersIndex, arrPdgDaughtersMain4Prongs, depthMainMax);
+            matched = RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, pdgMother, arrPdgDaughtersMain4Prongs, true, &sign, -1);
           } else if (finalState.size() == 3) { // o2-linter: disable=magic-number (fully reconstructed 3-prong decays)
             std::array<int, 3> arrPdgDaughtersMain3Prongs = std::array{finalState[0], finalState[1], finalState[2]};
-            RecoDecay::getDaughters<false>(particle, &arrAllDaughtersIndex, arrPdgDaughtersMain3Prongs, depthMainMax);
-            matched = RecoDecay::isMatchedMCGen(mcParticles, particle, pdgMother, arrPdgDaughtersMain3Prongs, true, &sign, depthMainMax);
+            RecoDecay::getDaughters<false>(mcIndex, particle, &arrAllDaughtersIndex, arrPdgDaughtersMain3Prongs, depthMainMax);
+            matched = RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, pdgMother, arrPdgDaughtersMain3Prongs, true, &sign, depthMainMax);
           } else {
             LOG(fatal) << "Final state size not supported: " << finalState.size();
             return;
@@ -201,16 +203,16 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
             std::vector<int> arrResoDaughIndex = {};
             if (std::abs(pdgMother) == Pdg::kDStar) {
               std::vector<int> arrResoDaughIndexDStar = {};
-              RecoDecay::getDaughters(particle, &arrResoDaughIndexDStar, std::array{0}, DepthResoMax);
+              RecoDecay::getDaughters(mcIndex, particle, &arrResoDaughIndexDStar, std::array{0}, DepthResoMax);
               for (const int iDaug : arrResoDaughIndexDStar) { // o2-linter: disable=const-ref-in-for-loop (not necessary for int type)
                 auto daughDstar = mcParticles.rawIteratorAt(iDaug);
                 if (std::abs(daughDstar.pdgCode()) == Pdg::kD0 || std::abs(daughDstar.pdgCode()) == Pdg::kDPlus) {
-                  RecoDecay::getDaughters(daughDstar, &arrResoDaughIndex, std::array{0}, DepthResoMax);
+                  RecoDecay::getDaughters(mcIndex, daughDstar, &arrResoDaughIndex, std::array{0}, DepthResoMax);
                   break;
                 }
               }
             } else {
-              RecoDecay::getDaughters(particle, &arrResoDaughIndex, std::array{0}, DepthResoMax);
+              RecoDecay::getDaughters(mcIndex, particle, &arrResoDaughIndex, std::array{0}, DepthResoMax);
             }
             std::array<int, NDaughtersResonant> arrPdgDaughters = {};
             if (arrResoDaughIndex.size() == NDaughtersResonant) {
@@ -231,7 +233,7 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
 
       // D± → π± K∓ π±
       if (flagChannelMain == 0) {
-        if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kDPlus, std::array{+kPiPlus, -kKPlus, +kPiPlus}, true, &sign, 2)) {
+        if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kDPlus, std::array{+kPiPlus, -kKPlus, +kPiPlus}, true, &sign, 2)) {
           flagChannelMain = sign * DecayChannelMain::DplusToPiKPi;
         }
       }
@@ -239,18 +241,18 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
       // Ds± → K± K∓ π± and D± → K± K∓ π±
       if (flagChannelMain == 0) {
         bool isDplus = false;
-        if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kDS, std::array{+kKPlus, -kKPlus, +kPiPlus}, true, &sign, 2)) {
+        if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kDS, std::array{+kKPlus, -kKPlus, +kPiPlus}, true, &sign, 2)) {
           // DecayType::DsToKKPi is used to flag both Ds± → K± K∓ π± and D± → K± K∓ π±
           // TODO: move to different and explicit flags
           flagChannelMain = sign * DecayChannelMain::DsToPiKK;
-        } else if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kDPlus, std::array{+kKPlus, -kKPlus, +kPiPlus}, true, &sign, 2)) {
+        } else if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kDPlus, std::array{+kKPlus, -kKPlus, +kPiPlus}, true, &sign, 2)) {
           // DecayType::DsToKKPi is used to flag both Ds± → K± K∓ π± and D± → K± K∓ π±
           // TODO: move to different and explicit flags
           flagChannelMain = sign * DecayChannelMain::DplusToPiKK;
           isDplus = true;
         }
         if (flagChannelMain != 0) {
-          RecoDecay::getDaughters(particle, &arrDaughIndex, std::array{0}, 1);
+          RecoDecay::getDaughters(mcIndex, particle, &arrDaughIndex, std::array{0}, 1);
           if (arrDaughIndex.size() == NDaughtersResonant) {
             for (auto iProng = 0u; iProng < arrDaughIndex.size(); ++iProng) {
               auto daughI = mcParticles.rawIteratorAt(arrDaughIndex[iProng]);
@@ -267,18 +269,18 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
 
       // D*± → D0(bar) π±
       if (flagChannelMain == 0) {
-        if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kDStar, std::array{+kPiPlus, +kPiPlus, -kKPlus}, true, &sign, 2)) {
+        if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kDStar, std::array{+kPiPlus, +kPiPlus, -kKPlus}, true, &sign, 2)) {
           flagChannelMain = sign * DecayChannelMain::DstarToPiKPi;
         }
       }
 
       // Λc± → p± K∓ π±
       if (flagChannelMain == 0) {
-        if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kLambdaCPlus, std::array{+kProton, -kKPlus, +kPiPlus}, true, &sign, 2)) {
+        if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kLambdaCPlus, std::array{+kProton, -kKPlus, +kPiPlus}, true, &sign, 2)) {
           flagChannelMain = sign * DecayChannelMain::LcToPKPi;
 
           // Flagging the different Λc± → p± K∓ π± decay channels
-          RecoDecay::getDaughters(particle, &arrDaughIndex, std::array{0}, 1);
+          RecoDecay::getDaughters(mcIndex, particle, &arrDaughIndex, std::array{0}, 1);
           if (arrDaughIndex.size() == NDaughtersResonant) {
             for (auto iProng = 0u; iProng < arrDaughIndex.size(); ++iProng) {
               auto daughI = mcParticles.rawIteratorAt(arrDaughIndex[iProng]);
@@ -297,14 +299,14 @@ void fillMcMatchGen3Prong(TMcParticles const& mcParticles,
 
       // Ξc± → p± K∓ π±
       if (flagChannelMain == 0) {
-        if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kXiCPlus, std::array{+kProton, -kKPlus, +kPiPlus}, true, &sign, 2)) {
+        if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kXiCPlus, std::array{+kProton, -kKPlus, +kPiPlus}, true, &sign, 2)) {
           flagChannelMain = sign * DecayChannelMain::XicToPKPi;
         }
       }
 
       // cd± → de± K∓ π±
       if (flagChannelMain == 0) {
-        if (RecoDecay::isMatchedMCGen(mcParticles, particle, Pdg::kCDeuteron, std::array{+Pdg::kDeuteron, -kKPlus, +kPiPlus}, true, &sign, 1)) {
+        if (RecoDecay::isMatchedMCGen(mcIndex, mcParticles, particle, Pdg::kCDeuteron, std::array{+Pdg::kDeuteron, -kKPlus, +kPiPlus}, true, &sign, 1)) {
           flagChannelMain = sign * DecayChannelMain::CDeuteronToDeKPi;
           flagChannelResonant = o2::hf_decay::getResonantDecayCDeuteron(particle);
         }
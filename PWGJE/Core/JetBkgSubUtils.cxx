@@ -23,7 +23,9 @@
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/Selector.hh>
+#include <fastjet/RectangularGrid.hh>
 #include <fastjet/contrib/ConstituentSubtractor.hh>
+#include <fastjet/tools/GridMedianBackgroundEstimator.hh>
 #include <fastjet/tools/Subtractor.hh>
 
 #include <algorithm>
@@ -48,10 +50,14 @@ JetBkgSubUtils::JetBkgSubUtils(float jetBkgR_out, float bkgEtaMin_out, float bkg
 
 void JetBkgSubUtils::initialise()
 {
+  if (isInitialised) {
+    return;
+  }
   // Note: recommended to use R=0.2
   jetDefBkg = fastjet::JetDefinition(algorithmBkg, jetBkgR, recombSchemeBkg, fastjet::Best);
   areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   selRho = fastjet::SelectorEtaRange(bkgEtaMin + jetBkgR, bkgEtaMax - jetBkgR) && fastjet::SelectorPhiRange(bkgPhiMin, bkgPhiMax) && !fastjet::SelectorNHardest(nHardReject); // here we have to put rap range, to be checked!
+  isInitialised = true;
 }
 
 std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub)
@@ -107,6 +113,35 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vect
   return std::make_tuple(rho, rhoM);
 }
 
+std::tuple<double, double> JetBkgSubUtils::estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles)
+{
+  if (inputParticles.size() == 0) {
+    return std::make_tuple(0.0, 0.0);
+  }
+
+  // tiles are only kept if their centre lies inside the phi acceptance, the eta range is covered by the grid itself
+  fastjet::RectangularGrid grid(bkgEtaMin, bkgEtaMax, gridSpacing, gridSpacing, fastjet::SelectorPhiRange(bkgPhiMin, bkgPhiMax));
+  fastjet::GridMedianBackgroundEstimator gridEstimator(grid);
+  gridEstimator.set_compute_rho_m(true);
+  gridEstimator.set_particles(inputParticles);
+
+  return std::make_tuple(gridEstimator.rho(), gridEstimator.rho_m());
+}
+
+std::tuple<double, double> JetBkgSubUtils::estimateRho(const std::vector<fastjet::PseudoJet>& inputParticles, BkgSubEstimator estimator)
+{
+  switch (estimator) {
+    case BkgSubEstimator::medianRho:
+      return estimateRhoAreaMedian(inputParticles, false);
+    case BkgSubEstimator::medianRhoSparse:
+      return estimateRhoAreaMedian(inputParticles, true);
+    case BkgSubEstimator::gridMedianRho:
+      return estimateRhoGridMedian(inputParticles);
+    default:
+      return std::make_tuple(0.0, 0.0);
+  }
+}
+
 fastjet::PseudoJet JetBkgSubUtils::doRhoAreaSub(const fastjet::PseudoJet& jet, double rhoParam, double rhoMParam)
 {
 
@@ -120,19 +155,26 @@ fastjet::PseudoJet JetBkgSubUtils::doRhoAreaSub(const fastjet::PseudoJet& jet, d
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSub(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam)
 {
   JetBkgSubUtils::initialise();
-  fastjet::contrib::ConstituentSubtractor constituentSub(rhoParam, rhoMParam);
+  double maxEta = std::max(std::abs(bkgEtaMin), std::abs(bkgEtaMax));
+  if (eventConstSub) {
+    // the ghosts built for the first event are reused, only the background densities change
+    eventConstSub->set_scalar_background_density(rhoParam, rhoMParam);
+    return eventConstSub->subtract_event(inputParticles, maxEta);
+  }
+
+  fastjet::contrib::ConstituentSubtractor& constituentSub = eventConstSub.emplace(rhoParam, rhoMParam);
   constituentSub.set_distance_type(fastjet::contrib::ConstituentSubtractor::deltaR); /// deltaR=sqrt((y_i-y_j)^2+(phi_i-phi_j)^2)), longitudinal Lorentz invariant
   constituentSub.set_max_distance(constSubRMax);
   constituentSub.set_alpha(constSubAlpha);
   constituentSub.set_ghost_area(ghostAreaSpec.ghost_area());
-  constituentSub.set_max_eta(std::max(std::abs(bkgEtaMin), std::abs(bkgEtaMax)));
+  constituentSub.set_max_eta(maxEta);
 
   // by default, the masses of all particles are set to zero. With this flag the jet mass will also be subtracted
   if (doRhoMassSub) {
     constituentSub.set_do_mass_subtraction();
   }
 
-  return constituentSub.subtract_event(inputParticles, std::max(std::abs(bkgEtaMin), std::abs(bkgEtaMax)));
+  return constituentSub.subtract_event(inputParticles, maxEta);
 }
 
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doJetConstSub(std::vector<fastjet::PseudoJet>& jets, double rhoParam, double rhoMParam)
@@ -22,7 +22,9 @@
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/Selector.hh>
+#include <fastjet/contrib/ConstituentSubtractor.hh>
 
+#include <optional>
 #include <tuple>
 #include <vector>
 
@@ -30,7 +32,8 @@
 
 enum class BkgSubEstimator { none = 0,
                              medianRho = 1,
-                             medianRhoSparse = 2
+                             medianRhoSparse = 2,
+                             gridMedianRho = 3
                              // perpendicular cone method is in JetUtilities
 };
 
@@ -53,6 +56,7 @@ class JetBkgSubUtils
   ~JetBkgSubUtils() = default;
 
   /// @brief Setting the selectors after the input values have been initialised
+  /// The definitions are only rebuilt if one of the settings changed since the last call
   void initialise();
 
   /// @brief Setting the jet algorithm and the recombination scheme
@@ -60,6 +64,7 @@ class JetBkgSubUtils
   {
     algorithmBkg = algorithmBkg_out;
     recombSchemeBkg = recombSchemeBkg_out;
+    resetCache();
   }
 
   /// @brief Method for estimating the jet background density using the median method or the sparse method
@@ -68,6 +73,17 @@ class JetBkgSubUtils
   /// @return Rho, RhoM the underlying event density
   std::tuple<double, double> estimateRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub);
 
+  /// @brief Method for estimating the jet background density from the median of rectangular eta-phi tiles, without clustering the event
+  /// @param inputParticles (all particles in the event)
+  /// @return Rho, RhoM the underlying event density
+  std::tuple<double, double> estimateRhoGridMedian(const std::vector<fastjet::PseudoJet>& inputParticles);
+
+  /// @brief Method for estimating the jet background density with the chosen estimator
+  /// @param inputParticles (all particles in the event)
+  /// @param estimator medianRho, medianRhoSparse or gridMedianRho
+  /// @return Rho, RhoM the underlying event density
+  std::tuple<double, double> estimateRho(const std::vector<fastjet::PseudoJet>& inputParticles, BkgSubEstimator estimator);
+
   /// @brief method that subtracts the background from jets using the area method
   /// @param jet input jet to be background subtracted
   /// @param rhoParam the underlying evvent density vs pT (to be set)
@@ -76,6 +92,7 @@ class JetBkgSubUtils
   fastjet::PseudoJet doRhoAreaSub(const fastjet::PseudoJet& jet, double rhoParam, double rhoMParam);
 
   /// @brief method that subtracts the background from the input particles using the event-wise cosntituent subtractor
+  /// The subtractor and its ghost grid are kept between calls, only the densities are updated per event
   /// @param inputParticles (all the tracks/clusters/particles in the event)
   /// @param rhoParam the underlying evvent density vs pT (to be set)
   /// @param rhoParam the underlying evvent density vs jet mass (to be set)
@@ -90,24 +107,40 @@ class JetBkgSubUtils
   std::vector<fastjet::PseudoJet> doJetConstSub(std::vector<fastjet::PseudoJet>& jets, double rhoParam, double rhoMParam);
 
   // Setters
-  void setJetBkgR(float jetbkgR_out) { jetBkgR = jetbkgR_out; }
+  void setJetBkgR(float jetbkgR_out)
+  {
+    jetBkgR = jetbkgR_out;
+    resetCache();
+  }
   void setPhiMinMax(float phimin_out, float phimax_out)
   {
     bkgPhiMin = phimin_out;
     bkgPhiMax = phimax_out;
+    resetCache();
   }
   void setEtaMinMax(float etamin_out, float etamax_out)
   {
     bkgEtaMin = etamin_out;
     bkgEtaMax = etamax_out;
+    resetCache();
   }
   void setConstSubAlphaRMax(float alpha_out, float rmax_out)
   {
     constSubAlpha = alpha_out;
     constSubRMax = rmax_out;
+    resetCache();
   }
-  void setDoRhoMassSub(bool doMSub_out = true) { doRhoMassSub = doMSub_out; }
-  void setGhostAreaSpec(fastjet::GhostedAreaSpec ghostAreaSpec_out) { ghostAreaSpec = ghostAreaSpec_out; }
+  void setDoRhoMassSub(bool doMSub_out = true)
+  {
+    doRhoMassSub = doMSub_out;
+    resetCache();
+  }
+  void setGhostAreaSpec(fastjet::GhostedAreaSpec ghostAreaSpec_out)
+  {
+    ghostAreaSpec = ghostAreaSpec_out;
+    resetCache();
+  }
+  void setGridSpacing(float gridSpacing_out) { gridSpacing = gridSpacing_out; }
 
   // Getters
   float getJetBkgR() const { return jetBkgR; }
@@ -118,6 +151,7 @@ class JetBkgSubUtils
   float getConstSubAlpha() const { return constSubAlpha; }
   float getConstSubRMax() const { return constSubRMax; }
   float getDoRhoMassSub() const { return doRhoMassSub; }
+  float getGridSpacing() const { return gridSpacing; }
   fastjet::GhostedAreaSpec getGhostAreaSpec() const { return ghostAreaSpec; }
   fastjet::JetDefinition getJetDefinition() const { return jetDefBkg; }
   fastjet::AreaDefinition getAreaDefinition() const { return areaDefBkg; }
@@ -127,6 +161,13 @@ class JetBkgSubUtils
   double getMd(fastjet::PseudoJet jet) const;
 
  protected:
+  /// @brief Invalidate the cached definitions and the event-wise subtractor after a change of settings
+  void resetCache()
+  {
+    isInitialised = false;
+    eventConstSub.reset();
+  }
+
   float jetBkgR = 0.2;
   float bkgEtaMin = -0.9;
   float bkgEtaMax = 0.9;
@@ -136,6 +177,7 @@ class JetBkgSubUtils
   float constSubRMax = 0.24;
   int nHardReject = 2;
   bool doRhoMassSub = false; /// flag whether to do jet mass subtraction with the const sub
+  float gridSpacing = 0.55;  /// size of the eta-phi tiles used by the grid-median estimator
 
   fastjet::GhostedAreaSpec ghostAreaSpec = fastjet::GhostedAreaSpec();
   fastjet::JetAlgorithm algorithmBkg = fastjet::kt_algorithm;
@@ -144,6 +186,9 @@ class JetBkgSubUtils
   fastjet::AreaDefinition areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   fastjet::Selector selRho = fastjet::Selector();
 
+  bool isInitialised = false;                                           //! definitions above are up to date with the settings
+  std::optional<fastjet::contrib::ConstituentSubtractor> eventConstSub; //! event-wise subtractor, reused together with its ghosts
+
 }; // class JetBkgSubUtils
 
 #endif // PWGJE_CORE_JETBKGSUBUTILS_H_
@@ -622,6 +622,108 @@ std::unique_ptr<TF1> setResolutionFunction(T const& vecParams)
   return fResoFunc;
 }
 
+/**
+ * Cumulative integral of a resolution function, tabulated once so that the track probabilities
+ * do not need a numerical integration per track.
+ *
+ * The integral from the lower edge of the table is computed on a uniform grid with a 5-point
+ * Gauss-Legendre rule per interval and interpolated with cubic Hermite polynomials, using the
+ * function values as derivatives. The largest deviation of the interpolation from the integral
+ * at the interval centres is stored as an estimate of the error of the table.
+ */
+class ResolutionFunctionCdf
+{
+ public:
+  /**
+   * Tabulates the cumulative integral of a resolution function.
+   *
+   * @param fResoFunc The resolution function.
+   * @param xMin Lower edge of the table, i.e. the lower limit of integration.
+   * @param xMax Upper edge of the table.
+   * @param nSteps Number of intervals of the table.
+   */
+  void build(TF1 const& fResoFunc, double xMin, double xMax = 0., int nSteps = 4000)
+  {
+    mXMin = xMin;
+    mStep = (xMax - xMin) / nSteps;
+    mCdf.assign(nSteps + 1, 0.);
+    mPdf.assign(nSteps + 1, 0.);
+    mMaxError = 0.;
+    for (int i = 0; i <= nSteps; i++) {
+      mPdf[i] = fResoFunc.Eval(mXMin + i * mStep);
+    }
+    for (int i = 0; i < nSteps; i++) {
+      const double xLow = mXMin + i * mStep;
+      const double integralToCentre = integrateGaussLegendre(fResoFunc, xLow, xLow + 0.5 * mStep);
+      mCdf[i + 1] = mCdf[i] + integralToCentre + integrateGaussLegendre(fResoFunc, xLow + 0.5 * mStep, xLow + mStep);
+      mMaxError = std::max(mMaxError, std::abs(interpolate(i, 0.5) - (mCdf[i] + integralToCentre)));
+    }
+  }
+
+  /**
+   * Integral of the resolution function between a and b.
+   * Limits outside of the table are moved to its edges.
+   */
+  double integral(double a, double b) const { return cdf(b) - cdf(a); }
+
+  /// Integral of the resolution function over the whole table
+  double total() const { return mCdf.empty() ? 0. : mCdf.back(); }
+
+  /// Largest absolute deviation of the interpolated cumulative integral found at the interval centres
+  double maxError() const { return mMaxError; }
+
+ private:
+  double cdf(double x) const
+  {
+    if (mCdf.size() < 2 || std::isnan(x)) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    const int nSteps = mCdf.size() - 1;
+    const double t = std::clamp((x - mXMin) / mStep, 0., static_cast<double>(nSteps));
+    const int i = std::min(static_cast<int>(t), nSteps - 1);
+    return interpolate(i, t - i);
+  }
+
+  // cubic Hermite interpolation in interval i at the fraction u of the interval
+  double interpolate(int i, double u) const
+  {
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+    return (2. * u3 - 3. * u2 + 1.) * mCdf[i] + (u3 - 2. * u2 + u) * mStep * mPdf[i] + (-2. * u3 + 3. * u2) * mCdf[i + 1] + (u3 - u2) * mStep * mPdf[i + 1];
+  }
+
+  static double integrateGaussLegendre(TF1 const& fResoFunc, double a, double b)
+  {
+    static constexpr std::array<double, 5> Nodes = {-0.9061798459386640, -0.5384693101056831, 0., 0.5384693101056831, 0.9061798459386640};
+    static constexpr std::array<double, 5> Weights = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891};
+    const double centre = 0.5 * (a + b);
+    const double halfWidth = 0.5 * (b - a);
+    double sum = 0.;
+    for (std::size_t i = 0; i < Nodes.size(); i++) {
+      sum += Weights[i] * fResoFunc.Eval(centre + halfWidth * Nodes[i]);
+    }
+    return sum * halfWidth;
+  }
+
+  double mXMin = 0.;
+  double mStep = 1.;
+  double mMaxError = 0.;
+  std::vector<double> mCdf; // integral from mXMin to each grid point
+  std::vector<double> mPdf; // resolution function at each grid point
+};
+
+// integral of a resolution function, numerical for a TF1 and from the table for a ResolutionFunctionCdf
+template <typename T>
+double integrateResolutionFunction(T const& fResoFunc, double a, double b)
+{
+  return fResoFunc->Integral(a, b);
+}
+
+inline double integrateResolutionFunction(ResolutionFunctionCdf const& cdfResoFunc, double a, double b)
+{
+  return cdfResoFunc.integral(a, b);
+}
+
 /**
  * Calculates the probability of a given track being associated with a jet, based on the geometric
  * sign and the resolution function of the jet's impact parameter significance. This probability
@@ -629,7 +731,8 @@ std::unique_ptr<TF1> setResolutionFunction(T const& vecParams)
  * secondary vertices, aiding in jet flavor tagging.
  *
  * @param fResoFuncjet The resolution function for the jet, used to model the distribution of impact
- *                     parameter significances for tracks associated with the jet.
+ *                     parameter significances for tracks associated with the jet. Either a TF1 (pointer)
+ *                     or its tabulated ResolutionFunctionCdf, built with minSignImpXYSig as lower edge.
  * @param track The track for which the probability is being calculated.
  * @param minSignImpXYSig The minimum significance of the impact parameter in the XY plane, used as
  *                        the lower limit for integration of the resolution function. Defaults to -40.
@@ -643,7 +746,7 @@ float getTrackProbability(T const& fResoFuncjet, U const& track, float minSignIm
   auto varSignImpXYSig = std::abs(track.dcaXY()) / track.sigmadcaXY();
   if (-varSignImpXYSig < minSignImpXYSig)
     varSignImpXYSig = -minSignImpXYSig - 0.01; // To avoid overflow for integral
-  probTrack = fResoFuncjet->Integral(minSignImpXYSig, -varSignImpXYSig) / fResoFuncjet->Integral(minSignImpXYSig, 0);
+  probTrack = integrateResolutionFunction(fResoFuncjet, minSignImpXYSig, -varSignImpXYSig) / integrateResolutionFunction(fResoFuncjet, minSignImpXYSig, 0);
 
   return probTrack;
 }
@@ -689,9 +792,13 @@ float getJetProbability(T const& fResoFuncjet, U const& jet, V const& /*tracks*/
   if (jetTracksPt.size() < 2)
     return -1;
 
+  // terms (-ln P)^i / i! of the sum, each obtained from the previous one
+  const double minusLogProb = -1 * std::log(trackjetProb);
+  double term = 1.;
   float sumjetProb = 0.;
   for (std::vector<float>::size_type i = 0; i < jetTracksPt.size(); i++) {
-    sumjetProb += (std::pow(-1 * std::log(trackjetProb), static_cast<int>(i)) / TMath::Factorial(i));
+    sumjetProb += term;
+    term *= minusLogProb / (i + 1);
   }
 
   jetProb = trackjetProb * sumjetProb;
@@ -700,7 +807,7 @@ float getJetProbability(T const& fResoFuncjet, U const& jet, V const& /*tracks*/
 
 // overloading for the case of using resolution function for each pt range
 template <typename T, typename U, typename V>
-float getJetProbability(std::vector<std::unique_ptr<T>> const& fResoFuncjets, U const& jet, V const& /*tracks*/, float trackDcaXYMax, float trackDcaZMax, float minSignImpXYSig = -10)
+float getJetProbability(std::vector<T> const& fResoFuncjets, U const& jet, V const& /*tracks*/, float trackDcaXYMax, float trackDcaZMax, float minSignImpXYSig = -10)
 {
   std::vector<float> jetTracksPt;
   float trackjetProb = 1.;
@@ -738,9 +845,13 @@ float getJetProbability(std::vector<std::unique_ptr<T>> const& fResoFuncjets, U
   if (jetTracksPt.size() < 2)
     return -1;
 
+  // terms (-ln P)^i / i! of the sum, each obtained from the previous one
+  const double minusLogProb = -1 * std::log(trackjetProb);
+  double term = 1.;
   float sumjetProb = 0.;
   for (std::vector<float>::size_type i = 0; i < jetTracksPt.size(); i++) {
-    sumjetProb += (std::pow(-1 * std::log(trackjetProb), static_cast<int>(i)) / TMath::Factorial(i));
+    sumjetProb += term;
+    term *= minusLogProb / (i + 1);
   }
 
   jetProb = trackjetProb * sumjetProb;
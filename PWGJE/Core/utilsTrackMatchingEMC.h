@@ -16,14 +16,16 @@
 #ifndef PWGJE_CORE_UTILSTRACKMATCHINGEMC_H_
 #define PWGJE_CORE_UTILSTRACKMATCHINGEMC_H_
 
-#include <TKDTree.h>
+#include <CommonConstants/MathConstants.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
-#include <limits>
+#include <cstdint>
 #include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace tmemcutilities
@@ -35,12 +37,193 @@ struct MatchResult {
   std::vector<std::vector<float>> matchDeltaEta;
 };
 
+/**
+ * Bucketed eta-phi grid of track positions for the cluster-track matching.
+ *
+ * The tracks are sorted into cells of at least the matching distance in eta and phi,
+ * so that all tracks within the matching distance of a cluster are in the 3x3 cells around it.
+ * The phi axis is periodic: the first and the last phi cells are neighbours.
+ * Track and cluster phi are expected in [0, 2pi).
+ * The grid is built once per collision and can be searched for the clusters of any clusterizer.
+ */
+class TrackGrid
+{
+ public:
+  static constexpr int MaxMatches = 50; // size of the k-nearest buffer, i.e. maximum number of matches per cluster
+
+  /**
+   * Fill the grid with a track collection.
+   *
+   * @param trackPhi track collection phi.
+   * @param trackEta track collection eta.
+   * @param maxMatchingDistance Maximum matching distance the grid will be searched with.
+   */
+  void build(std::span<const float> trackPhi, std::span<const float> trackEta, double maxMatchingDistance)
+  {
+    if (trackPhi.size() != trackEta.size()) {
+      throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
+    }
+    clear();
+    const std::size_t nTracks = trackEta.size();
+    if (nTracks == 0) {
+      return;
+    }
+    mMaxMatchingDistance = maxMatchingDistance;
+    // slightly larger than the matching distance so that rounding cannot push a match beyond the neighbouring cell;
+    // larger cells only make the search visit more tracks, the minimum size bounds the number of cells
+    mCellSize = std::max(maxMatchingDistance * (1. + 1.e-3), MinCellSize);
+    const auto [etaMin, etaMax] = std::minmax_element(trackEta.begin(), trackEta.end());
+    mEtaMin = *etaMin;
+    mNEtaBins = bin((*etaMax - *etaMin) / mCellSize, MaxEtaBins) + 1;
+    mNPhiBins = std::max(1, static_cast<int>(o2::constants::math::TwoPI / mCellSize));
+    mPhiBinWidth = o2::constants::math::TwoPI / mNPhiBins;
+
+    // counting sort of the tracks into the cells
+    std::vector<int> cellOfTrack(nTracks);
+    mCellStart.assign(static_cast<std::size_t>(mNEtaBins) * mNPhiBins + 1, 0);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      cellOfTrack[iTrack] = cell(etaBin(trackEta[iTrack]), phiBin(trackPhi[iTrack]));
+      mCellStart[cellOfTrack[iTrack] + 1]++;
+    }
+    for (std::size_t iCell = 1; iCell < mCellStart.size(); iCell++) {
+      mCellStart[iCell] += mCellStart[iCell - 1];
+    }
+    mEta.resize(nTracks);
+    mPhi.resize(nTracks);
+    mIndex.resize(nTracks);
+    std::vector<int> fill(mCellStart.begin(), mCellStart.end() - 1);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      const int position = fill[cellOfTrack[iTrack]]++;
+      mEta[position] = trackEta[iTrack];
+      mPhi[position] = trackPhi[iTrack];
+      mIndex[position] = static_cast<int>(iTrack);
+    }
+    mTrackPhi.assign(trackPhi.begin(), trackPhi.end());
+    mTrackEta.assign(trackEta.begin(), trackEta.end());
+  }
+
+  void clear()
+  {
+    mCellStart.clear();
+    mEta.clear();
+    mPhi.clear();
+    mIndex.clear();
+    mTrackPhi.clear();
+    mTrackEta.clear();
+  }
+
+  std::size_t size() const { return mIndex.size(); }
+
+  /**
+   * Match clusters to the tracks of the grid.
+   *
+   * For each cluster, the maxNumberMatches closest tracks within the matching distance are stored,
+   * ordered by increasing distance. Exactly equidistant tracks are ordered by index.
+   *
+   * @param clusterPhi cluster collection phi.
+   * @param clusterEta cluster collection eta.
+   * @param maxNumberMatches Maximum number of matches (e.g. 5 closest), at most MaxMatches.
+   *
+   * @returns cluster to track index map with the track-cluster distances in phi and eta
+   */
+  MatchResult match(std::span<const float> clusterPhi, std::span<const float> clusterEta, int maxNumberMatches) const
+  {
+    const std::size_t nClusters = clusterEta.size();
+    MatchResult result;
+    if (nClusters == 0 || mIndex.empty() || maxNumberMatches <= 0) {
+      return result;
+    }
+    if (clusterPhi.size() != clusterEta.size()) {
+      throw std::invalid_argument("cluster collection eta and phi sizes don't match. Check the inputs.");
+    }
+    maxNumberMatches = std::min(maxNumberMatches, MaxMatches);
+
+    result.matchIndexTrack.resize(nClusters);
+    result.matchDeltaPhi.resize(nClusters);
+    result.matchDeltaEta.resize(nClusters);
+
+    std::array<std::pair<double, int>, MaxMatches> nearest; // (distance, track index) of the closest tracks found so far
+    for (std::size_t iCluster = 0; iCluster < nClusters; iCluster++) {
+      const float eta = clusterEta[iCluster];
+      const float phi = clusterPhi[iCluster];
+      int nNearest = 0;
+      const int iEta = etaBin(eta);
+      const int iPhi = phiBin(phi);
+      const int nPhiNeighbours = std::min(mNPhiBins, 3);
+      for (int jEta = std::max(iEta - 1, 0); jEta <= std::min(iEta + 1, mNEtaBins - 1); jEta++) {
+        for (int dPhiBin = 0; dPhiBin < nPhiNeighbours; dPhiBin++) {
+          const int jPhi = nPhiNeighbours < 3 ? dPhiBin : (iPhi + dPhiBin - 1 + mNPhiBins) % mNPhiBins;
+          const int iCell = cell(jEta, jPhi);
+          for (int position = mCellStart[iCell]; position < mCellStart[iCell + 1]; position++) {
+            // same arithmetic as the previous KD-tree search: float differences, squares summed in double
+            const float deltaEta = eta - mEta[position];
+            float deltaPhi = phi - mPhi[position];
+            if (deltaPhi > o2::constants::math::PI) {
+              deltaPhi -= o2::constants::math::TwoPI;
+            } else if (deltaPhi < -o2::constants::math::PI) {
+              deltaPhi += o2::constants::math::TwoPI;
+            }
+            double distance2 = 0.;
+            distance2 += deltaEta * deltaEta;
+            distance2 += deltaPhi * deltaPhi;
+            const double distance = std::sqrt(distance2);
+            if (!(static_cast<float>(distance) < mMaxMatchingDistance)) {
+              continue;
+            }
+            const std::pair<double, int> candidate{distance, mIndex[position]};
+            if (nNearest == maxNumberMatches && !(candidate < nearest[nNearest - 1])) {
+              continue;
+            }
+            int insert = std::min(nNearest, maxNumberMatches - 1);
+            for (; insert > 0 && candidate < nearest[insert - 1]; insert--) {
+              nearest[insert] = nearest[insert - 1];
+            }
+            nearest[insert] = candidate;
+            nNearest = std::min(nNearest + 1, maxNumberMatches);
+          }
+        }
+      }
+      for (int m = 0; m < nNearest; m++) {
+        const int iTrack = nearest[m].second;
+        result.matchIndexTrack[iCluster].push_back(iTrack);
+        result.matchDeltaPhi[iCluster].push_back(mTrackPhi[iTrack] - phi);
+        result.matchDeltaEta[iCluster].push_back(mTrackEta[iTrack] - eta);
+      }
+    }
+    return result;
+  }
+
+ private:
+  static constexpr double MinCellSize = 0.01;
+  static constexpr int MaxEtaBins = 1000;
+
+  // positions outside of the axis (and NaN) go to the first or last bin, which keeps neighbouring positions in neighbouring bins
+  static int bin(double x, int nBins) { return x >= 0. ? static_cast<int>(std::min(x, nBins - 1.)) : 0; }
+  int etaBin(float eta) const { return bin((eta - mEtaMin) / mCellSize, mNEtaBins); }
+  int phiBin(float phi) const { return bin(phi / mPhiBinWidth, mNPhiBins); }
+  int cell(int iEta, int iPhi) const { return iEta * mNPhiBins + iPhi; }
+
+  double mMaxMatchingDistance = 0.;
+  double mCellSize = 1.;
+  double mPhiBinWidth = 1.;
+  float mEtaMin = 0.f;
+  int mNEtaBins = 1;
+  int mNPhiBins = 1;
+  std::vector<int> mCellStart;  // first position of each cell in the sorted track arrays
+  std::vector<float> mEta;      // track eta, sorted by cell
+  std::vector<float> mPhi;      // track phi, sorted by cell
+  std::vector<int> mIndex;      // track index in the input collection, sorted by cell
+  std::vector<float> mTrackPhi; // track phi, in input order
+  std::vector<float> mTrackEta; // track eta, in input order
+};
+
 /**
  * Match clusters and tracks.
  *
  * Match cluster with tracks, where maxNumberMatches are considered in dR=maxMatchingDistance.
  * If no unique match was found for a jet, an index of -1 is stored.
  * The same map is created for clusters matched to tracks e.g. for electron analyses.
+ * When the same tracks are matched to several cluster collections, build a TrackGrid once and use TrackGrid::match instead.
  *
  * @param clusterPhi cluster collection phi.
  * @param clusterEta cluster collection eta.
@@ -59,60 +242,13 @@ MatchResult matchTracksToCluster(
   double maxMatchingDistance,
   int maxNumberMatches)
 {
-  const std::size_t nClusters = clusterEta.size();
-  const std::size_t nTracks = trackEta.size();
-  MatchResult result;
-
-  if (nClusters == 0 || nTracks == 0) {
+  if (clusterEta.empty() || trackEta.empty()) {
     // There are no jets, so nothing to be done.
-    return result;
-  }
-  // Input sizes must match
-  if (clusterPhi.size() != clusterEta.size()) {
-    throw std::invalid_argument("cluster collection eta and phi sizes don't match. Check the inputs.");
-  }
-  if (trackPhi.size() != trackEta.size()) {
-    throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
-  }
-
-  result.matchIndexTrack.resize(nClusters);
-  result.matchDeltaPhi.resize(nClusters);
-  result.matchDeltaEta.resize(nClusters);
-
-  // Build the KD-trees using vectors
-  // We build two trees:
-  // treeBase, which contains the base collection.
-  // treeTag, which contains the tag collection.
-  // The trees are built to match in two dimensions (eta, phi)
-  TKDTree<int, float> treeTrack(trackEta.size(), 2, 1);
-  treeTrack.SetData(0, trackEta.data());
-  treeTrack.SetData(1, trackPhi.data());
-  treeTrack.Build();
-
-  // Find the track closest to each cluster.
-  for (std::size_t iCluster = 0; iCluster < nClusters; iCluster++) {
-    float point[2] = {clusterEta[iCluster], clusterPhi[iCluster]};
-    int index[50];      // size 50 for safety
-    float distance[50]; // size 50 for safery
-    std::fill_n(index, 50, -1);
-    std::fill_n(distance, 50, std::numeric_limits<float>::max());
-    treeTrack.FindNearestNeighbors(point, maxNumberMatches, index, distance);
-
-    // allocate enough memory
-    result.matchIndexTrack[iCluster].reserve(maxNumberMatches);
-    result.matchDeltaPhi[iCluster].reserve(maxNumberMatches);
-    result.matchDeltaEta[iCluster].reserve(maxNumberMatches);
-
-    // test whether indices are matching:
-    for (int m = 0; m < maxNumberMatches; m++) {
-      if (index[m] >= 0 && distance[m] < maxMatchingDistance) {
-        result.matchIndexTrack[iCluster].push_back(index[m]);
-        result.matchDeltaPhi[iCluster].push_back(trackPhi[index[m]] - clusterPhi[iCluster]);
-        result.matchDeltaEta[iCluster].push_back(trackEta[index[m]] - clusterEta[iCluster]);
-      }
-    }
+    return MatchResult{};
   }
-  return result;
+  TrackGrid grid;
+  grid.build(trackPhi, trackEta, maxMatchingDistance);
+  return grid.match(clusterPhi, clusterEta, maxNumberMatches);
 }
 }; // namespace tmemcutilities
 
@@ -175,6 +175,19 @@ struct EmcalCorrectionTask {
   std::vector<float> mClusterPhi;
   std::vector<float> mClusterEta;
 
+  // Tracks (and V0 legs) of the current collision used for the track matching,
+  // searched by all clusterizers and rebuilt only when the collision changes
+  struct MatchingTracks {
+    int64_t collisionId = -1;
+    std::vector<float> phi;
+    std::vector<float> eta;
+    std::vector<int64_t> globalIndex;
+    TrackGrid grid;
+    void reset() { collisionId = -1; }
+  };
+  MatchingTracks mMatchingTracks;
+  MatchingTracks mMatchingSecondaries;
+
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
   // QA
   o2::framework::HistogramRegistry mHistManager{"EMCALCorrectionTaskQAHistograms"};
@@ -435,6 +448,8 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    mMatchingTracks.reset();
+    mMatchingSecondaries.reset();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
 
@@ -525,8 +540,7 @@ struct EmcalCorrectionTask {
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
               MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+              const auto& trackGlobalIndex = doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
@@ -596,6 +610,8 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    mMatchingTracks.reset();
+    mMatchingSecondaries.reset();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
 
@@ -686,12 +702,10 @@ struct EmcalCorrectionTask {
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
               MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+              const auto& trackGlobalIndex = doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair);
 
               MatchResult indexMapPairSecondary;
-              std::vector<int64_t> secondaryGlobalIndex;
-              doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, secondaryGlobalIndex, tracks);
+              const auto& secondaryGlobalIndex = doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, tracks);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
@@ -763,6 +777,8 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    mMatchingTracks.reset();
+    mMatchingSecondaries.reset();
 
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
@@ -887,8 +903,7 @@ struct EmcalCorrectionTask {
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
               MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+              const auto& trackGlobalIndex = doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
@@ -958,6 +973,8 @@ struct EmcalCorrectionTask {
     nCluster = 0;
     nClusterAmb = 0;
     nCells = 0;
+    mMatchingTracks.reset();
+    mMatchingSecondaries.reset();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
       // Convert aod::Calo to o2::emcal::Cell which can be used with the clusterizer.
@@ -1080,12 +1097,10 @@ struct EmcalCorrectionTask {
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
               MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+              const auto& trackGlobalIndex = doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair);
 
               MatchResult indexMapPairSecondary;
-              std::vector<int64_t> secondaryGlobalIndex;
-              doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, secondaryGlobalIndex, tracks);
+              const auto& secondaryGlobalIndex = doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, tracks);
 
               // Store the clusters in the table where a matching collision could
               // be identified.
@@ -1440,29 +1455,57 @@ struct EmcalCorrectionTask {
     } // end of cluster loop
   }
 
+  // returns the global indices of the tracks, indexed by MatchResult::matchIndexTrack
   template <typename Collision>
-  void doTrackMatching(Collision const& col, MyGlobTracks const& tracks, MatchResult& indexMapPair, std::vector<int64_t>& trackGlobalIndex)
+  const std::vector<int64_t>& doTrackMatching(Collision const& col, MyGlobTracks const& tracks, MatchResult& indexMapPair)
   {
-    auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
-    int nTracksInCol = groupedTracks.size();
-    std::vector<float> trackPhi;
-    std::vector<float> trackEta;
-    // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(nTracksInCol);
-    trackEta.reserve(nTracksInCol);
-    trackGlobalIndex.reserve(nTracksInCol);
-    fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
+    if (mMatchingTracks.collisionId != col.globalIndex()) {
+      auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
+      int nTracksInCol = groupedTracks.size();
+      std::vector<float>& trackPhi = mMatchingTracks.phi;
+      std::vector<float>& trackEta = mMatchingTracks.eta;
+      std::vector<int64_t>& trackGlobalIndex = mMatchingTracks.globalIndex;
+      trackPhi.clear();
+      trackEta.clear();
+      trackGlobalIndex.clear();
+      // reserve memory to reduce on the fly memory allocation
+      trackPhi.reserve(nTracksInCol);
+      trackEta.reserve(nTracksInCol);
+      trackGlobalIndex.reserve(nTracksInCol);
+      fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
+      mMatchingTracks.grid.build(trackPhi, trackEta, maxMatchingDistance);
+      mMatchingTracks.collisionId = col.globalIndex();
+    }
+
+    indexMapPair = mMatchingTracks.grid.match(mClusterPhi, mClusterEta, MaxMatchesPerCluster);
+    return mMatchingTracks.globalIndex;
+  }
+
+  // returns the global indices of the V0 leg tracks, indexed by MatchResult::matchIndexTrack
+  template <typename Collision>
+  const std::vector<int64_t>& doSecondaryTrackMatching(Collision const& col, EMV0Legs const& v0legs, MatchResult& indexMapPair, MyGlobTracks const& tracks)
+  {
+    if (mMatchingSecondaries.collisionId != col.globalIndex()) {
+      fillSecondaryTrackInfo(col, v0legs, tracks);
+      mMatchingSecondaries.grid.build(mMatchingSecondaries.phi, mMatchingSecondaries.eta, maxMatchingDistance);
+      mMatchingSecondaries.collisionId = col.globalIndex();
+    }
 
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, MaxMatchesPerCluster);
+    indexMapPair = mMatchingSecondaries.grid.match(mClusterPhi, mClusterEta, MaxMatchesPerCluster);
+    return mMatchingSecondaries.globalIndex;
   }
 
   template <typename Collision>
-  void doSecondaryTrackMatching(Collision const& col, EMV0Legs const& v0legs, MatchResult& indexMapPair, std::vector<int64_t>& trackGlobalIndex, MyGlobTracks const& tracks)
+  void fillSecondaryTrackInfo(Collision const& col, EMV0Legs const& v0legs, MyGlobTracks const& tracks)
   {
     auto groupedV0Legs = v0legs.sliceBy(perCollisionEMV0Legs, col.globalIndex());
     int nLegsInCol = groupedV0Legs.size();
-    std::vector<float> trackPhi;
-    std::vector<float> trackEta;
+    std::vector<float>& trackPhi = mMatchingSecondaries.phi;
+    std::vector<float>& trackEta = mMatchingSecondaries.eta;
+    std::vector<int64_t>& trackGlobalIndex = mMatchingSecondaries.globalIndex;
+    trackPhi.clear();
+    trackEta.clear();
+    trackGlobalIndex.clear();
     // reserve memory to reduce on the fly memory allocation
     trackPhi.reserve(nLegsInCol);
     trackEta.reserve(nLegsInCol);
@@ -1489,7 +1532,6 @@ struct EmcalCorrectionTask {
       trackEta.emplace_back(trackEtaEmcal);
       trackGlobalIndex.emplace_back(track.globalIndex());
     }
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, MaxMatchesPerCluster);
   }
 
   template <typename Tracks>
@@ -173,6 +173,19 @@ struct JetTaggerHFTask {
   std::vector<std::unique_ptr<TF1>> vecfSignImpXYSigBeautyJetMcCCDB;
   std::vector<std::unique_ptr<TF1>> vecfSignImpXYSigLfJetMcCCDB;
 
+  // cumulative integrals of the resolution functions above, used for the track probabilities
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigData;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigIncJetMC;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigCharmJetMC;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigBeautyJetMC;
+  jettaggingutilities::ResolutionFunctionCdf cdfSignImpXYSigLfJetMC;
+
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> veccdfSignImpXYSigDataJetCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> veccdfSignImpXYSigIncJetMcCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> veccdfSignImpXYSigCharmJetMcCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> veccdfSignImpXYSigBeautyJetMcCCDB;
+  std::vector<jettaggingutilities::ResolutionFunctionCdf> veccdfSignImpXYSigLfJetMcCCDB;
+
   std::vector<uint16_t> decisionNonML;
   std::vector<float> scoreML;
 
@@ -184,35 +197,35 @@ struct JetTaggerHFTask {
     float jetProb = -1.0;
     if (!isMC) {
       if (usepTcategorize) {
-        jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigDataJetCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+        jetProb = jettaggingutilities::getJetProbability(veccdfSignImpXYSigDataJetCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
       } else {
-        jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigData, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+        jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigData, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
       }
     } else {
       if (useResoFuncFromIncJet) {
         if (usepTcategorize) {
-          jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigIncJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+          jetProb = jettaggingutilities::getJetProbability(veccdfSignImpXYSigIncJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
         } else {
-          jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigIncJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+          jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigIncJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
         }
       } else {
         if (origin == JetTaggingSpecies::charm) {
           if (usepTcategorize) {
-            jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigCharmJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(veccdfSignImpXYSigCharmJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           } else {
-            jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigCharmJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigCharmJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           }
         } else if (origin == JetTaggingSpecies::beauty) {
           if (usepTcategorize) {
-            jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigBeautyJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(veccdfSignImpXYSigBeautyJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           } else {
-            jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigBeautyJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigBeautyJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           }
         } else {
           if (usepTcategorize) {
-            jetProb = jettaggingutilities::getJetProbability(vecfSignImpXYSigLfJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(veccdfSignImpXYSigLfJetMcCCDB, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           } else {
-            jetProb = jettaggingutilities::getJetProbability(fSignImpXYSigLfJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
+            jetProb = jettaggingutilities::getJetProbability(cdfSignImpXYSigLfJetMC, jet, tracks, trackDcaXYMax, trackDcaZMax, minSignImpXYSig);
           }
         }
       }
@@ -229,23 +242,23 @@ struct JetTaggerHFTask {
       auto geoSign = jettaggingutilities::getGeoSign(jet, track);
       float probTrack = -1;
       if (!isMC) {
-        probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigData, track, minSignImpXYSig);
+        probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigData, track, minSignImpXYSig);
         if (geoSign > 0)
           registry.fill(HIST("h_pos_track_probability"), probTrack);
         else
           registry.fill(HIST("h_neg_track_probability"), probTrack);
       } else {
         if (useResoFuncFromIncJet) {
-          probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigIncJetMC, track, minSignImpXYSig);
+          probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigIncJetMC, track, minSignImpXYSig);
         } else {
           if (origin == JetTaggingSpecies::charm) {
-            probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigCharmJetMC, track, minSignImpXYSig);
+            probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigCharmJetMC, track, minSignImpXYSig);
           }
           if (origin == JetTaggingSpecies::beauty) {
-            probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigBeautyJetMC, track, minSignImpXYSig);
+            probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigBeautyJetMC, track, minSignImpXYSig);
           }
           if (origin == JetTaggingSpecies::lightflavour) {
-            probTrack = jettaggingutilities::getTrackProbability(fSignImpXYSigLfJetMC, track, minSignImpXYSig);
+            probTrack = jettaggingutilities::getTrackProbability(cdfSignImpXYSigLfJetMC, track, minSignImpXYSig);
           }
         }
         if (geoSign > 0)
@@ -498,6 +511,28 @@ struct JetTaggerHFTask {
       vecfSignImpXYSigLfJetMcCCDB.emplace_back(jettaggingutilities::setResolutionFunction(params));
     }
 
+    // Tabulate the cumulative integrals of the resolution functions
+    auto buildCdf = [&](jettaggingutilities::ResolutionFunctionCdf& cdf, const std::unique_ptr<TF1>& fResoFunc, const std::string& name) {
+      cdf.build(*fResoFunc, minSignImpXYSig);
+      LOG(info) << "tabulated resolution function " << name << ": integral " << cdf.total() << ", max. interpolation error " << cdf.maxError();
+    };
+    auto buildCdfs = [&](std::vector<jettaggingutilities::ResolutionFunctionCdf>& cdfs, const std::vector<std::unique_ptr<TF1>>& fResoFuncs, const std::string& name) {
+      cdfs.resize(fResoFuncs.size());
+      for (size_t i = 0; i < fResoFuncs.size(); i++) {
+        buildCdf(cdfs[i], fResoFuncs[i], name + "_" + std::to_string(i));
+      }
+    };
+    buildCdf(cdfSignImpXYSigData, fSignImpXYSigData, "Data");
+    buildCdf(cdfSignImpXYSigIncJetMC, fSignImpXYSigIncJetMC, "IncJetMC");
+    buildCdf(cdfSignImpXYSigCharmJetMC, fSignImpXYSigCharmJetMC, "CharmJetMC");
+    buildCdf(cdfSignImpXYSigBeautyJetMC, fSignImpXYSigBeautyJetMC, "BeautyJetMC");
+    buildCdf(cdfSignImpXYSigLfJetMC, fSignImpXYSigLfJetMC, "LfJetMC");
+    buildCdfs(veccdfSignImpXYSigDataJetCCDB, vecfSignImpXYSigDataJetCCDB, "DataJetCCDB");
+    buildCdfs(veccdfSignImpXYSigIncJetMcCCDB, vecfSignImpXYSigIncJetMcCCDB, "IncJetMcCCDB");
+    buildCdfs(veccdfSignImpXYSigCharmJetMcCCDB, vecfSignImpXYSigCharmJetMcCCDB, "CharmJetMcCCDB");
+    buildCdfs(veccdfSignImpXYSigBeautyJetMcCCDB, vecfSignImpXYSigBeautyJetMcCCDB, "BeautyJetMcCCDB");
+    buildCdfs(veccdfSignImpXYSigLfJetMcCCDB, vecfSignImpXYSigLfJetMcCCDB, "LfJetMcCCDB");
+
     // Use QA for effectivness of track probability
     if (trackProbQA) {
       AxisSpec trackProbabilityAxis = {binTrackProbability, "Track proability"};
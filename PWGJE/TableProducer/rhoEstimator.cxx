@@ -80,6 +80,8 @@ struct RhoEstimatorTask {
     Configurable<int> jetRecombScheme{"jetRecombScheme", 0, "jet recombination scheme. 0 = E-scheme, 1 = pT-scheme, 2 = pT2-scheme"};
     Configurable<float> bkgjetR{"bkgjetR", 0.2, "jet resolution parameter for determining background density"};
     Configurable<bool> doSparse{"doSparse", false, "perfom sparse estimation"};
+    Configurable<bool> doGridMedian{"doGridMedian", false, "estimate the background from the median of eta-phi tiles instead of kT jets (fast mode, no sparse correction)"};
+    Configurable<float> gridSpacing{"gridSpacing", 0.55, "size of the eta-phi tiles used for the grid-median estimation"};
     Configurable<double> ghostRapMax{"ghostRapMax", 0.9, "Ghost rapidity max"};
     Configurable<int> ghostRepeat{"ghostRepeat", 1, "Ghost tiling repeats"};
     Configurable<double> ghostArea{"ghostArea", 0.005, "Area per ghost"};
@@ -105,6 +107,7 @@ struct RhoEstimatorTask {
   } config;
 
   JetBkgSubUtils bkgSub;
+  BkgSubEstimator bkgEstimator = BkgSubEstimator::medianRho;
   float bkgPhiMax_;
   float bkgPhiMin_;
   std::vector<fastjet::PseudoJet> inputParticles;
@@ -137,6 +140,12 @@ struct RhoEstimatorTask {
     fastjet::GhostedAreaSpec ghostAreaSpec(config.ghostRapMax, config.ghostRepeat, config.ghostArea,
                                            config.ghostGridScatter, config.ghostKtScatter, config.ghostMeanPt);
     bkgSub.setGhostAreaSpec(ghostAreaSpec);
+    bkgSub.setGridSpacing(config.gridSpacing);
+    if (config.doGridMedian) {
+      bkgEstimator = BkgSubEstimator::gridMedianRho;
+    } else if (config.doSparse) {
+      bkgEstimator = BkgSubEstimator::medianRhoSparse;
+    }
 
     eventSelectionBits = jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(config.eventSelections));
     triggerMaskBits = jetderiveddatautilities::initialiseTriggerMaskBits(config.triggerMasks);
@@ -212,7 +221,7 @@ struct RhoEstimatorTask {
     }
     inputParticles.clear();
     jetfindingutilities::analyseTracks<soa::Filtered<aod::JetTracks>, soa::Filtered<aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection);
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
     rhoChargedTable(rho, rhoM);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processChargedCollisions, "Fill rho tables for collisions using charged tracks", true);
@@ -225,7 +234,7 @@ struct RhoEstimatorTask {
     }
     inputParticles.clear();
     jetfindingutilities::analyseParticles<false, soa::Filtered<aod::JetParticles>, soa::Filtered<aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
-    auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+    auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
     rhoChargedMcTable(rho, rhoM);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processChargedMcCollisions, "Fill rho tables for MC collisions using charged tracks", false);
@@ -240,7 +249,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoD0Table(rho, rhoM);
     }
   }
@@ -256,7 +265,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoD0McTable(rho, rhoM);
     }
   }
@@ -272,7 +281,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDplusTable(rho, rhoM);
     }
   }
@@ -289,7 +298,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDplusMcTable(rho, rhoM);
     }
   }
@@ -305,7 +314,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDsTable(rho, rhoM);
     }
   }
@@ -321,7 +330,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDsMcTable(rho, rhoM);
     }
   }
@@ -337,7 +346,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDstarTable(rho, rhoM);
     }
   }
@@ -353,7 +362,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDstarMcTable(rho, rhoM);
     }
   }
@@ -369,7 +378,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoLcTable(rho, rhoM);
     }
   }
@@ -385,7 +394,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoLcMcTable(rho, rhoM);
     }
   }
@@ -401,7 +410,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoB0Table(rho, rhoM);
     }
   }
@@ -417,7 +426,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoB0McTable(rho, rhoM);
     }
   }
@@ -433,7 +442,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoBplusTable(rho, rhoM);
     }
   }
@@ -449,7 +458,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoBplusMcTable(rho, rhoM);
     }
   }
@@ -465,7 +474,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoXicToXiPiPiTable(rho, rhoM);
     }
   }
@@ -481,7 +490,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoXicToXiPiPiMcTable(rho, rhoM);
     }
   }
@@ -497,7 +506,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDielectronTable(rho, rhoM);
     }
   }
@@ -513,7 +522,7 @@ struct RhoEstimatorTask {
       inputParticles.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate);
 
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, config.doSparse);
+      auto [rho, rhoM] = bkgSub.estimateRho(inputParticles, bkgEstimator);
       rhoDielectronMcTable(rho, rhoM);
     }
   }
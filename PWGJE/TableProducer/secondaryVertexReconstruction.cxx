@@ -42,8 +42,12 @@
 #include <ReconstructionDataFormats/TrackParametrizationWithError.h>
 #include <ReconstructionDataFormats/Vertex.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <numeric>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -91,6 +95,9 @@ struct SecondaryVertexReconstruction {
   Configurable<float> maxIPxy{"maxIPxy", 10, "maximum track DCA in xy plane"};
   Configurable<float> maxIPz{"maxIPz", 10, "maximum track DCA in z direction"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<bool> prunePairs{"prunePairs", false, "build N-prong (N > 2) candidates only from constituents forming a 2-prong vertex pairwise"};
+  Configurable<float> maxPairDCA{"maxPairDCA", -1., "if prunePairs, max. distance of closest approach between two prongs (cm), not applied if <= 0"};
+  Configurable<int> maxProngCandidates{"maxProngCandidates", -1, "N-prong (N > 2) reconstruction only: max. number of constituents with the largest DCAxy significance combined per jet, all if <= 0"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> ccdbPathLut{"ccdbPathLut", "GLO/Param/MatLUT", "Path for LUT parametrization"};
@@ -152,203 +159,302 @@ struct SecondaryVertexReconstruction {
   using JetTracksMCDwPIs = soa::Filtered<soa::Join<aod::JetTracksMCD, aod::JTrackPIs>>;
   using OriginalTracks = soa::Join<aod::Tracks, aod::TracksCov, aod::TrackSelection, aod::TracksDCA, aod::TracksDCACov>;
 
+  // jet constituent passing the track selection, with its track parametrisation built once per jet
+  struct ProngCandidate {
+    o2::track::TrackParametrizationWithError<float> trackParCov;
+    double energy;
+    float pt;
+    float impactParameterSignificanceXY;
+  };
+  std::vector<ProngCandidate> prongCandidates;
+  std::vector<int8_t> pairCompatibility; // per pair of prong candidates: -1 not tested yet, 0 incompatible, 1 compatible
+  std::vector<size_t> candidateOrder;
+
   template <unsigned int numProngs, bool externalMagneticField, typename AnyCollision, typename AnyJet, typename AnyParticles>
   void runCreatorNProng(AnyCollision const& collision,
                         AnyJet const& analysisJet,
-                        AnyParticles const& listoftracks,
+                        AnyParticles const& /*listoftracks*/,
                         std::vector<int>& svIndices,
-                        o2::vertexing::DCAFitterN<numProngs>& df,
-                        size_t prongIndex = 0,
-                        std::vector<size_t> currentCombination = {})
+                        o2::vertexing::DCAFitterN<numProngs>& df)
   {
-
-    const auto& particles = analysisJet.template tracks_as<AnyParticles>();
-
-    if (currentCombination.size() == numProngs) {
-      // Create an array of track parameters and covariance matrices for the current combination
-      std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
-      double energySV = 0.;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-        energySV += prong.energy(o2::constants::physics::MassPiPlus);
-        trackParVars[inum] = getTrackParCov(prong);
+    // Select the constituents and build their track parametrisations once per jet
+    prongCandidates.clear();
+    for (const auto& particle : analysisJet.template tracks_as<AnyParticles>()) {
+      const auto& track = particle.template track_as<OriginalTracks>();
+      if (track.pt() < ptMinTrack || track.eta() < etaMinTrack || track.eta() > etaMaxTrack || std::abs(track.dcaXY()) > maxIPxy || std::abs(track.dcaZ()) > maxIPz) {
+        continue;
       }
+      const float sigmaDcaXY = std::sqrt(track.sigmaDcaXY2());
+      prongCandidates.push_back({getTrackParCov(track), track.energy(o2::constants::physics::MassPiPlus), track.pt(), sigmaDcaXY > 0.f ? std::abs(track.dcaXY()) / sigmaDcaXY : 0.f});
+    }
 
-      if constexpr (externalMagneticField) {
-        bz = magneticField;
-      } else {
-        auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
-        if (runNumber != bc.runNumber()) {
-          initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
-          bz = o2::base::Propagator::Instance()->getNominalBz();
+    // Keep only the constituents with the largest DCAxy significance, in their original order,
+    // to bound the combinatorics of N-prong candidates, the pairs of 2-prong candidates are all kept
+    if constexpr (numProngs > TwoProngCount) {
+      if (maxProngCandidates > 0 && prongCandidates.size() > static_cast<size_t>(maxProngCandidates)) {
+        candidateOrder.resize(prongCandidates.size());
+        std::iota(candidateOrder.begin(), candidateOrder.end(), 0);
+        std::stable_sort(candidateOrder.begin(), candidateOrder.end(), [this](size_t a, size_t b) {
+          return prongCandidates[a].impactParameterSignificanceXY > prongCandidates[b].impactParameterSignificanceXY;
+        });
+        candidateOrder.resize(maxProngCandidates);
+        std::sort(candidateOrder.begin(), candidateOrder.end());
+        for (size_t i = 0; i < candidateOrder.size(); i++) {
+          prongCandidates[i] = prongCandidates[candidateOrder[i]];
         }
+        prongCandidates.resize(candidateOrder.size());
       }
+    }
 
-      // Use a different fitter depending on the number of prongs
-      df.setBz(bz);
+    if (prongCandidates.size() < numProngs) {
+      return;
+    }
 
-      // Reconstruct the secondary vertex
-      int processResult = 0;
-      try {
-        std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        return;
-      }
-      if (processResult == 0) {
-        return;
+    if constexpr (externalMagneticField) {
+      bz = magneticField;
+    } else {
+      auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
+      if (runNumber != bc.runNumber()) {
+        initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
+        bz = o2::base::Propagator::Instance()->getNominalBz();
       }
+    }
 
-      const auto& secondaryVertex = df.getPCACandidatePos();
-      if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
-        return;
+    // Use a different fitter depending on the number of prongs
+    df.setBz(bz);
+    if constexpr (numProngs > TwoProngCount) {
+      if (prunePairs) {
+        df2.setBz(bz);
+        pairCompatibility.assign(prongCandidates.size() * prongCandidates.size(), -1);
       }
+    }
 
-      float dispersion = 0.;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
-        o2::dataformats::DCA dcaSV;
-        auto& prong = df.getTrack(inum);
-        prong.propagateToDCA(sv, bz, &dcaSV);
-        dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
-      }
-      dispersion = std::sqrt(dispersion / numProngs);
-
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
-
-      // get track impact parameters
-      // This modifies track momenta!
-      auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
-
-      // Get track momenta and impact parameters
-      std::array<std::array<float, 3>, numProngs> arrayMomenta{};
-      std::array<o2::dataformats::DCA, numProngs> impactParameters;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
-        trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
-
-        if (fillHistograms) {
-          const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-          registry.fill(HIST("hDcaXYNProngs"), prong.pt(), impactParameters[inum].getY() * toMicrometers, numProngs);
-          registry.fill(HIST("hDcaZNProngs"), prong.pt(), impactParameters[inum].getZ() * toMicrometers, numProngs);
+    std::array<size_t, numProngs> combination{};
+    addProngs<numProngs>(collision, analysisJet, svIndices, df, combination, 0, 0);
+  }
+
+  // Explore all combinations of prong candidates, in increasing index order
+  template <unsigned int numProngs, typename AnyCollision, typename AnyJet>
+  void addProngs(AnyCollision const& collision,
+                 AnyJet const& analysisJet,
+                 std::vector<int>& svIndices,
+                 o2::vertexing::DCAFitterN<numProngs>& df,
+                 std::array<size_t, numProngs>& combination,
+                 unsigned int nProngsAdded,
+                 size_t firstCandidate)
+  {
+    if (nProngsAdded == numProngs) {
+      fillSecondaryVertex<numProngs>(collision, analysisJet, svIndices, df, combination);
+      return;
+    }
+    for (size_t iCandidate = firstCandidate; iCandidate + (numProngs - nProngsAdded) <= prongCandidates.size(); ++iCandidate) {
+      if constexpr (numProngs > TwoProngCount) {
+        if (prunePairs && !isCompatibleWithProngs(combination, nProngsAdded, iCandidate)) {
+          continue;
         }
       }
+      combination[nProngsAdded] = iCandidate;
+      addProngs<numProngs>(collision, analysisJet, svIndices, df, combination, nProngsAdded + 1, iCandidate + 1);
+    }
+  }
 
-      // get uncertainty of the decay length
-      double phi, theta;
-      getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-
-      // calculate invariant mass
-      std::array<double, numProngs> massArray{};
-      std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
-      double massSV = RecoDecay::m(arrayMomenta, massArray);
-
-      // calculate momentum
-      double xMomenta = -1;
-      double yMomenta = -1;
-      double zMomenta = -1;
-      if (numProngs == ThreeProngCount) {
-        xMomenta = arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0];
-        yMomenta = arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1];
-        zMomenta = arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2];
-      } else if (numProngs == TwoProngCount) {
-        xMomenta = arrayMomenta[0][0] + arrayMomenta[1][0];
-        yMomenta = arrayMomenta[0][1] + arrayMomenta[1][1];
-        zMomenta = arrayMomenta[0][2] + arrayMomenta[1][2];
-      } else {
-        LOG(error) << "No process momenta\n";
+  // Whether a prong candidate forms a 2-prong vertex with each of the prongs already added
+  template <size_t N>
+  bool isCompatibleWithProngs(std::array<size_t, N> const& combination, unsigned int nProngsAdded, size_t iCandidate)
+  {
+    for (unsigned int inum = 0; inum < nProngsAdded; ++inum) {
+      int8_t& compatible = pairCompatibility[combination[inum] * prongCandidates.size() + iCandidate];
+      if (compatible < 0) {
+        compatible = isCompatiblePair(prongCandidates[combination[inum]].trackParCov, prongCandidates[iCandidate].trackParCov);
       }
-
-      // fill candidate table rows
-      if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == ThreeProngCount) {
-        sv3prongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          xMomenta,
-                          yMomenta,
-                          zMomenta,
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv3prongTableData.lastIndex());
-      } else if ((doprocessData2Prongs || doprocessData2ProngsExternalMagneticField) && numProngs == TwoProngCount) {
-        sv2prongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          xMomenta,
-                          yMomenta,
-                          zMomenta,
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv2prongTableData.lastIndex());
-      } else if ((doprocessDataNProngs || doprocessDataNProngsExternalMagneticField)) {
-        svnprongTableData(analysisJet.globalIndex(),
-                          primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                          secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                          xMomenta,
-                          yMomenta,
-                          zMomenta,
-                          energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(svnprongTableData.lastIndex());
-      } else if ((doprocessMCD3Prongs || doprocessMCD3ProngsExternalMagneticField) && numProngs == ThreeProngCount) {
-        sv3prongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         xMomenta,
-                         yMomenta,
-                         zMomenta,
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv3prongTableMCD.lastIndex());
-      } else if ((doprocessMCD2Prongs || doprocessMCD2ProngsExternalMagneticField) && numProngs == TwoProngCount) {
-        sv2prongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         xMomenta,
-                         yMomenta,
-                         zMomenta,
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(sv2prongTableMCD.lastIndex());
-      } else if (doprocessMCDNProngs || doprocessMCDNProngsExternalMagneticField) {
-        svnprongTableMCD(analysisJet.globalIndex(),
-                         primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
-                         secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
-                         xMomenta,
-                         yMomenta,
-                         zMomenta,
-                         energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
-        svIndices.push_back(svnprongTableMCD.lastIndex());
-      } else {
-        LOG(error) << "No process specified\n";
+      if (!compatible) {
+        return false;
       }
+    }
+    return true;
+  }
 
-      // fill histograms
-      if (fillHistograms) {
-        double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
-        double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
-
-        registry.fill(HIST("hDispersion"), dispersion, numProngs);
-        registry.fill(HIST("hMassNProngs"), massSV, numProngs);
-        registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
-        registry.fill(HIST("hLSNProngs"), decayLengthNormalised, numProngs);
-        registry.fill(HIST("hFeNProngs"), energySV / analysisJet.energy() > 1. ? 0.99 : energySV / analysisJet.energy(), numProngs);
+  bool isCompatiblePair(o2::track::TrackParametrizationWithError<float> const& track0, o2::track::TrackParametrizationWithError<float> const& track1)
+  {
+    try {
+      if (df2.process(track0, track1) == 0) {
+        return false;
+      }
+    } catch (const std::runtime_error&) {
+      return false;
+    }
+    if (maxPairDCA > 0.) {
+      std::array<float, 3> position0{};
+      std::array<float, 3> position1{};
+      df2.getTrack(0).getXYZGlo(position0);
+      df2.getTrack(1).getXYZGlo(position1);
+      if (RecoDecay::distance(position0, position1) > maxPairDCA) {
+        return false;
       }
+    }
+    return true;
+  }
+
+  template <unsigned int numProngs, typename AnyCollision, typename AnyJet>
+  void fillSecondaryVertex(AnyCollision const& collision,
+                           AnyJet const& analysisJet,
+                           std::vector<int>& svIndices,
+                           o2::vertexing::DCAFitterN<numProngs>& df,
+                           std::array<size_t, numProngs> const& combination)
+  {
+    // Create an array of track parameters and covariance matrices for the current combination
+    std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
+    double energySV = 0.;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      energySV += prongCandidates[combination[inum]].energy;
+      trackParVars[inum] = prongCandidates[combination[inum]].trackParCov;
+    }
+
+    // Reconstruct the secondary vertex
+    int processResult = 0;
+    try {
+      std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
+    } catch (const std::runtime_error& error) {
+      LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+      return;
+    }
+    if (processResult == 0) {
+      return;
+    }
 
+    const auto& secondaryVertex = df.getPCACandidatePos();
+    if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
       return;
     }
 
-    // Recursive call to explore all combinations
-    for (size_t iprong = prongIndex; iprong < particles.size(); ++iprong) {
+    float dispersion = 0.;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
+      o2::dataformats::DCA dcaSV;
+      auto& prong = df.getTrack(inum);
+      prong.propagateToDCA(sv, bz, &dcaSV);
+      dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
+    }
+    dispersion = std::sqrt(dispersion / numProngs);
+
+    auto chi2PCA = df.getChi2AtPCACandidate();
+    auto covMatrixPCA = df.calcPCACovMatrixFlat();
 
-      const auto& testTrack = particles[iprong].template track_as<OriginalTracks>();
-      if (testTrack.pt() < ptMinTrack || testTrack.eta() < etaMinTrack || testTrack.eta() > etaMaxTrack || std::abs(testTrack.dcaXY()) > maxIPxy || std::abs(testTrack.dcaZ()) > maxIPz) {
-        continue;
+    // get track impact parameters
+    // This modifies track momenta!
+    auto primaryVertex = getPrimaryVertex(collision);
+    auto covMatrixPV = primaryVertex.getCov();
+
+    // Get track momenta and impact parameters
+    std::array<std::array<float, 3>, numProngs> arrayMomenta{};
+    std::array<o2::dataformats::DCA, numProngs> impactParameters;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
+      trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
+
+      if (fillHistograms) {
+        const float prongPt = prongCandidates[combination[inum]].pt;
+        registry.fill(HIST("hDcaXYNProngs"), prongPt, impactParameters[inum].getY() * toMicrometers, numProngs);
+        registry.fill(HIST("hDcaZNProngs"), prongPt, impactParameters[inum].getZ() * toMicrometers, numProngs);
       }
+    }
+
+    // get uncertainty of the decay length
+    double phi, theta;
+    getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
+    auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+    auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+    // calculate invariant mass
+    std::array<double, numProngs> massArray{};
+    std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
+    double massSV = RecoDecay::m(arrayMomenta, massArray);
+
+    // calculate momentum
+    double xMomenta = -1;
+    double yMomenta = -1;
+    double zMomenta = -1;
+    if (numProngs == ThreeProngCount) {
+      xMomenta = arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0];
+      yMomenta = arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1];
+      zMomenta = arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2];
+    } else if (numProngs == TwoProngCount) {
+      xMomenta = arrayMomenta[0][0] + arrayMomenta[1][0];
+      yMomenta = arrayMomenta[0][1] + arrayMomenta[1][1];
+      zMomenta = arrayMomenta[0][2] + arrayMomenta[1][2];
+    } else {
+      LOG(error) << "No process momenta\n";
+    }
 
-      currentCombination.push_back(iprong);
-      runCreatorNProng<numProngs, externalMagneticField>(
-        collision, analysisJet, listoftracks, svIndices, df, iprong + 1, currentCombination);
-      currentCombination.pop_back();
+    // fill candidate table rows
+    if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == ThreeProngCount) {
+      sv3prongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        xMomenta,
+                        yMomenta,
+                        zMomenta,
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv3prongTableData.lastIndex());
+    } else if ((doprocessData2Prongs || doprocessData2ProngsExternalMagneticField) && numProngs == TwoProngCount) {
+      sv2prongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        xMomenta,
+                        yMomenta,
+                        zMomenta,
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv2prongTableData.lastIndex());
+    } else if ((doprocessDataNProngs || doprocessDataNProngsExternalMagneticField)) {
+      svnprongTableData(analysisJet.globalIndex(),
+                        primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                        secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                        xMomenta,
+                        yMomenta,
+                        zMomenta,
+                        energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(svnprongTableData.lastIndex());
+    } else if ((doprocessMCD3Prongs || doprocessMCD3ProngsExternalMagneticField) && numProngs == ThreeProngCount) {
+      sv3prongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       xMomenta,
+                       yMomenta,
+                       zMomenta,
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv3prongTableMCD.lastIndex());
+    } else if ((doprocessMCD2Prongs || doprocessMCD2ProngsExternalMagneticField) && numProngs == TwoProngCount) {
+      sv2prongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       xMomenta,
+                       yMomenta,
+                       zMomenta,
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(sv2prongTableMCD.lastIndex());
+    } else if (doprocessMCDNProngs || doprocessMCDNProngsExternalMagneticField) {
+      svnprongTableMCD(analysisJet.globalIndex(),
+                       primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ(),
+                       secondaryVertex[0], secondaryVertex[1], secondaryVertex[2],
+                       xMomenta,
+                       yMomenta,
+                       zMomenta,
+                       energySV, massSV, chi2PCA, dispersion, errorDecayLength, errorDecayLengthXY);
+      svIndices.push_back(svnprongTableMCD.lastIndex());
+    } else {
+      LOG(error) << "No process specified\n";
+    }
+
+    // fill histograms
+    if (fillHistograms) {
+      double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
+      double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
+
+      registry.fill(HIST("hDispersion"), dispersion, numProngs);
+      registry.fill(HIST("hMassNProngs"), massSV, numProngs);
+      registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
+      registry.fill(HIST("hLSNProngs"), decayLengthNormalised, numProngs);
+      registry.fill(HIST("hFeNProngs"), energySV / analysisJet.energy() > 1. ? 0.99 : energySV / analysisJet.energy(), numProngs);
     }
   }
 
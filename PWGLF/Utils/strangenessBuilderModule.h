@@ -47,12 +47,17 @@
 #include <TPDGCode.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <numeric>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // simple checkers, but ensure 8 bit integers
@@ -334,6 +339,11 @@ struct coreConfigurables : o2::framework::ConfigurableGroup {
 
   // test the possibility of refitting with material corrections (DCA Fitter option)
   o2::framework::Configurable<bool> refitWithMaterialCorrection{"refitWithMaterialCorrection", false, "do refit after material corrections were applied"};
+
+  // multi-threaded fitting: candidates are fitted in chunks by worker threads
+  // owning a copy of the builder helper; tables are then filled in list order
+  o2::framework::Configurable<int> nThreads{"nThreads", 1, "number of worker threads for V0/cascade fitting. 1 (default): serial building"};
+  o2::framework::Configurable<int> nCandidatesPerChunk{"nCandidatesPerChunk", 256, "number of candidates handed to a worker thread at a time"};
 };
 
 // strangenessBuilder: V0 building options
@@ -508,6 +518,14 @@ class BuilderModule
   // helper object
   o2::pwglf::strangenessBuilderHelper straHelper;
 
+  // multi-threaded building: one helper copy per worker, fitted candidates
+  // stored in slots parallel to the sorted build lists
+  std::vector<o2::pwglf::strangenessBuilderHelper> workerHelpers;
+  std::vector<o2::pwglf::v0candidate> v0Prefits;
+  std::vector<o2::pwglf::cascadeCandidate> cascadePrefits;
+  std::vector<int8_t> v0PrefitStatus;      // -1: not prefitted (build serially), 0: build failed, 1: built
+  std::vector<int8_t> cascadePrefitStatus; // -1: not prefitted (build serially), 0: build failed, 1: built
+
   // for handling TPC-only tracks (photons)
   int mRunNumber;
   o2::aod::common::TPCVDriftManager mVDriftMgr;
@@ -610,6 +628,14 @@ class BuilderModule
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
+  // hash indices for findable mode, rebuilt once per DF in prepareBuildingLists
+  // key: (posTrackId, negTrackId) packed into 64 bits, see trackPairKey
+  std::unordered_map<uint64_t, int> v0ListIndex;                   // (p,n) -> first entry in reconstructed v0List
+  std::unordered_map<uint64_t, int> ao2dV0Index;                   // (p,n) -> first V0 in AO2D table
+  std::unordered_map<uint64_t, int> sortedV0ListIndex;             // (p,n) -> first position in sorted_v0
+  std::unordered_map<uint64_t, std::vector<int>> cascadeListIndex; // (p,n) -> bachelor ids of reconstructed cascades
+  std::unordered_map<uint64_t, std::vector<int>> ao2dCascadeIndex; // (p,n) -> AO2D cascade ids
+
   // declaration of structs here
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::pwglf::strangenessbuilder::coreConfigurables baseOpts;
@@ -830,6 +856,12 @@ class BuilderModule
     }
   }
 
+  // packs a (positive, negative) track index pair into a single hash key
+  static uint64_t trackPairKey(int posTrackId, int negTrackId)
+  {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(posTrackId)) << 32) | static_cast<uint64_t>(static_cast<uint32_t>(negTrackId));
+  }
+
   // for sorting
   template <typename T>
   std::vector<std::size_t> sort_indices(const std::vector<T>& v, bool doSorting = false)
@@ -944,6 +976,11 @@ class BuilderModule
     sorted_v0.clear();
     sorted_cascade.clear();
     ao2dV0toV0List.clear();
+    v0ListIndex.clear();
+    ao2dV0Index.clear();
+    sortedV0ListIndex.clear();
+    cascadeListIndex.clear();
+    ao2dCascadeIndex.clear();
 
     trackEntry currentTrackEntry;
     v0Entry currentV0Entry;
@@ -1094,12 +1131,26 @@ class BuilderModule
     // any mode other than 0 will require mcParticles
     if constexpr (soa::is_table<TMCCollisions>) {
       if (baseOpts.mc_findableMode.value > 0) {
-        // for search if existing or not
+        // for search if existing or not: index (p,n) -> v0List entry once,
+        // keeping the first occurrence as the former linear search did
         int v0ListReconstructedSize = v0List.size();
+        if (baseOpts.mc_findableMode.value == 1) {
+          v0ListIndex.reserve(v0ListReconstructedSize);
+          for (int ii = 0; ii < v0ListReconstructedSize; ii++) {
+            v0ListIndex.emplace(trackPairKey(v0List[ii].posTrackId, v0List[ii].negTrackId), ii);
+          }
+        }
+        if (baseOpts.mc_findableMode.value == 2) {
+          ao2dV0Index.reserve(v0s.size());
+          for (const auto& v0 : v0s) {
+            ao2dV0Index.emplace(trackPairKey(v0.posTrackId(), v0.negTrackId()), v0.globalIndex());
+          }
+        }
 
         // find extra candidates, step 1: find subset of tracks that interest
         std::vector<trackEntry> positiveTrackArray;
         std::vector<trackEntry> negativeTrackArray;
+        std::unordered_map<int, std::vector<int>> negativeTracksPerOrigin; // originId -> negativeTrackArray entries
         // vector elements: track index, origin index [, mc collision id, pdg code]
         int dummy = -1; // unnecessary in this path
         for (const auto& track : tracks) {
@@ -1132,30 +1183,30 @@ class BuilderModule
 
           // now separate according to particle species
           if (track.sign() < 0) {
+            negativeTracksPerOrigin[originParticleIndex].push_back(negativeTrackArray.size());
             negativeTrackArray.push_back(currentTrackEntry);
           } else {
             positiveTrackArray.push_back(currentTrackEntry);
           }
         }
 
-        // Nested loop only with valuable tracks
+        // Pair only valuable tracks sharing the same originating particle
         for (const auto& positiveTrackIndex : positiveTrackArray) {
-          for (const auto& negativeTrackIndex : negativeTrackArray) {
-            if (positiveTrackIndex.originId != negativeTrackIndex.originId) {
-              continue; // not the same originating particle
-            }
+          auto negativeCandidates = negativeTracksPerOrigin.find(positiveTrackIndex.originId);
+          if (negativeCandidates == negativeTracksPerOrigin.end()) {
+            continue; // no negative track from the same originating particle
+          }
+          for (const auto& iNegative : negativeCandidates->second) {
+            const auto& negativeTrackIndex = negativeTrackArray[iNegative];
             // findable mode 1: add non-reconstructed as v0Type 8
             if (baseOpts.mc_findableMode.value == 1) {
               bool detected = false;
-              for (int ii = 0; ii < v0ListReconstructedSize; ii++) {
-                // check if this particular combination already exists in v0List
-                if (v0List[ii].posTrackId == positiveTrackIndex.globalId &&
-                    v0List[ii].negTrackId == negativeTrackIndex.globalId) {
-                  detected = true;
-                  // override pdg code with something useful for cascade findable math
-                  v0List[ii].pdgCode = positiveTrackIndex.pdgCode;
-                  break;
-                }
+              // check if this particular combination already exists in v0List
+              auto existingV0 = v0ListIndex.find(trackPairKey(positiveTrackIndex.globalId, negativeTrackIndex.globalId));
+              if (existingV0 != v0ListIndex.end()) {
+                detected = true;
+                // override pdg code with something useful for cascade findable math
+                v0List[existingV0->second].pdgCode = positiveTrackIndex.pdgCode;
               }
               if (detected == false) {
                 // collision index: from best-version-of-this-mcCollision
@@ -1194,17 +1245,15 @@ class BuilderModule
                 currentV0Entry.isCollinearV0 = true;
               }
               currentV0Entry.found = false;
-              for (const auto& v0 : v0s) {
-                if (v0.posTrackId() == positiveTrackIndex.globalId &&
-                    v0.negTrackId() == negativeTrackIndex.globalId) {
-                  // this will override type, but not collision index
-                  // N.B.: collision index checks still desirable!
-                  currentV0Entry.globalId = v0.globalIndex();
-                  currentV0Entry.v0Type = v0.v0Type();
-                  currentV0Entry.isCollinearV0 = v0.isCollinearV0();
-                  currentV0Entry.found = true;
-                  break;
-                }
+              auto existingV0 = ao2dV0Index.find(trackPairKey(positiveTrackIndex.globalId, negativeTrackIndex.globalId));
+              if (existingV0 != ao2dV0Index.end()) {
+                // this will override type, but not collision index
+                // N.B.: collision index checks still desirable!
+                auto v0 = v0s.rawIteratorAt(existingV0->second);
+                currentV0Entry.globalId = v0.globalIndex();
+                currentV0Entry.v0Type = v0.v0Type();
+                currentV0Entry.isCollinearV0 = v0.isCollinearV0();
+                currentV0Entry.found = true;
               }
               if (v0BuilderOpts.mc_findableDetachedV0.value || currentV0Entry.collisionId >= 0) {
                 v0List.push_back(currentV0Entry);
@@ -1246,11 +1295,26 @@ class BuilderModule
       // any mode other than 0 will require mcParticles
       if constexpr (soa::is_table<TMCCollisions>) {
         if (baseOpts.mc_findableMode.value > 0) {
-          // for search if existing or not
+          // for search if existing or not: index (p,n) -> bachelors once
+          // caution: use track indices (immutable) but not V0 indices (re-indexing)
           size_t cascadeListReconstructedSize = cascadeList.size();
+          if (baseOpts.mc_findableMode.value == 1) {
+            cascadeListIndex.reserve(cascadeListReconstructedSize);
+            for (size_t ii = 0; ii < cascadeListReconstructedSize; ii++) {
+              cascadeListIndex[trackPairKey(cascadeList[ii].posTrackId, cascadeList[ii].negTrackId)].push_back(cascadeList[ii].bachTrackId);
+            }
+          }
+          if (baseOpts.mc_findableMode.value == 2) {
+            ao2dCascadeIndex.reserve(cascades.size());
+            for (const auto& cascade : cascades) {
+              auto const& v0fromAOD = cascade.v0();
+              ao2dCascadeIndex[trackPairKey(v0fromAOD.posTrackId(), v0fromAOD.negTrackId())].push_back(cascade.globalIndex());
+            }
+          }
 
           // determine which tracks are of interest
           std::vector<trackEntry> bachelorTrackArray;
+          std::unordered_map<int, std::vector<int>> bachelorTracksPerOrigin; // originId -> bachelorTrackArray entries
           // vector elements: track index, origin index, mc collision id, pdg code]
           int dummy = -1; // unnecessary in this path
           for (const auto& track : tracks) {
@@ -1282,6 +1346,7 @@ class BuilderModule
             currentTrackEntry.pdgCode = originParticle.pdgCode();
 
             // populate list of bachelor tracks to pair
+            bachelorTracksPerOrigin[originParticleIndex].push_back(bachelorTrackArray.size());
             bachelorTrackArray.push_back(currentTrackEntry);
           }
 
@@ -1314,23 +1379,21 @@ class BuilderModule
             if (std::abs(v0OriginParticle.pdgCode()) != PDG_t::kXiMinus && std::abs(v0OriginParticle.pdgCode()) != PDG_t::kOmegaMinus) {
               continue; // this V0 does not come from any particle of interest, don't try
             }
-            for (const auto& bachelorTrackIndex : bachelorTrackArray) {
-              if (bachelorTrackIndex.originId != v0OriginParticle.globalIndex()) {
-                continue;
-              }
+            auto bachelorCandidates = bachelorTracksPerOrigin.find(v0OriginParticle.globalIndex());
+            if (bachelorCandidates == bachelorTracksPerOrigin.end()) {
+              continue; // no bachelor from the same originating particle
+            }
+            const uint64_t v0Key = trackPairKey(v0.posTrackId, v0.negTrackId);
+            for (const auto& iBachelor : bachelorCandidates->second) {
+              const auto& bachelorTrackIndex = bachelorTrackArray[iBachelor];
               // if we are here: v0 origin is 3312 or 3334, bachelor origin matches V0 origin
               // findable mode 1: add non-reconstructed as cascadeType 1
               if (baseOpts.mc_findableMode.value == 1) {
                 bool detected = false;
-                for (size_t ii = 0; ii < cascadeListReconstructedSize; ii++) {
-                  // check if this particular combination already exists in cascadeList
-                  // caution: use track indices (immutable) but not V0 indices (re-indexing)
-                  if (cascadeList[ii].posTrackId == v0.posTrackId &&
-                      cascadeList[ii].negTrackId == v0.negTrackId &&
-                      cascadeList[ii].bachTrackId == bachelorTrackIndex.globalId) {
-                    detected = true;
-                    break;
-                  }
+                // check if this particular combination already exists in cascadeList
+                auto existingCascades = cascadeListIndex.find(v0Key);
+                if (existingCascades != cascadeListIndex.end()) {
+                  detected = std::find(existingCascades->second.begin(), existingCascades->second.end(), bachelorTrackIndex.globalId) != existingCascades->second.end();
                 }
                 if (detected == false) {
                   // collision index: from best-version-of-this-mcCollision
@@ -1365,16 +1428,16 @@ class BuilderModule
                 if (bestCollisionArray[bachelorTrackIndex.mcCollisionId] < 0) {
                   collisionLessCascades++;
                 }
-                for (const auto& cascade : cascades) {
-                  auto const& v0fromAOD = cascade.v0();
-                  if (v0fromAOD.posTrackId() == v0.posTrackId &&
-                      v0fromAOD.negTrackId() == v0.negTrackId &&
-                      cascade.bachelorId() == bachelorTrackIndex.globalId) {
-                    // this will override type, but not collision index
-                    // N.B.: collision index checks still desirable!
-                    currentCascadeEntry.found = true;
-                    currentCascadeEntry.globalId = cascade.globalIndex();
-                    break;
+                auto existingCascades = ao2dCascadeIndex.find(v0Key);
+                if (existingCascades != ao2dCascadeIndex.end()) {
+                  for (const auto& cascadeId : existingCascades->second) {
+                    if (cascades.rawIteratorAt(cascadeId).bachelorId() == bachelorTrackIndex.globalId) {
+                      // this will override type, but not collision index
+                      // N.B.: collision index checks still desirable!
+                      currentCascadeEntry.found = true;
+                      currentCascadeEntry.globalId = cascadeId;
+                      break;
+                    }
                   }
                 }
                 if (cascadeBuilderOpts.mc_findableDetachedCascade.value || currentCascadeEntry.collisionId >= 0) {
@@ -1388,15 +1451,16 @@ class BuilderModule
           // correct. We'll have to loop over all V0s and find the appropriate matches
           // ---> but only in mode 1, and only for AO2D-native V0s
           if (baseOpts.mc_findableMode.value == 1) {
+            // index v0List in sorted order, first occurrence wins as in a sorted scan
+            sortedV0ListIndex.reserve(v0List.size());
+            for (size_t v0i = 0; v0i < v0List.size(); v0i++) {
+              const auto& v0 = v0List[sorted_v0[v0i]];
+              sortedV0ListIndex.emplace(trackPairKey(v0.posTrackId, v0.negTrackId), v0i);
+            }
             for (size_t casci = 0; casci < cascadeListReconstructedSize; casci++) {
-              // loop over v0List to find corresponding v0 index, but do it in sorted way
-              for (size_t v0i = 0; v0i < v0List.size(); v0i++) {
-                auto v0 = v0List[sorted_v0[v0i]];
-                if (cascadeList[casci].posTrackId == v0.posTrackId &&
-                    cascadeList[casci].negTrackId == v0.negTrackId) {
-                  cascadeList[casci].v0Id = v0i; // fix, point to correct V0 index
-                  break;
-                }
+              auto sortedV0 = sortedV0ListIndex.find(trackPairKey(cascadeList[casci].posTrackId, cascadeList[casci].negTrackId));
+              if (sortedV0 != sortedV0ListIndex.end()) {
+                cascadeList[casci].v0Id = sortedV0->second; // fix, point to correct V0 index
               }
             }
           }
@@ -1454,6 +1518,152 @@ class BuilderModule
     LOGF(debug, "V0 total %i, Cascade total %i, Tracked cascade total %i, V0s flagged used in cascades: %i", v0s.size(), cascades.size(), trackedCascadeCount, v0sUsedInCascades);
   }
 
+  //__________________________________________________
+  // runs fitChunk(helper, begin, end) over [0, nCandidates) using the worker
+  // helpers. Chunks are handed out dynamically so that expensive candidates
+  // do not stall a statically assigned range
+  template <typename TFitChunk>
+  void runFitWorkers(std::size_t nCandidates, TFitChunk&& fitChunk)
+  {
+    const std::size_t chunkSize = std::max(1, baseOpts.nCandidatesPerChunk.value);
+    const std::size_t nWorkers = std::min(workerHelpers.size(), (nCandidates + chunkSize - 1) / chunkSize);
+    std::atomic<std::size_t> nextChunk{0};
+    auto worker = [&](o2::pwglf::strangenessBuilderHelper& helper) {
+      for (std::size_t begin = nextChunk.fetch_add(chunkSize); begin < nCandidates; begin = nextChunk.fetch_add(chunkSize)) {
+        fitChunk(helper, begin, std::min(begin + chunkSize, nCandidates));
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers);
+    for (std::size_t iWorker = 1; iWorker < nWorkers; iWorker++) {
+      threads.emplace_back(worker, std::ref(workerHelpers[iWorker]));
+    }
+    if (nWorkers > 0) {
+      worker(workerHelpers[0]); // calling thread participates as well
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  //__________________________________________________
+  // fits the V0s of v0List concurrently ahead of buildV0s. Candidates requiring
+  // TPC drift corrections are left for the serial loop (mVDriftMgr is not shared)
+  template <typename TCollisions, typename TTracks>
+  void prefitV0s(TCollisions const& collisions, TTracks const& tracks)
+  {
+    v0PrefitStatus.assign(v0List.size(), -1);
+    if (baseOpts.nThreads.value <= 1) {
+      return;
+    }
+    v0Prefits.resize(v0List.size());
+    workerHelpers.assign(baseOpts.nThreads.value, straHelper); // picks up current field and selections
+
+    runFitWorkers(v0List.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t begin, std::size_t end) {
+      for (std::size_t iv0 = begin; iv0 < end; iv0++) {
+        const auto& v0 = v0List[sorted_v0[iv0]];
+        if (!v0BuilderOpts.generatePhotonCandidates.value && v0.v0Type > 1) {
+          continue;
+        }
+        if (!baseOpts.mEnabledTables[kV0CoresBase] && v0Map[iv0] == -2) {
+          continue;
+        }
+        float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+        if (v0.collisionId >= 0) {
+          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+          if (eventSelectOpts.fillOnlySelectedCollisions && !isCollisionAccepted(collision)) {
+            continue;
+          }
+          pvX = collision.posX();
+          pvY = collision.posY();
+          pvZ = collision.posZ();
+        }
+        auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
+        auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
+        if (v0BuilderOpts.moveTPCOnlyTracks) {
+          bool isPosTPCOnly = (posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF());
+          bool isNegTPCOnly = (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF());
+          if (isPosTPCOnly || isNegTPCOnly) {
+            continue;
+          }
+        }
+        auto posTrackPar = getTrackParCov(posTrack);
+        auto negTrackPar = getTrackParCov(negTrack);
+        v0PrefitStatus[iv0] = helper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates) ? 1 : 0;
+        v0Prefits[iv0] = helper.v0;
+      }
+    });
+  }
+
+  //__________________________________________________
+  // fits the cascades of cascadeList concurrently ahead of buildCascades
+  // (useKF = false) or buildKFCascades (useKF = true)
+  template <bool useKF, typename TCollisions, typename TTracks>
+  void prefitCascades(TCollisions const& collisions, TTracks const& tracks)
+  {
+    cascadePrefitStatus.assign(cascadeList.size(), -1);
+    if (baseOpts.nThreads.value <= 1) {
+      return;
+    }
+    cascadePrefits.resize(cascadeList.size());
+    workerHelpers.assign(baseOpts.nThreads.value, straHelper);
+
+    runFitWorkers(cascadeList.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t begin, std::size_t end) {
+      for (std::size_t icascade = begin; icascade < end; icascade++) {
+        const auto& cascade = cascadeList[sorted_cascade[icascade]];
+        float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+        if (cascade.collisionId >= 0) {
+          auto const& collision = collisions.rawIteratorAt(cascade.collisionId);
+          if (eventSelectOpts.fillOnlySelectedCollisions && !isCollisionAccepted(collision)) {
+            continue;
+          }
+          pvX = collision.posX();
+          pvY = collision.posY();
+          pvZ = collision.posZ();
+        }
+        auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
+        auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
+        auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
+        bool built = false;
+        if constexpr (useKF) {
+          built = helper.buildCascadeCandidateWithKF(cascade.collisionId, pvX, pvY, pvZ,
+                                                     posTrack,
+                                                     negTrack,
+                                                     bachTrack,
+                                                     baseOpts.mEnabledTables[kCascBBs],
+                                                     cascadeBuilderOpts.kfConstructMethod,
+                                                     cascadeBuilderOpts.kfTuneForOmega,
+                                                     cascadeBuilderOpts.kfUseV0MassConstraint,
+                                                     cascadeBuilderOpts.kfUseCascadeMassConstraint,
+                                                     cascadeBuilderOpts.kfDoDCAFitterPreMinimV0,
+                                                     cascadeBuilderOpts.kfDoDCAFitterPreMinimCasc);
+        } else if (baseOpts.useV0BufferForCascades) {
+          if (cascade.v0Id < 0 || v0Map[cascade.v0Id] < 0) {
+            continue; // not cached: skipped by the serial loop
+          }
+          built = helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                               v0sFromCascades[v0Map[cascade.v0Id]],
+                                               posTrack,
+                                               negTrack,
+                                               bachTrack,
+                                               baseOpts.mEnabledTables[kCascBBs],
+                                               cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                               baseOpts.mEnabledTables[kCascCovs]);
+        } else {
+          built = helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ,
+                                               posTrack,
+                                               negTrack,
+                                               bachTrack,
+                                               baseOpts.mEnabledTables[kCascBBs],
+                                               cascadeBuilderOpts.useCascadeMomentumAtPrimVtx,
+                                               baseOpts.mEnabledTables[kCascCovs]);
+        }
+        cascadePrefitStatus[icascade] = built ? 1 : 0;
+        cascadePrefits[icascade] = helper.cascade;
+      }
+    });
+  }
+
   //__________________________________________________
   template <class TBCs, typename THistoRegistry, typename TCollisions, typename TTracks, typename TV0s, typename TMCParticles, typename TProducts>
   void buildV0s(THistoRegistry& histos, TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TMCParticles const& mcParticles, TProducts& products)
@@ -1467,6 +1677,9 @@ class BuilderModule
       mcParticleIsReco.resize(mcParticles.size(), false);
     }
 
+    // multi-threaded mode: fit candidates upfront, fill tables serially below
+    prefitV0s(collisions, tracks);
+
     int nV0s = 0;
     // Loops over all V0s in the time frame
     histos.fill(HIST("hInputStatistics"), kV0CoresBase, v0s.size());
@@ -1581,7 +1794,14 @@ class BuilderModule
         }
       }
 
-      if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
+      bool v0Built = false;
+      if (v0PrefitStatus[iv0] >= 0) {
+        straHelper.v0 = v0Prefits[iv0];
+        v0Built = v0PrefitStatus[iv0] > 0;
+      } else {
+        v0Built = straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates);
+      }
+      if (!v0Built) {
         products.v0dataLink(-1, -1);
         continue;
       }
@@ -2057,6 +2277,9 @@ class BuilderModule
     if (!baseOpts.mEnabledTables[kStoredCascCores]) {
       return; // don't do if no request for cascades in place
     }
+    // multi-threaded mode: fit candidates upfront, fill tables serially below
+    prefitCascades<false>(collisions, tracks);
+
     int nCascades = 0;
     // Loops over all cascades in the time frame
     histos.fill(HIST("hInputStatistics"), kStoredCascCores, cascades.size());
@@ -2129,7 +2352,15 @@ class BuilderModule
         }
       }
 
-      if (baseOpts.useV0BufferForCascades) {
+      if (cascadePrefitStatus[icascade] >= 0) {
+        // already fitted by a worker thread
+        straHelper.cascade = cascadePrefits[icascade];
+        if (cascadePrefitStatus[icascade] == 0) {
+          products.cascdataLink(-1);
+          interlinks.cascadeToCascCores.push_back(-1);
+          continue; // didn't work out, skip
+        }
+      } else if (baseOpts.useV0BufferForCascades) {
         // this processing path uses a buffer of V0s so that no
         // additional minimization step is redone. It consumes less
         // CPU at the cost of more memory. Since memory is a more
@@ -2520,6 +2751,9 @@ class BuilderModule
     if (!baseOpts.mEnabledTables[kStoredKFCascCores]) {
       return; // don't do if no request for cascades in place
     }
+    // multi-threaded mode: fit candidates upfront, fill tables serially below
+    prefitCascades<true>(collisions, tracks);
+
     int nCascades = 0;
     // Loops over all cascades in the time frame
     histos.fill(HIST("hInputStatistics"), kStoredKFCascCores, cascades.size());
@@ -2543,17 +2777,24 @@ class BuilderModule
       auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
       auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
-      if (!straHelper.buildCascadeCandidateWithKF(cascade.collisionId, pvX, pvY, pvZ,
-                                                  posTrack,
-                                                  negTrack,
-                                                  bachTrack,
-                                                  baseOpts.mEnabledTables[kCascBBs],
-                                                  cascadeBuilderOpts.kfConstructMethod,
-                                                  cascadeBuilderOpts.kfTuneForOmega,
-                                                  cascadeBuilderOpts.kfUseV0MassConstraint,
-                                                  cascadeBuilderOpts.kfUseCascadeMassConstraint,
-                                                  cascadeBuilderOpts.kfDoDCAFitterPreMinimV0,
-                                                  cascadeBuilderOpts.kfDoDCAFitterPreMinimCasc)) {
+      bool cascadeBuilt = false;
+      if (cascadePrefitStatus[icascade] >= 0) {
+        straHelper.cascade = cascadePrefits[icascade];
+        cascadeBuilt = cascadePrefitStatus[icascade] > 0;
+      } else {
+        cascadeBuilt = straHelper.buildCascadeCandidateWithKF(cascade.collisionId, pvX, pvY, pvZ,
+                                                              posTrack,
+                                                              negTrack,
+                                                              bachTrack,
+                                                              baseOpts.mEnabledTables[kCascBBs],
+                                                              cascadeBuilderOpts.kfConstructMethod,
+                                                              cascadeBuilderOpts.kfTuneForOmega,
+                                                              cascadeBuilderOpts.kfUseV0MassConstraint,
+                                                              cascadeBuilderOpts.kfUseCascadeMassConstraint,
+                                                              cascadeBuilderOpts.kfDoDCAFitterPreMinimV0,
+                                                              cascadeBuilderOpts.kfDoDCAFitterPreMinimCasc);
+      }
+      if (!cascadeBuilt) {
         products.kfcascdataLink(-1);
         interlinks.cascadeToKFCascCores.push_back(-1);
         continue; // didn't work out, skip
@@ -0,0 +1,168 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGUD_CORE_UDBCTIMELINE_H_
+#define PWGUD_CORE_UDBCTIMELINE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace udhelpers
+{
+
+// Timeline of the BCs of a data frame with activity in a set of detector
+// selections ("columns", e.g. FT0 TVX, FV0A, ZDC). The activities are staged
+// with add() and frozen with build() into a sorted BC array with one bit per
+// column, the row index of the activity and per-column prefix counts. Lookups
+// at a given BC, closest active BC and activity within a BC window are then
+// O(log n) in the number of active BCs instead of one std::map per column.
+class BCTimeline
+{
+ public:
+  static constexpr int MaxColumns = 8;
+  static constexpr int32_t NoEntry = -1;
+
+  void clear()
+  {
+    mPending.clear();
+    mBCs.clear();
+    mMasks.clear();
+    for (int column = 0; column < MaxColumns; column++) {
+      mIndices[column].clear();
+      mPrefix[column].clear();
+      mPositions[column].clear();
+    }
+  }
+
+  // stage an activity; if a column is filled twice for the same BC, the last index is kept
+  void add(int column, uint64_t globalBC, int32_t index)
+  {
+    mPending.emplace_back(globalBC, column, index);
+  }
+
+  void build()
+  {
+    std::stable_sort(mPending.begin(), mPending.end(), [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+    mBCs.clear();
+    mMasks.clear();
+    for (const auto& [globalBC, column, index] : mPending) {
+      if (mBCs.empty() || mBCs.back() != globalBC) {
+        mBCs.push_back(globalBC);
+        mMasks.push_back(0);
+      }
+    }
+    const std::size_t nBCs = mBCs.size();
+    for (int column = 0; column < MaxColumns; column++) {
+      mIndices[column].assign(nBCs, NoEntry);
+      mPrefix[column].assign(nBCs + 1, 0);
+      mPositions[column].clear();
+    }
+    std::size_t position = 0;
+    for (const auto& [globalBC, column, index] : mPending) {
+      while (mBCs[position] != globalBC) {
+        position++;
+      }
+      mMasks[position] |= (1u << column);
+      mIndices[column][position] = index;
+    }
+    for (int column = 0; column < MaxColumns; column++) {
+      for (std::size_t i = 0; i < nBCs; i++) {
+        const bool active = mMasks[i] & (1u << column);
+        mPrefix[column][i + 1] = mPrefix[column][i] + active;
+        if (active) {
+          mPositions[column].push_back(static_cast<uint32_t>(i));
+        }
+      }
+    }
+    mPending.clear();
+  }
+
+  // number of BCs with activity in a column
+  std::size_t count(int column) const { return mPositions[column].size(); }
+
+  // row index of the activity at exactly this BC, NoEntry if none
+  int32_t index(int column, uint64_t globalBC) const
+  {
+    const auto it = std::lower_bound(mBCs.begin(), mBCs.end(), globalBC);
+    if (it == mBCs.end() || *it != globalBC) {
+      return NoEntry;
+    }
+    return mIndices[column][it - mBCs.begin()];
+  }
+
+  // closest BC with activity in a column, the later one if two are equidistant;
+  // returns false if the column is empty
+  bool closest(int column, uint64_t globalBC, uint64_t& closestBC) const
+  {
+    const auto& positions = mPositions[column];
+    if (positions.empty()) {
+      return false;
+    }
+    auto it = std::lower_bound(positions.begin(), positions.end(), globalBC, [this](uint32_t position, uint64_t bc) { return mBCs[position] < bc; });
+    if (it == positions.end()) {
+      closestBC = mBCs[positions.back()];
+      return true;
+    }
+    const uint64_t bcAfter = mBCs[*it];
+    if (it == positions.begin()) {
+      closestBC = bcAfter;
+      return true;
+    }
+    const uint64_t bcBefore = mBCs[*(it - 1)];
+    closestBC = (bcAfter - globalBC <= globalBC - bcBefore) ? bcAfter : bcBefore;
+    return true;
+  }
+
+  // number of BCs in [minBC, maxBC] with activity in a column
+  std::size_t countInRange(int column, uint64_t minBC, uint64_t maxBC) const
+  {
+    if (maxBC < minBC) {
+      return 0;
+    }
+    const std::size_t first = std::lower_bound(mBCs.begin(), mBCs.end(), minBC) - mBCs.begin();
+    const std::size_t last = std::upper_bound(mBCs.begin(), mBCs.end(), maxBC) - mBCs.begin();
+    return mPrefix[column][last] - mPrefix[column][first];
+  }
+
+  // any activity in a column within globalBC +- deltaBC
+  bool anyInWindow(int column, uint64_t globalBC, uint64_t deltaBC) const
+  {
+    const uint64_t minBC = deltaBC < globalBC ? globalBC - deltaBC : 0;
+    return countInRange(column, minBC, globalBC + deltaBC) > 0;
+  }
+
+  // call f(globalBC, index) for the BCs in [minBC, maxBC] with activity in a column, in BC order
+  template <typename F>
+  void forEachInRange(int column, uint64_t minBC, uint64_t maxBC, F&& f) const
+  {
+    const auto& positions = mPositions[column];
+    auto it = std::lower_bound(positions.begin(), positions.end(), minBC, [this](uint32_t position, uint64_t bc) { return mBCs[position] < bc; });
+    for (; it != positions.end() && mBCs[*it] <= maxBC; ++it) {
+      f(mBCs[*it], mIndices[column][*it]);
+    }
+  }
+
+ private:
+  std::vector<std::tuple<uint64_t, int, int32_t>> mPending; // staged (BC, column, index)
+  std::vector<uint64_t> mBCs;                               // sorted BCs with any activity
+  std::vector<uint8_t> mMasks;                              // one bit per column
+  std::array<std::vector<int32_t>, MaxColumns> mIndices;    // row index per column and BC
+  std::array<std::vector<uint32_t>, MaxColumns> mPrefix;    // active BCs before each position
+  std::array<std::vector<uint32_t>, MaxColumns> mPositions; // positions of the active BCs
+};
+
+} // namespace udhelpers
+
+#endif // PWGUD_CORE_UDBCTIMELINE_H_
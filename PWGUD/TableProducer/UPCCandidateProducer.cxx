@@ -14,6 +14,7 @@
 /// \author Andrea Riffero, andrea.giovanni.riffero@cern.ch
 /// \since 19.03.2026
 
+#include "PWGUD/Core/UDBCTimeline.h"
 #include "PWGUD/Core/UPCCutparHolder.h"
 #include "PWGUD/Core/UPCHelpers.h"
 #include "PWGUD/DataModel/UDTables.h"
@@ -45,6 +46,7 @@
 #include <Rtypes.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -52,6 +54,7 @@
 #include <map>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -94,6 +97,16 @@ struct UpcCandProducer {
   std::vector<bool> fwdSelectors;
   std::vector<bool> barrelSelectors;
 
+  // FIT/ZDC activity of the current data frame, one timeline column per selection
+  enum BcTimelineColumn { kBcTOR = 0,
+                          kBcTVX,
+                          kBcTSC,
+                          kBcV0A,
+                          kBcZdc,
+                          kBcT0A,
+                          kBcFDD };
+  udhelpers::BCTimeline fBcTimeline;
+
   // RCT flag checker
   RCTFlagsChecker myRCTChecker;
 
@@ -128,6 +141,9 @@ struct UpcCandProducer {
   Configurable<float> fMinEtaMFT{"minEtaMFT", -3.6, "Minimum eta for MFT tracks"};
   Configurable<float> fMaxEtaMFT{"maxEtaMFT", -2.5, "Maximum eta for MFT tracks"};
 
+  Configurable<int> fNThreads{"nThreads", 1, "Number of threads selecting candidates of different BC blocks concurrently, 1 selects them sequentially"};
+  Configurable<int> fBcBlockSize{"bcBlockSize", 2000, "Number of matched BCs per block when selecting candidates concurrently"};
+
   Configurable<bool> fRequireNoTimeFrameBorder{"requireNoTimeFrameBorder", true, "Require kNoTimeFrameBorder selection bit"};
   Configurable<bool> fRequireNoITSROFrameBorder{"requireNoITSROFrameBorder", true, "Require kNoITSROFrameBorder selection bit"};
 
@@ -152,6 +168,22 @@ struct UpcCandProducer {
 
   typedef std::pair<uint64_t, std::vector<int64_t>> BCTracksPair;
 
+  // tracks and FIT information of a forward candidate, selected before it is written out
+  struct FwdCandidate {
+    std::vector<int64_t> trkCandIDs{};
+    uint64_t closestBcMCH = 0;
+    upchelpers::FITInfo fitInfo{};
+    std::vector<float> amplitudesT0A{};
+    std::vector<float> amplitudesV0A{};
+    std::vector<int8_t> relBCsT0A{};
+    std::vector<int8_t> relBCsV0A{};
+    uint8_t chFT0A = 0;
+    uint8_t chFT0C = 0;
+    uint8_t chFV0A = 0;
+    uint8_t chFDDA = 0;
+    uint8_t chFDDC = 0;
+  };
+
   void init(InitContext&)
   {
     fwdSelectors.resize(upchelpers::kNFwdSels - 1, false);
@@ -304,19 +336,38 @@ struct UpcCandProducer {
     return true;
   }
 
-  auto findClosestBC(uint64_t globalBC, std::map<uint64_t, int32_t>& bcs)
+  auto findClosestBC(uint64_t globalBC, int column)
   {
-    auto it = bcs.lower_bound(globalBC);
-    auto bc1 = it->first;
-    if (it != bcs.begin())
-      --it;
-    auto bc2 = it->first;
-    auto dbc1 = bc1 >= globalBC ? bc1 - globalBC : globalBC - bc1;
-    auto dbc2 = bc2 >= globalBC ? bc2 - globalBC : globalBC - bc2;
-    auto bc = (dbc1 <= dbc2) ? bc1 : bc2;
+    uint64_t bc = globalBC;
+    fBcTimeline.closest(column, globalBC, bc);
     return bc;
   }
 
+  // calls f(first, last) for consecutive blocks of fBcBlockSize entries of [0, n),
+  // distributing the blocks over fNThreads threads (the calling one included)
+  template <typename F>
+  void runInBcBlocks(std::size_t n, F&& f)
+  {
+    const std::size_t blockSize = std::max(fBcBlockSize.value, 1);
+    const std::size_t nBlocks = (n + blockSize - 1) / blockSize;
+    std::atomic<std::size_t> nextBlock{0};
+    auto worker = [&]() {
+      for (std::size_t iBlock = nextBlock++; iBlock < nBlocks; iBlock = nextBlock++) {
+        f(iBlock * blockSize, std::min(n, (iBlock + 1) * blockSize));
+      }
+    };
+    const std::size_t nWorkers = std::min<std::size_t>(std::max(fNThreads.value, 1), nBlocks);
+    std::vector<std::thread> threads;
+    threads.reserve(nWorkers);
+    for (std::size_t iWorker = 1; iWorker < nWorkers; iWorker++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
   auto findClosestTrackBCiter(uint64_t globalBC, std::vector<BCTracksPair>& bcs)
   {
     auto it = std::lower_bound(bcs.begin(), bcs.end(), globalBC,
@@ -933,16 +984,14 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsITSTPC.begin(), bcsMatchedTrIdsITSTPC.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithTOR{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTVX{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTSC{};
+    fBcTimeline.clear();
     for (const auto& ft0 : ft0s) {
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
       int32_t globalIndex = ft0.globalIndex();
       if (!(std::abs(ft0.timeA()) > 2.f && std::abs(ft0.timeC()) > 2.f))
-        mapGlobalBcWithTOR[globalBC] = globalIndex;
+        fBcTimeline.add(kBcTOR, globalBC, globalIndex);
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex)) { // TVX
-        mapGlobalBcWithTVX[globalBC] = globalIndex;
+        fBcTimeline.add(kBcTVX, globalBC, globalIndex);
       }
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen)) { // TVX & TCE
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("TCE", 1);
@@ -950,19 +999,17 @@ struct UpcCandProducer {
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex) &&
           (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen) ||
            TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitSCen))) { // TVX & (TSC | TCE)
-        mapGlobalBcWithTSC[globalBC] = globalIndex;
+        fBcTimeline.add(kBcTSC, globalBC, globalIndex);
       }
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
     for (const auto& fv0a : fv0as) {
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      fBcTimeline.add(kBcV0A, globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -971,14 +1018,16 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      fBcTimeline.add(kBcZdc, globalBC, zdc.globalIndex());
     }
 
-    auto nTORs = mapGlobalBcWithTOR.size();
-    auto nTSCs = mapGlobalBcWithTSC.size();
-    auto nTVXs = mapGlobalBcWithTVX.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
-    auto nZdcs = mapGlobalBcWithZdc.size();
+    fBcTimeline.build();
+
+    auto nTORs = fBcTimeline.count(kBcTOR);
+    auto nTSCs = fBcTimeline.count(kBcTSC);
+    auto nTVXs = fBcTimeline.count(kBcTVX);
+    auto nFV0As = fBcTimeline.count(kBcV0A);
+    auto nZdcs = fBcTimeline.count(kBcZdc);
     auto nBcsWithITSTPC = bcsMatchedTrIdsITSTPC.size();
 
     // todo: calculate position of UD collision?
@@ -1002,11 +1051,11 @@ struct UpcCandProducer {
       fitInfo.distClosestBcTVX = 999;
       fitInfo.distClosestBcV0A = 999;
       if (nTORs > 0) {
-        uint64_t closestBcTOR = findClosestBC(globalBC, mapGlobalBcWithTOR);
+        uint64_t closestBcTOR = findClosestBC(globalBC, kBcTOR);
         fitInfo.distClosestBcTOR = globalBC - static_cast<int64_t>(closestBcTOR);
         if (std::abs(fitInfo.distClosestBcTOR) <= fFilterFT0)
           return false;
-        auto ft0Id = mapGlobalBcWithTOR.at(closestBcTOR);
+        auto ft0Id = fBcTimeline.index(kBcTOR, closestBcTOR);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1018,23 +1067,23 @@ struct UpcCandProducer {
           fitInfo.ampFT0C += amp;
       }
       if (nTSCs > 0) {
-        uint64_t closestBcTSC = findClosestBC(globalBC, mapGlobalBcWithTSC);
+        uint64_t closestBcTSC = findClosestBC(globalBC, kBcTSC);
         fitInfo.distClosestBcTSC = globalBC - static_cast<int64_t>(closestBcTSC);
         if (std::abs(fitInfo.distClosestBcTSC) <= fFilterTSC)
           return false;
       }
       if (nTVXs > 0) {
-        uint64_t closestBcTVX = findClosestBC(globalBC, mapGlobalBcWithTVX);
+        uint64_t closestBcTVX = findClosestBC(globalBC, kBcTVX);
         fitInfo.distClosestBcTVX = globalBC - static_cast<int64_t>(closestBcTVX);
         if (std::abs(fitInfo.distClosestBcTVX) <= fFilterTVX)
           return false;
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        uint64_t closestBcV0A = findClosestBC(globalBC, kBcV0A);
         fitInfo.distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(fitInfo.distClosestBcV0A) <= fFilterFV0)
           return false;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = fBcTimeline.index(kBcV0A, closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
@@ -1044,9 +1093,33 @@ struct UpcCandProducer {
       return true;
     };
 
+    // FIT information only depends on the BC: with several threads, it is computed
+    // for all matched BCs in concurrent blocks before the (sequential) track matching
+    const bool precomputeFitInfo = fNThreads > 1;
+    std::vector<upchelpers::FITInfo> fitInfosTOF{};
+    std::vector<upchelpers::FITInfo> fitInfosITSTPC{};
+    std::vector<uint8_t> fitSelectedTOF{};
+    std::vector<uint8_t> fitSelectedITSTPC{};
+    auto computeFitInfos = [&](const std::vector<BCTracksPair>& bcsMatchedTrIds,
+                               std::vector<upchelpers::FITInfo>& fitInfos,
+                               std::vector<uint8_t>& fitSelected) {
+      fitInfos.assign(bcsMatchedTrIds.size(), upchelpers::FITInfo{});
+      fitSelected.assign(bcsMatchedTrIds.size(), 0);
+      runInBcBlocks(bcsMatchedTrIds.size(), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+          fitSelected[i] = updateFitInfo(bcsMatchedTrIds[i].first, fitInfos[i]);
+        }
+      });
+    };
+    if (precomputeFitInfo) {
+      computeFitInfos(bcsMatchedTrIdsTOF, fitInfosTOF, fitSelectedTOF);
+      computeFitInfos(bcsMatchedTrIdsITSTPC, fitInfosITSTPC, fitSelectedITSTPC);
+    }
+
     // candidates with TOF
     int32_t candID = 0;
-    for (auto& pair : bcsMatchedTrIdsTOF) {
+    for (std::size_t iBC = 0; iBC < bcsMatchedTrIdsTOF.size(); iBC++) {
+      auto& pair = bcsMatchedTrIdsTOF[iBC];
       auto globalBC = pair.first;
       auto& barrelTrackIDs = pair.second;
       uint32_t nTOFs = barrelTrackIDs.size();
@@ -1070,12 +1143,17 @@ struct UpcCandProducer {
         itClosestBcITSTPC->second.clear(); // BC is matched to BC with TOF, removing tracks, but leaving BC
       }
       upchelpers::FITInfo fitInfo{};
-      if (!updateFitInfo(globalBC, fitInfo))
+      if (precomputeFitInfo) {
+        if (!fitSelectedTOF[iBC])
+          continue;
+        fitInfo = fitInfosTOF[iBC];
+      } else if (!updateFitInfo(globalBC, fitInfo)) {
         continue;
+      }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        auto zdcId = fBcTimeline.index(kBcZdc, globalBC);
+        if (zdcId != udhelpers::BCTimeline::NoEntry) {
+          const auto& zdc = zdcs.iteratorAt(zdcId);
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1115,7 +1193,8 @@ struct UpcCandProducer {
     }
 
     // candidates without TOF
-    for (auto& pair : bcsMatchedTrIdsITSTPC) {
+    for (std::size_t iBC = 0; iBC < bcsMatchedTrIdsITSTPC.size(); iBC++) {
+      auto& pair = bcsMatchedTrIdsITSTPC[iBC];
       auto globalBC = pair.first;
       auto& barrelTrackIDs = pair.second;
       uint32_t nThisITSTPCs = barrelTrackIDs.size();
@@ -1139,12 +1218,17 @@ struct UpcCandProducer {
         itClosestBcITSTPC->second.clear();
       }
       upchelpers::FITInfo fitInfo{};
-      if (!updateFitInfo(globalBC, fitInfo))
+      if (precomputeFitInfo) {
+        if (!fitSelectedITSTPC[iBC])
+          continue;
+        fitInfo = fitInfosITSTPC[iBC];
+      } else if (!updateFitInfo(globalBC, fitInfo)) {
         continue;
+      }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        auto zdcId = fBcTimeline.index(kBcZdc, globalBC);
+        if (zdcId != udhelpers::BCTimeline::NoEntry) {
+          const auto& zdc = zdcs.iteratorAt(zdcId);
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1370,17 +1454,15 @@ struct UpcCandProducer {
 
   template <typename T>
   void fillAmplitudes(const T& t,
-                      const std::map<uint64_t, int32_t>& mapBCs,
+                      int column,
                       std::vector<float>& amps,
                       std::vector<int8_t>& relBCs,
                       uint64_t gbc)
   {
     auto s = gbc - fBCWindowFITAmps;
     auto e = gbc + (fBCWindowFITAmps - 1);
-    auto it = mapBCs.lower_bound(s);
-    while (it->first <= e && it != mapBCs.end()) {
-      int i = it->first - s;
-      auto id = it->second;
+    fBcTimeline.forEachInRange(column, s, e, [&](uint64_t bc, int32_t id) {
+      int i = bc - s;
       const auto& row = t.iteratorAt(id);
       float totalAmp = 0.f;
       if constexpr (std::is_same_v<T, o2::aod::FT0s>) {
@@ -1395,8 +1477,7 @@ struct UpcCandProducer {
         amps.push_back(totalAmp);
         relBCs.push_back(gbc - (i + s));
       }
-      ++it;
-    }
+    });
   }
 
   template <typename TBCs>
@@ -1435,7 +1516,7 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsMCH.begin(), bcsMatchedTrIdsMCH.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
+    fBcTimeline.clear();
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
         continue;
@@ -1445,20 +1526,18 @@ struct UpcCandProducer {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithT0A[globalBC] = ft0.globalIndex();
+      fBcTimeline.add(kBcT0A, globalBC, ft0.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
     for (const auto& fv0a : fv0as) {
       if (!TESTBIT(fv0a.triggerMask(), o2::fit::Triggers::bitA))
         continue;
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      fBcTimeline.add(kBcV0A, globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -1467,10 +1546,9 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      fBcTimeline.add(kBcZdc, globalBC, zdc.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithFDD{};
     uint8_t twoLayersA = 0;
     uint8_t twoLayersC = 0;
     for (const auto& fdd : fdds) {
@@ -1485,14 +1563,16 @@ struct UpcCandProducer {
       if ((twoLayersA == 0) && (twoLayersC == 0))
         continue;
       uint64_t globalBC = fdd.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithFDD[globalBC] = fdd.globalIndex();
+      fBcTimeline.add(kBcFDD, globalBC, fdd.globalIndex());
     }
 
-    auto nFT0s = mapGlobalBcWithT0A.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
-    auto nZdcs = mapGlobalBcWithZdc.size();
+    fBcTimeline.build();
+
+    auto nFT0s = fBcTimeline.count(kBcT0A);
+    auto nFV0As = fBcTimeline.count(kBcV0A);
+    auto nZdcs = fBcTimeline.count(kBcZdc);
     auto nBcsWithMCH = bcsMatchedTrIdsMCH.size();
-    auto nFDDs = mapGlobalBcWithFDD.size();
+    auto nFDDs = fBcTimeline.count(kBcFDD);
 
     // todo: calculate position of UD collision?
     float dummyX = 0.;
@@ -1506,50 +1586,44 @@ struct UpcCandProducer {
     // storing n-prong matches
     int32_t candID = 0;
 
-    for (auto& pair : bcsMatchedTrIdsMID) { // candidates without MFT
+    // FIT information and tracks of a candidate; only reads the timeline and the BC-sorted track lists
+    auto selectFwdCandidate = [&](const BCTracksPair& pair, FwdCandidate& cand) {
       auto globalBC = static_cast<int64_t>(pair.first);
       const auto& fwdTrackIDs = pair.second; // only MID-matched tracks at the moment
       uint32_t nMIDs = fwdTrackIDs.size();
       if (nMIDs > fNFwdProngs) // too many tracks
-        continue;
-      std::vector<int64_t> trkCandIDs{};
+        return false;
+      auto& trkCandIDs = cand.trkCandIDs;
       if (nMIDs == fNFwdProngs) {
         trkCandIDs.insert(trkCandIDs.end(), fwdTrackIDs.begin(), fwdTrackIDs.end());
       }
-      uint64_t closestBcMCH = 0;
       if (nMIDs < fNFwdProngs && nBcsWithMCH > 0) { // adding MCH tracks
         auto itClosestBcMCH = findClosestTrackBCiter(globalBC, bcsMatchedTrIdsMCH);
-        closestBcMCH = itClosestBcMCH->first;
-        int64_t distClosestBcMCH = globalBC - static_cast<int64_t>(closestBcMCH);
+        cand.closestBcMCH = itClosestBcMCH->first;
+        int64_t distClosestBcMCH = globalBC - static_cast<int64_t>(cand.closestBcMCH);
         if (std::abs(distClosestBcMCH) > fBcWindowMCH)
-          continue;
+          return false;
         auto& mchTracks = itClosestBcMCH->second;
         uint32_t nMCHs = mchTracks.size();
         if ((nMCHs + nMIDs) != fNFwdProngs)
-          continue;
+          return false;
         trkCandIDs.insert(trkCandIDs.end(), fwdTrackIDs.begin(), fwdTrackIDs.end());
         trkCandIDs.insert(trkCandIDs.end(), mchTracks.begin(), mchTracks.end());
       }
-      upchelpers::FITInfo fitInfo{};
+      auto& fitInfo = cand.fitInfo;
       fitInfo.timeFT0A = -999.f;
       fitInfo.timeFT0C = -999.f;
       fitInfo.timeFV0A = -999.f;
       fitInfo.ampFT0A = 0.f;
       fitInfo.ampFT0C = 0.f;
       fitInfo.ampFV0A = 0.f;
-      std::vector<float> amplitudesT0A{};
-      std::vector<float> amplitudesV0A{};
-      std::vector<int8_t> relBCsT0A{};
-      std::vector<int8_t> relBCsV0A{};
-      uint8_t chFT0A = 0;
-      uint8_t chFT0C = 0;
       if (nFT0s > 0) {
-        uint64_t closestBcT0A = findClosestBC(globalBC, mapGlobalBcWithT0A);
+        uint64_t closestBcT0A = findClosestBC(globalBC, kBcT0A);
         int64_t distClosestBcT0A = globalBC - static_cast<int64_t>(closestBcT0A);
         if (std::abs(distClosestBcT0A) <= fFilterFT0)
-          continue;
+          return false;
         fitInfo.distClosestBcT0A = distClosestBcT0A;
-        auto ft0Id = mapGlobalBcWithT0A.at(closestBcT0A);
+        auto ft0Id = fBcTimeline.index(kBcT0A, closestBcT0A);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1557,30 +1631,27 @@ struct UpcCandProducer {
         const auto& t0AmpsC = ft0.amplitudeC();
         fitInfo.ampFT0A = std::accumulate(t0AmpsA.begin(), t0AmpsA.end(), 0.f);
         fitInfo.ampFT0C = std::accumulate(t0AmpsC.begin(), t0AmpsC.end(), 0.f);
-        chFT0A = ft0.amplitudeA().size();
-        chFT0C = ft0.amplitudeC().size();
-        fillAmplitudes(ft0s, mapGlobalBcWithT0A, amplitudesT0A, relBCsT0A, globalBC);
+        cand.chFT0A = ft0.amplitudeA().size();
+        cand.chFT0C = ft0.amplitudeC().size();
+        fillAmplitudes(ft0s, kBcT0A, cand.amplitudesT0A, cand.relBCsT0A, globalBC);
       }
-      uint8_t chFV0A = 0;
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        uint64_t closestBcV0A = findClosestBC(globalBC, kBcV0A);
         int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(distClosestBcV0A) <= fFilterFV0)
-          continue;
+          return false;
         fitInfo.distClosestBcV0A = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = fBcTimeline.index(kBcV0A, closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
         fitInfo.ampFV0A = std::accumulate(v0Amps.begin(), v0Amps.end(), 0.f);
-        chFV0A = fv0a.amplitude().size();
-        fillAmplitudes(fv0as, mapGlobalBcWithV0A, amplitudesV0A, relBCsV0A, globalBC);
+        cand.chFV0A = fv0a.amplitude().size();
+        fillAmplitudes(fv0as, kBcV0A, cand.amplitudesV0A, cand.relBCsV0A, globalBC);
       }
-      uint8_t chFDDA = 0;
-      uint8_t chFDDC = 0;
       if (nFDDs > 0) {
-        uint64_t closestBcFDD = findClosestBC(globalBC, mapGlobalBcWithFDD);
-        auto fddId = mapGlobalBcWithFDD.at(closestBcFDD);
+        uint64_t closestBcFDD = findClosestBC(globalBC, kBcFDD);
+        auto fddId = fBcTimeline.index(kBcFDD, closestBcFDD);
         auto fdd = fdds.iteratorAt(fddId);
         fitInfo.timeFDDA = fdd.timeA();
         fitInfo.timeFDDC = fdd.timeC();
@@ -1594,15 +1665,20 @@ struct UpcCandProducer {
         // get signal coincidence
         for (int i = 0; i < 4; i++) {
           if (fdd.chargeA()[i + 4] > 0 && fdd.chargeA()[i] > 0)
-            chFDDA++;
+            cand.chFDDA++;
           if (fdd.chargeC()[i + 4] > 0 && fdd.chargeC()[i] > 0)
-            chFDDC++;
+            cand.chFDDC++;
         }
       }
+      return true;
+    };
+
+    auto writeFwdCandidate = [&](int64_t globalBC, const FwdCandidate& cand) {
+      const auto& fitInfo = cand.fitInfo;
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        auto zdcId = fBcTimeline.index(kBcZdc, globalBC);
+        if (zdcId != udhelpers::BCTimeline::NoEntry) {
+          const auto& zdc = zdcs.iteratorAt(zdcId);
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1613,7 +1689,7 @@ struct UpcCandProducer {
       uint16_t numContrib = fNFwdProngs;
       int8_t netCharge = 0;
       float RgtrwTOF = 0.;
-      for (auto id : trkCandIDs) {
+      for (auto id : cand.trkCandIDs) {
         auto tr = fwdTracks.iteratorAt(id);
         netCharge += tr.sign();
         selTrackIds.push_back(id);
@@ -1623,7 +1699,7 @@ struct UpcCandProducer {
       // TODO: introduce better check on association of collision and reconstruction mode
       if (bcs.iteratorAt(0).flags() == o2::itsmft::ROFRecord::VtxUPCMode)
         upc_flag = 1;
-      fillFwdTracks(fwdTracks, trkCandIDs, candID, globalBC, closestBcMCH, mcFwdTrackLabels);
+      fillFwdTracks(fwdTracks, cand.trkCandIDs, candID, globalBC, cand.closestBcMCH, mcFwdTrackLabels);
       eventCandidates(globalBC, runNumber, dummyX, dummyY, dummyZ, upc_flag, numContrib, netCharge, RgtrwTOF);
       eventCandidatesSels(fitInfo.ampFT0A, fitInfo.ampFT0C, fitInfo.timeFT0A, fitInfo.timeFT0C, fitInfo.triggerMaskFT0,
                           fitInfo.ampFDDA, fitInfo.ampFDDC, fitInfo.timeFDDA, fitInfo.timeFDDC, fitInfo.triggerMaskFDD,
@@ -1631,15 +1707,37 @@ struct UpcCandProducer {
                           fitInfo.BBFT0Apf, fitInfo.BBFT0Cpf, fitInfo.BGFT0Apf, fitInfo.BGFT0Cpf,
                           fitInfo.BBFV0Apf, fitInfo.BGFV0Apf,
                           fitInfo.BBFDDApf, fitInfo.BBFDDCpf, fitInfo.BGFDDApf, fitInfo.BGFDDCpf);
-      eventCandidatesSelExtras(chFT0A, chFT0C, chFDDA, chFDDC, chFV0A, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+      eventCandidatesSelExtras(cand.chFT0A, cand.chFT0C, cand.chFDDA, cand.chFDDC, cand.chFV0A, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
       eventCandidatesSelsFwd(fitInfo.distClosestBcV0A,
                              fitInfo.distClosestBcT0A,
-                             amplitudesT0A,
-                             relBCsT0A,
-                             amplitudesV0A,
-                             relBCsV0A);
+                             cand.amplitudesT0A,
+                             cand.relBCsT0A,
+                             cand.amplitudesV0A,
+                             cand.relBCsV0A);
       candID++;
-      trkCandIDs.clear();
+    };
+
+    if (fNThreads > 1) {
+      // candidates without MFT: select BC blocks concurrently, write them out in BC order
+      std::vector<FwdCandidate> candidates(bcsMatchedTrIdsMID.size());
+      std::vector<uint8_t> isSelected(bcsMatchedTrIdsMID.size(), 0);
+      runInBcBlocks(bcsMatchedTrIdsMID.size(), [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+          isSelected[i] = selectFwdCandidate(bcsMatchedTrIdsMID[i], candidates[i]);
+        }
+      });
+      for (std::size_t i = 0; i < bcsMatchedTrIdsMID.size(); i++) {
+        if (isSelected[i]) {
+          writeFwdCandidate(static_cast<int64_t>(bcsMatchedTrIdsMID[i].first), candidates[i]);
+        }
+      }
+    } else {
+      for (const auto& pair : bcsMatchedTrIdsMID) { // candidates without MFT
+        FwdCandidate cand{};
+        if (!selectFwdCandidate(pair, cand))
+          continue;
+        writeFwdCandidate(static_cast<int64_t>(pair.first), cand);
+      }
     }
 
     fillFwdClusters(selTrackIds, fwdTrkClusters);
@@ -1648,9 +1746,6 @@ struct UpcCandProducer {
     ambFwdTrBCs.clear();
     bcsMatchedTrIdsMID.clear();
     bcsMatchedTrIdsMCH.clear();
-    mapGlobalBcWithT0A.clear();
-    mapGlobalBcWithV0A.clear();
-    mapGlobalBcWithFDD.clear();
   }
 
   template <typename TBCs>
@@ -1698,7 +1793,7 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsGlobal.begin(), bcsMatchedTrIdsGlobal.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
+    fBcTimeline.clear();
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
         continue;
@@ -1718,20 +1813,18 @@ struct UpcCandProducer {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithT0A[globalBC] = ft0.globalIndex();
+      fBcTimeline.add(kBcT0A, globalBC, ft0.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
     for (const auto& fv0a : fv0as) {
       if (!TESTBIT(fv0a.triggerMask(), o2::fit::Triggers::bitA))
         continue;
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      fBcTimeline.add(kBcV0A, globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -1740,10 +1833,9 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      fBcTimeline.add(kBcZdc, globalBC, zdc.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithFDD{};
     uint8_t twoLayersA = 0;
     uint8_t twoLayersC = 0;
     for (const auto& fdd : fdds) {
@@ -1758,13 +1850,15 @@ struct UpcCandProducer {
       if ((twoLayersA == 0) && (twoLayersC == 0))
         continue;
       uint64_t globalBC = fdd.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithFDD[globalBC] = fdd.globalIndex();
+      fBcTimeline.add(kBcFDD, globalBC, fdd.globalIndex());
     }
 
-    auto nFT0s = mapGlobalBcWithT0A.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
-    auto nZdcs = mapGlobalBcWithZdc.size();
-    auto nFDDs = mapGlobalBcWithFDD.size();
+    fBcTimeline.build();
+
+    auto nFT0s = fBcTimeline.count(kBcT0A);
+    auto nFV0As = fBcTimeline.count(kBcV0A);
+    auto nZdcs = fBcTimeline.count(kBcZdc);
+    auto nFDDs = fBcTimeline.count(kBcFDD);
 
     // todo: calculate position of UD collision?
     float dummyX = 0.;
@@ -1851,12 +1945,12 @@ struct UpcCandProducer {
       int zVtxFT0vPv = 0;
       int vtxITSTPC = 0;
       if (nFT0s > 0) {
-        uint64_t closestBcT0A = findClosestBC(globalBC, mapGlobalBcWithT0A);
+        uint64_t closestBcT0A = findClosestBC(globalBC, kBcT0A);
         int64_t distClosestBcT0A = globalBC - static_cast<int64_t>(closestBcT0A);
         if (std::abs(distClosestBcT0A) <= fFilterFT0)
           continue;
         fitInfo.distClosestBcT0A = distClosestBcT0A;
-        auto ft0Id = mapGlobalBcWithT0A.at(closestBcT0A);
+        auto ft0Id = fBcTimeline.index(kBcT0A, closestBcT0A);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1875,28 +1969,28 @@ struct UpcCandProducer {
         sbp = ft0.bc_as<TBCs>().selection_bit(o2::aod::evsel::kNoSameBunchPileup) ? 1 : 0;
         zVtxFT0vPv = ft0.bc_as<TBCs>().selection_bit(o2::aod::evsel::kIsGoodZvtxFT0vsPV) ? 1 : 0;
         vtxITSTPC = ft0.bc_as<TBCs>().selection_bit(o2::aod::evsel::kIsVertexITSTPC) ? 1 : 0;
-        fillAmplitudes(ft0s, mapGlobalBcWithT0A, amplitudesT0A, relBCsT0A, globalBC);
+        fillAmplitudes(ft0s, kBcT0A, amplitudesT0A, relBCsT0A, globalBC);
       }
       uint8_t chFV0A = 0;
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
+        uint64_t closestBcV0A = findClosestBC(globalBC, kBcV0A);
         int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
         if (std::abs(distClosestBcV0A) <= fFilterFV0)
           continue;
         fitInfo.distClosestBcV0A = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = fBcTimeline.index(kBcV0A, closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
         fitInfo.ampFV0A = std::accumulate(v0Amps.begin(), v0Amps.end(), 0.f);
         chFV0A = fv0a.amplitude().size();
-        fillAmplitudes(fv0as, mapGlobalBcWithV0A, amplitudesV0A, relBCsV0A, globalBC);
+        fillAmplitudes(fv0as, kBcV0A, amplitudesV0A, relBCsV0A, globalBC);
       }
       uint8_t chFDDA = 0;
       uint8_t chFDDC = 0;
       if (nFDDs > 0) {
-        uint64_t closestBcFDD = findClosestBC(globalBC, mapGlobalBcWithFDD);
-        auto fddId = mapGlobalBcWithFDD.at(closestBcFDD);
+        uint64_t closestBcFDD = findClosestBC(globalBC, kBcFDD);
+        auto fddId = fBcTimeline.index(kBcFDD, closestBcFDD);
         auto fdd = fdds.iteratorAt(fddId);
         fitInfo.timeFDDA = fdd.timeA();
         fitInfo.timeFDDC = fdd.timeC();
@@ -1916,9 +2010,9 @@ struct UpcCandProducer {
         }
       }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        auto zdcId = fBcTimeline.index(kBcZdc, globalBC);
+        if (zdcId != udhelpers::BCTimeline::NoEntry) {
+          const auto& zdc = zdcs.iteratorAt(zdcId);
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1963,9 +2057,6 @@ struct UpcCandProducer {
     bcsMatchedTrIdsMID.clear();
     bcsMatchedTrIdsMCH.clear();
     bcsMatchedTrIdsGlobal.clear();
-    mapGlobalBcWithT0A.clear();
-    mapGlobalBcWithV0A.clear();
-    mapGlobalBcWithFDD.clear();
   }
 
   // data processors
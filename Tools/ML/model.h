@@ -54,29 +54,8 @@ class OnnxModel
   template <typename T>
   T* evalModel(std::vector<Ort::Value>& input)
   {
-    LOG(debug) << "Input tensor shape: " << printShape(input[0].GetTensorTypeAndShapeInfo().GetShape());
-    // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
-
     try {
-      const Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(mInputNames.size(), nullptr);
-      std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(mOutputNames.size(), nullptr);
-      std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-      auto outputTensors = mSession->Run(runOptions, inputNamesChar.data(), input.data(), input.size(), outputNamesChar.data(), outputNamesChar.size());
-      LOG(debug) << "Number of output tensors: " << outputTensors.size();
-      if (outputTensors.size() != mOutputNames.size()) {
-        LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
-      }
-      for (std::size_t i = 0; i < outputTensors.size(); i++) {
-        LOG(debug) << "Output tensor shape: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape());
-        if ((outputTensors[i].GetTensorTypeAndShapeInfo().GetShape() != mOutputShapes[i]) && (mOutputShapes[i][0] != -1)) {
-          LOG(fatal) << "Shape of tensor " << i << " does not agree with model specification! Output: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape()) << " model: " << printShape(mOutputShapes[i]);
-        }
-      }
+      auto outputTensors = runModel(input);
       T* outputValues = outputTensors.back().GetTensorMutableData<T>();
       return outputValues;
     } catch (const Ort::Exception& exception) {
@@ -88,17 +67,26 @@ class OnnxModel
   template <typename T>
   T* evalModel(std::vector<T>& input)
   {
-    const int64_t size = input.size();
-    assert(size % mInputShapes[0][1] == 0);
-    std::vector<int64_t> inputShape{size / mInputShapes[0][1], mInputShapes[0][1]};
-    std::vector<Ort::Value> inputTensors;
-    Ort::MemoryInfo memInfo =
-      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-    inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input.data(), size, inputShape.data(), inputShape.size()));
-    LOG(debug) << "Input shape calculated from vector: " << printShape(inputShape);
+    std::vector<Ort::Value> inputTensors = createInputTensors(input);
     return evalModel<T>(inputTensors);
   }
 
+  // Evaluates a flat input and copies the last output tensor into output, which (unlike the returned pointer above) stays valid after the call
+  template <typename T>
+  bool evalModel(std::vector<T>& input, std::vector<T>& output)
+  {
+    std::vector<Ort::Value> inputTensors = createInputTensors(input);
+    try {
+      auto outputTensors = runModel(inputTensors);
+      const T* outputValues = outputTensors.back().template GetTensorData<T>();
+      output.assign(outputValues, outputValues + outputTensors.back().GetTensorTypeAndShapeInfo().GetElementCount());
+      return true;
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running model inference: " << exception.what();
+    }
+    return false;
+  }
+
   // For 2D inputs
   template <typename T>
   T* evalModel(std::vector<std::vector<T>>& input)
@@ -165,6 +153,23 @@ class OnnxModel
 
   // Internal function for printing the shape of tensors
   std::string printShape(const std::vector<int64_t>&);
+  // Internal function running the session on the input tensors, checking the number and shapes of the output tensors
+  std::vector<Ort::Value> runModel(std::vector<Ort::Value>&);
+
+  // Internal function wrapping a flat input into a tensor of the model input shape, the input must outlive the tensor
+  template <typename T>
+  std::vector<Ort::Value> createInputTensors(std::vector<T>& input)
+  {
+    const int64_t size = input.size();
+    assert(size % mInputShapes[0][1] == 0);
+    std::vector<int64_t> inputShape{size / mInputShapes[0][1], mInputShapes[0][1]};
+    std::vector<Ort::Value> inputTensors;
+    Ort::MemoryInfo memInfo =
+      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input.data(), size, inputShape.data(), inputShape.size()));
+    LOG(debug) << "Input shape calculated from vector: " << printShape(inputShape);
+    return inputTensors;
+  }
   bool checkHyperloop(const bool = true);
 };
 